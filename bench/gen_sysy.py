@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Deterministic SysY program generator for compile-throughput benchmarks.
+
+usage: gen_sysy.py <shape> <size> [seed]
+
+Every shape produces a single `int main()` that terminates and returns a
+value in [0, 255], so the output can also be run through a simulator.
+The same (shape, size, seed) always produces the same text.
+
+shapes:
+  items     long BlockItemList: size declarations/assignments in one block
+  nest      if/else and while nested size levels deep, with break/continue
+  addchain  one AddExp chain and one LOrExp chain of size terms each
+  decls     size const definitions and size variable definitions
+  scopes    size nested blocks, each shadowing the variables of its parent
+"""
+
+import random
+import sys
+
+
+def gen_items(n, rng):
+    out = ["int main() {", "  int acc = 0;"]
+    for i in range(n):
+        k = rng.randint(1, 9)
+        if i % 3 == 0:
+            out.append("  int v%d = acc + %d;" % (i, k))
+        elif i % 3 == 1:
+            out.append("  acc = v%d * %d %% 97;" % (i - 1, k))
+        else:
+            out.append("  acc = acc - %d;" % k)
+    out.append("  return acc % 256;")
+    out.append("}")
+    return out
+
+
+def gen_nest(n, rng):
+    # alternate if/else and while levels; every while runs a few iterations
+    out = ["int main() {", "  int r = 0;"]
+    closers = []
+    for d in range(n):
+        ind = "  " * (d + 1)
+        if d % 2 == 0:
+            out.append("%sif (r %% %d < %d) {" % (ind, rng.randint(2, 5), rng.randint(1, 3)))
+            out.append("%s  r = r + %d;" % (ind, rng.randint(1, 9)))
+            closers.append("%s} else {\n%s  r = r - 1;\n%s}" % (ind, ind, ind))
+        else:
+            out.append("%sint i%d = 0;" % (ind, d))
+            out.append("%swhile (i%d < 3) {" % (ind, d))
+            out.append("%s  i%d = i%d + 1;" % (ind, d, d))
+            out.append("%s  if (i%d == 2) continue;" % (ind, d))
+            out.append("%s  r = r + i%d;" % (ind, d))
+            closers.append("%s  if (r > 100000) break;\n%s}" % (ind, ind))
+    out.append("  " * (n + 1) + "r = r + 1;")
+    for c in reversed(closers):
+        out.append(c)
+    out.append("  return r % 256;")
+    out.append("}")
+    return out
+
+
+def gen_addchain(n, rng):
+    terms = []
+    for i in range(n):
+        op = "+" if i == 0 else rng.choice(["+", "-"])
+        t = "a" if rng.random() < 0.5 else str(rng.randint(0, 99))
+        terms.append(t if i == 0 else "%s %s" % (op, t))
+    conds = []
+    for i in range(n):
+        conds.append("a == %d" % (rng.randint(100, 10000)))
+    out = ["int main() {", "  int a = 3;"]
+    out.append("  int s = " + " ".join(terms) + ";")
+    out.append("  int c = " + " || ".join(conds) + ";")
+    out.append("  return ((s + c) % 256 + 256) % 256;")
+    out.append("}")
+    return out
+
+
+def gen_decls(n, rng):
+    out = ["int main() {"]
+    for i in range(n):
+        if i == 0:
+            out.append("  const int c0 = %d;" % rng.randint(0, 9))
+        else:
+            out.append("  const int c%d = c%d + %d;" % (i, i - 1, rng.randint(0, 9)))
+    for i in range(n):
+        if i == 0:
+            out.append("  int v0 = c0;")
+        else:
+            out.append("  int v%d = v%d + c%d %% 7;" % (i, i - 1, rng.randint(0, n - 1)))
+    out.append("  return v%d %% 256;" % (n - 1))
+    out.append("}")
+    return out
+
+
+def gen_scopes(n, rng):
+    out = ["int main() {", "  int x = 1;", "  int y = 0;"]
+    for d in range(n):
+        ind = "  " * (d + 1)
+        out.append("%s{" % ind)
+        out.append("%s  int x = y + %d;" % (ind, rng.randint(1, 9)))
+        out.append("%s  y = x %% 89;" % ind)
+    for d in reversed(range(n)):
+        out.append("%s}" % ("  " * (d + 1)))
+    out.append("  return (x + y) % 256;")
+    out.append("}")
+    return out
+
+
+SHAPES = {
+    "items": gen_items,
+    "nest": gen_nest,
+    "addchain": gen_addchain,
+    "decls": gen_decls,
+    "scopes": gen_scopes,
+}
+
+
+def generate(shape, size, seed=1):
+    rng = random.Random("%s/%d/%d" % (shape, size, seed))
+    return "\n".join(SHAPES[shape](size, rng)) + "\n"
+
+
+def main():
+    if len(sys.argv) not in (3, 4) or sys.argv[1] not in SHAPES:
+        sys.stderr.write(__doc__)
+        return 1
+    seed = int(sys.argv[3]) if len(sys.argv) == 4 else 1
+    sys.stdout.write(generate(sys.argv[1], int(sys.argv[2]), seed))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
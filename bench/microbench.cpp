@@ -0,0 +1,234 @@
+// Microbenchmarks of compiler internals (make microbench).
+// Every case runs one hot path in isolation on synthetic input and reports
+// ns/op and heap allocations/op (operator new calls; malloc from C code
+// is not counted).
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ast.hpp"
+#include "context.hpp"
+#include "emitter.hpp"
+#include "flatir.hpp"
+#include "visit.hpp"
+
+// allocation counting
+static std::atomic<uint64_t> alloc_count(0);
+
+void *operator new(size_t size) {
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+void operator delete[](void *p) noexcept {
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+  free(p);
+}
+
+// keep a value alive without the compiler seeing through it
+template <typename T>
+static inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// run op(n) with growing n until it takes ~min_time, report per-op numbers
+static void run_case(const char *name, const std::function<void(uint64_t)> &op) {
+  const double min_time_ns = 2e8;
+  op(1000); // warm up
+  uint64_t n = 1000;
+  for (;;) {
+    uint64_t allocs_before = alloc_count.load();
+    auto start = std::chrono::steady_clock::now();
+    op(n);
+    auto end = std::chrono::steady_clock::now();
+    uint64_t allocs = alloc_count.load() - allocs_before;
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    if (ns >= min_time_ns || n >= (1ull << 32)) {
+      printf("%-44s %12.2f ns/op %10.3f allocs/op %12llu ops\n", name, ns / n, (double)allocs / n,
+        (unsigned long long)n);
+      return;
+    }
+    n = ns < min_time_ns / 100 ? n * 100 : n * 2;
+  }
+}
+
+// SymTable::get_sym_value with symbols bound at every level of `depth` nested scopes
+static void bench_symtab(int depth) {
+  const int syms_per_scope = 8;
+  SymTable symtab;
+  std::vector<sym_name_t> syms;
+  for (int d = 0; d < depth; ++d) {
+    symtab.enter_scope();
+    for (int k = 0; k < syms_per_scope; ++k) {
+      sym_name_t sym = d * syms_per_scope + k;
+      symtab.insert(sym, d * 100 + k);
+      syms.push_back(sym);
+    }
+  }
+
+  std::string name = "symtab get_sym_value depth=" + std::to_string(depth);
+  run_case(name.c_str(), [&](uint64_t n) {
+    size_t i = 0;
+    for (uint64_t k = 0; k < n; ++k) {
+      sym_info_t info = symtab.get_sym_value(syms[i]);
+      do_not_optimize(info);
+      i = i + 1 == syms.size() ? 0 : i + 1;
+    }
+  });
+}
+
+// BaseAST::new_koopa_block / get_koopa_symbol on a fresh context per batch
+static void bench_frontend() {
+  PrimaryExpAST_num node;
+  static const char *kinds[] = { "then", "else", "end", "while_entry", "while_body", "while_end" };
+
+  run_case("BaseAST::new_koopa_block", [&](uint64_t n) {
+    CompileContext ctx;
+    BaseAST::ctx = &ctx;
+    for (uint64_t k = 0; k < n; ++k) {
+      koopa_raw_basic_block_t bb = node.new_koopa_block(kinds[k % 6]);
+      do_not_optimize(bb);
+    }
+    BaseAST::ctx = nullptr;
+  });
+
+  run_case("BaseAST::get_koopa_symbol (symbol)", [&](uint64_t n) {
+    CompileContext ctx;
+    BaseAST::ctx = &ctx;
+    ctx.last_symbol = ctx.builder.new_integer(1);
+    for (uint64_t k = 0; k < n; ++k) {
+      koopa_raw_value_t v = node.get_koopa_symbol();
+      do_not_optimize(v);
+    }
+    BaseAST::ctx = nullptr;
+  });
+
+  run_case("BaseAST::get_koopa_symbol (constant)", [&](uint64_t n) {
+    CompileContext ctx;
+    BaseAST::ctx = &ctx;
+    for (uint64_t k = 0; k < n; ++k) {
+      ctx.proc_const = std::make_pair(true, (int)k);
+      koopa_raw_value_t v = node.get_koopa_symbol();
+      do_not_optimize(v);
+    }
+    BaseAST::ctx = nullptr;
+  });
+}
+
+// synthetic function: x = 1; then `count` times: x = x op 3 (load, binary, store)
+static koopa_raw_function_t build_function(KoopaBuilder &builder, int count) {
+  static const koopa_raw_binary_op_t ops[] = { KOOPA_RBO_ADD, KOOPA_RBO_SUB, KOOPA_RBO_MUL,
+    KOOPA_RBO_LT, KOOPA_RBO_EQ, KOOPA_RBO_AND };
+  builder.new_function("@main", builder.int32_type());
+  builder.insert_block(builder.new_block("%entry"));
+  koopa_raw_value_t x = builder.new_alloc("@x");
+  builder.new_store(builder.new_integer(1), x);
+  for (int i = 0; i < count; ++i) {
+    koopa_raw_value_t v = builder.new_load(x);
+    koopa_raw_value_t r = builder.new_binary(ops[i % 6], v, builder.new_integer(3));
+    builder.new_store(r, x);
+  }
+  builder.new_return(builder.new_load(x));
+  builder.end_function();
+  koopa_raw_program_t program = builder.build();
+  return reinterpret_cast<koopa_raw_function_t>(program.funcs.buffer[0]);
+}
+
+// backend entry points with a hand-installed context, output to /dev/null
+static void bench_backend() {
+  int null_fd = open("/dev/null", O_WRONLY);
+  Emitter out(null_fd);
+
+  KoopaBuilder builder;
+  koopa_raw_function_t func = build_function(builder, 1000);
+  riscv_context_t ctx;
+  ctx.out = &out;
+  riscv_context_t *outer_ctx = set_riscv_context(&ctx);
+  LowerFunction(func, ctx.cur_func);
+  AllocateRegisters(ctx.cur_func, ctx.regs);
+  allocate_stack();
+
+  run_case("Visit(flat_inst_t) dispatch", [&](uint64_t n) {
+    const std::vector<flat_inst_t> &insts = ctx.cur_func.insts;
+    size_t i = 0;
+    for (uint64_t k = 0; k < n; ++k) {
+      Visit(insts[i]);
+      i = i + 1 == insts.size() ? 0 : i + 1;
+      if (i == 0) {
+        // instructions are buffered per function
+        ctx.code.clear();
+      }
+    }
+    ctx.code.clear();
+  });
+
+  // operands: a register-resident value and an immediate
+  flat_operand_t lhs = { FLAT_OPD_VALUE, 2 };
+  flat_operand_t rhs = { FLAT_OPD_IMM, 3 };
+  run_case("generate_bin_riscv", [&](uint64_t n) {
+    for (uint64_t k = 0; k < n; ++k) {
+      generate_bin_riscv("add", "t0", lhs, rhs);
+      if ((k & 1023) == 1023) {
+        ctx.code.clear();
+      }
+    }
+    ctx.code.clear();
+  });
+
+  run_case("AllocateRegisters (1000 statements)", [&](uint64_t n) {
+    reg_assignment_t regs;
+    for (uint64_t k = 0; k < n; ++k) {
+      AllocateRegisters(ctx.cur_func, regs);
+      do_not_optimize(regs.value_reg.data());
+    }
+  });
+
+  run_case("LowerFunction (1000 statements)", [&](uint64_t n) {
+    flat_function_t flat;
+    for (uint64_t k = 0; k < n; ++k) {
+      LowerFunction(func, flat);
+      do_not_optimize(flat.insts.data());
+    }
+  });
+
+  out.flush();
+  set_riscv_context(outer_ctx);
+  close(null_fd);
+}
+
+int main() {
+  printf("%-44s %18s %20s\n", "case", "time", "allocations");
+  for (int depth : { 1, 8, 64, 512 }) {
+    bench_symtab(depth);
+  }
+  bench_frontend();
+  bench_backend();
+  return 0;
+}
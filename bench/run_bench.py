@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Compile-throughput benchmark for the SysY compiler.
+
+Generates every shape of gen_sysy.py at a given scale, compiles each program
+in -koopa and -riscv mode several times and records
+  - end-to-end wall time of the compiler process,
+  - the per-phase spans of -ftime-trace (parse, genkoopa, backend, ...),
+  - the peak RSS of the process,
+then compares them against a stored baseline. A metric regresses when it is
+more than --threshold (relative) and more than a small absolute noise floor
+above the baseline; any regression makes the script exit with status 1.
+
+usage: run_bench.py --compiler PATH [--scale F] [--repeat N]
+                    [--baseline FILE] [--update-baseline] [--threshold T]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from gen_sysy import generate  # noqa: E402
+
+# problem size of every shape at scale 1
+SIZES = {
+    "items": 20000,
+    "nest": 200,
+    "addchain": 5000,
+    "decls": 5000,
+    "scopes": 300,
+}
+MODES = ["-koopa", "-riscv"]
+
+# absolute noise floors below which differences are never regressions
+FLOOR = {"wall_ms": 2.0, "total_ms": 1.0, "peak_rss_kb": 1024}
+
+
+def run_once(compiler, mode, src, out, trace):
+    start = time.perf_counter()
+    subprocess.run([compiler, mode, src, "-o", out, "-ftime-trace", trace], check=True)
+    wall_ms = (time.perf_counter() - start) * 1e3
+
+    with open(trace) as f:
+        events = json.load(f)["traceEvents"]
+    phases = {}
+    peak_rss_kb = 0
+    for e in events:
+        phases[e["name"]] = phases.get(e["name"], 0.0) + e["dur"] / 1e3
+        peak_rss_kb = max(peak_rss_kb, e["args"]["peak_rss_kb"])
+    return wall_ms, phases, peak_rss_kb
+
+
+def measure(compiler, scale, repeat, work_dir):
+    results = {}
+    for shape, base_size in SIZES.items():
+        size = max(1, int(base_size * scale))
+        src = os.path.join(work_dir, "%s.c" % shape)
+        with open(src, "w") as f:
+            f.write(generate(shape, size))
+
+        for mode in MODES:
+            out = os.path.join(work_dir, "%s%s.out" % (shape, mode))
+            trace = os.path.join(work_dir, "trace.json")
+            best = None
+            for _ in range(repeat):
+                wall_ms, phases, rss = run_once(compiler, mode, src, out, trace)
+                if best is None:
+                    best = {"wall_ms": wall_ms, "phases": phases, "peak_rss_kb": rss}
+                    continue
+                # minimum over repeats is the least noisy estimate
+                best["wall_ms"] = min(best["wall_ms"], wall_ms)
+                best["peak_rss_kb"] = min(best["peak_rss_kb"], rss)
+                for name, ms in phases.items():
+                    best["phases"][name] = min(best["phases"].get(name, ms), ms)
+            best["total_ms"] = best["phases"].get("total", 0.0)
+            best["size"] = size
+            results["%s/%s" % (shape, mode)] = best
+    return results
+
+
+def compare(results, baseline, threshold):
+    regressions = []
+    print("%-18s %10s %10s %12s   %s" % ("benchmark", "wall(ms)", "total(ms)", "RSS(KB)", "vs baseline"))
+    for key, r in results.items():
+        notes = []
+        base = baseline.get(key) if baseline else None
+        for metric in ("wall_ms", "total_ms", "peak_rss_kb"):
+            if not base or metric not in base:
+                continue
+            old, new = base[metric], r[metric]
+            change = (new - old) / old if old > 0 else 0.0
+            if new - old > FLOOR[metric] and change > threshold:
+                regressions.append("%s %s: %.3f -> %.3f (%+.1f%%)" % (key, metric, old, new, 100 * change))
+                notes.append("%s %+.1f%% REGRESSION" % (metric, 100 * change))
+            elif metric != "peak_rss_kb":
+                notes.append("%s %+.1f%%" % (metric, 100 * change))
+        print("%-18s %10.3f %10.3f %12d   %s" % (key, r["wall_ms"], r["total_ms"], r["peak_rss_kb"],
+                                            ", ".join(notes) if notes else "-"))
+        phases = ", ".join("%s %.3f" % (name, ms) for name, ms in sorted(r["phases"].items()) if name != "total")
+        print("%-18s   phases(ms): %s" % ("", phases))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="SysY compiler compile-throughput benchmark")
+    parser.add_argument("--compiler", required=True)
+    parser.add_argument("--scale", type=float, default=1.0)
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--baseline", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.json"))
+    parser.add_argument("--update-baseline", action="store_true")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory(prefix="sysy-bench-") as work_dir:
+        results = measure(os.path.abspath(args.compiler), args.scale, args.repeat, work_dir)
+
+    baseline = None
+    if not args.update_baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            stored = json.load(f)
+        if stored.get("scale") != args.scale:
+            print("baseline was recorded at scale %s, not comparing" % stored.get("scale"))
+        else:
+            baseline = stored["results"]
+
+    regressions = compare(results, baseline, args.threshold)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump({"scale": args.scale, "results": results}, f, indent=1, sort_keys=True)
+            f.write("\n")
+        print("baseline written to %s" % args.baseline)
+        return 0
+    if baseline is None:
+        print("no baseline to compare against (run with --update-baseline to record one)")
+        return 0
+    if regressions:
+        print("\n%d regression(s) over %.0f%%:" % (len(regressions), 100 * args.threshold))
+        for r in regressions:
+            print("  " + r)
+        return 1
+    print("\nno regressions over %.0f%%" % (100 * args.threshold))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
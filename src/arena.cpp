@@ -0,0 +1,43 @@
+#include <cstdint>
+#include <cstdlib>
+#include "arena.hpp"
+
+Arena::Arena(size_t chunk_size) : chunk_size(chunk_size) {
+    cur = nullptr;
+    end = nullptr;
+    used = 0;
+}
+
+Arena::~Arena() {
+    for (auto it = dtors.rbegin(); it != dtors.rend(); ++it) {
+        it->dtor(it->obj);
+    }
+    for (char *chunk : chunks) {
+        std::free(chunk);
+    }
+}
+
+void *
+Arena::allocate(size_t size, size_t align) {
+    uintptr_t p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t)(align - 1);
+    if (!cur || p + size > reinterpret_cast<uintptr_t>(end)) {
+        // start a new chunk (oversized requests get a chunk of their own)
+        size_t n = size + align > chunk_size ? size + align : chunk_size;
+        char *chunk = static_cast<char *>(std::malloc(n));
+        if (!chunk) {
+            throw std::bad_alloc();
+        }
+        chunks.push_back(chunk);
+        cur = chunk;
+        end = chunk + n;
+        p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t)(align - 1);
+    }
+    cur = reinterpret_cast<char *>(p + size);
+    used = used + size;
+    return reinterpret_cast<void *>(p);
+}
+
+size_t
+Arena::bytes_used() const {
+    return used;
+}
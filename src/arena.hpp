@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump-pointer arena.
+// Objects are carved out of large chunks and never freed one by one;
+// the destructor runs pending object destructors (for types that need one)
+// in reverse order and releases every chunk in one shot.
+class Arena {
+    public:
+        explicit Arena(size_t chunk_size = 64 * 1024);
+        ~Arena();
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        void *allocate(size_t size, size_t align);
+
+        // construct an object owned by the arena
+        template <typename T, typename... Args>
+        T *make(Args &&...args) {
+            void *mem = allocate(sizeof(T), alignof(T));
+            T *obj = new (mem) T(std::forward<Args>(args)...);
+            if (!std::is_trivially_destructible<T>::value) {
+                dtors.push_back({ [](void *p) { static_cast<T *>(p)->~T(); }, obj });
+            }
+            return obj;
+        }
+
+        size_t bytes_used() const;
+
+    private:
+        struct dtor_entry_t {
+            void (*dtor)(void *);
+            void *obj;
+        };
+
+        size_t chunk_size;
+        std::vector<char *> chunks;
+        char *cur;
+        char *end;
+        size_t used;
+        std::vector<dtor_entry_t> dtors;
+};
@@ -1,69 +1,183 @@
+#include <cstring>
 #include "ast.hpp"
+#include "interp.hpp"
 
 // definition of static member variables
-int BaseAST::sym_num = 0;
-std::pair<bool, int> BaseAST::proc_const(false, 0);
-std::string BaseAST::var_mode = "none";
-std::shared_ptr<SymTable> BaseAST::current_symtab = nullptr;
-// std::stringstream BaseAST::cout_bin("");
-std::vector<int> BaseAST::wentry_bn_stack = { }; // stack of all while entry name index
-std::vector<int> BaseAST::wend_bn_stack = { }; // stack of all while end name index
+thread_local CompileContext *BaseAST::ctx = nullptr;
 
 // definition of member functions
-std::string 
+koopa_raw_value_t
 BaseAST::get_koopa_symbol() {
-    std::stringstream ele; // element name (constant or symbol)
-    if (proc_const.first) {
-        ele << proc_const.second;
-        proc_const.first = false;
+    // element (constant or symbol)
+    if (ctx->proc_const.first) {
+        ctx->proc_const.first = false;
+        return ctx->builder.new_integer(ctx->proc_const.second);
     }
-    else {
-        ele << "\%" << std::max(sym_num-1, 0);
+    return ctx->last_symbol;
+}
+
+void 
+BaseAST::new_koopa_symbol(koopa_raw_value_t value) {
+    ctx->last_symbol = value;
+}
+
+// integer constant n
+static bool is_koopa_int(koopa_raw_value_t value, int32_t n) {
+    return value->kind.tag == KOOPA_RVT_INTEGER && value->kind.data.integer.value == n;
+}
+
+// a op b == !(a inverse_op b), -1 if op is not a comparison
+static int inverse_compare(koopa_raw_binary_op_t op) {
+    switch (op) {
+        case KOOPA_RBO_EQ: return KOOPA_RBO_NOT_EQ;
+        case KOOPA_RBO_NOT_EQ: return KOOPA_RBO_EQ;
+        case KOOPA_RBO_LT: return KOOPA_RBO_GE;
+        case KOOPA_RBO_GE: return KOOPA_RBO_LT;
+        case KOOPA_RBO_GT: return KOOPA_RBO_LE;
+        case KOOPA_RBO_LE: return KOOPA_RBO_GT;
+        default: return -1;
     }
+}
 
-    return ele.str();
+// result of a comparison (always 0 or 1)
+static bool is_koopa_compare(koopa_raw_value_t value) {
+    return value->kind.tag == KOOPA_RVT_BINARY && inverse_compare(value->kind.data.binary.op) >= 0;
 }
 
-void 
-BaseAST::new_koopa_symbol() {
-    std::cout << "\t\%" << sym_num;
-    sym_num = sym_num + 1;
+void
+BaseAST::new_koopa_binary(koopa_raw_binary_op_t op, koopa_raw_value_t lhs, koopa_raw_value_t rhs) {
+    KoopaBuilder &builder = ctx->builder;
+
+    // constant subtree (division by zero is left to run time)
+    int32_t value;
+    if (lhs->kind.tag == KOOPA_RVT_INTEGER && rhs->kind.tag == KOOPA_RVT_INTEGER &&
+        interp_binary(op, lhs->kind.data.integer.value, rhs->kind.data.integer.value, value)) {
+        ctx->proc_const.first = true;
+        ctx->proc_const.second = value;
+        return;
+    }
+
+    // identities and annihilators; an operand folded into the result is
+    // dropped again if it was the last instruction emitted
+    if ((op == KOOPA_RBO_EQ || op == KOOPA_RBO_NOT_EQ) && is_koopa_int(lhs, 0)) {
+        std::swap(lhs, rhs);
+    }
+    switch (op) {
+        case KOOPA_RBO_ADD:
+            if (is_koopa_int(rhs, 0) || is_koopa_int(lhs, 0)) {
+                new_koopa_symbol(is_koopa_int(rhs, 0) ? lhs : rhs);
+                return;
+            }
+            break;
+        case KOOPA_RBO_SUB:
+            if (is_koopa_int(rhs, 0)) {
+                new_koopa_symbol(lhs);
+                return;
+            }
+            // -(-x) -> x
+            if (is_koopa_int(lhs, 0) && rhs->kind.tag == KOOPA_RVT_BINARY &&
+                rhs->kind.data.binary.op == KOOPA_RBO_SUB && is_koopa_int(rhs->kind.data.binary.lhs, 0)) {
+                builder.remove_last_inst(rhs);
+                new_koopa_symbol(rhs->kind.data.binary.rhs);
+                return;
+            }
+            break;
+        case KOOPA_RBO_MUL:
+            if (is_koopa_int(rhs, 1) || is_koopa_int(lhs, 1)) {
+                new_koopa_symbol(is_koopa_int(rhs, 1) ? lhs : rhs);
+                return;
+            }
+            if (is_koopa_int(rhs, 0) || is_koopa_int(lhs, 0)) {
+                ctx->proc_const.first = true;
+                ctx->proc_const.second = 0;
+                return;
+            }
+            break;
+        case KOOPA_RBO_DIV:
+            if (is_koopa_int(rhs, 1)) {
+                new_koopa_symbol(lhs);
+                return;
+            }
+            break;
+        case KOOPA_RBO_MOD:
+            if (is_koopa_int(rhs, 1)) {
+                ctx->proc_const.first = true;
+                ctx->proc_const.second = 0;
+                return;
+            }
+            break;
+        case KOOPA_RBO_NOT_EQ:
+            // (a < b) != 0 -> a < b
+            if (is_koopa_int(rhs, 0) && is_koopa_compare(lhs)) {
+                new_koopa_symbol(lhs);
+                return;
+            }
+            break;
+        case KOOPA_RBO_EQ:
+            // (a < b) == 0 -> a >= b, so !!x -> x != 0
+            if (is_koopa_int(rhs, 0) && is_koopa_compare(lhs)) {
+                builder.remove_last_inst(lhs);
+                auto inverse = static_cast<koopa_raw_binary_op_t>(inverse_compare(lhs->kind.data.binary.op));
+                new_koopa_symbol(builder.new_binary(inverse, lhs->kind.data.binary.lhs, lhs->kind.data.binary.rhs));
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    new_koopa_symbol(builder.new_binary(op, lhs, rhs));
 }
 
-std::string
-BaseAST::new_koopa_block(std::string block_type) {
-    // block types: {%then, %else, %end, %unreachable}
-    static int then_n = 0;
-    static int else_n = 0;
-    static int end_n = 0;
-    static int unreached_n = 0;
-    static int wentry_n = 0;
-    static int wbody_n = 0;
-    static int wend_n = 0;
+koopa_raw_basic_block_t
+BaseAST::new_koopa_block(const char *block_type) {
+    // block types: {%then, %else, %end, %unreached, %while_entry, %while_body, %while_end,
+    // %land_rhs, %land_end, %lor_rhs, %lor_end}
+    // (the per-type counters live in the compile context)
+    static const char *const block_types[KOOPA_BLOCK_TYPE_NUM] = { "%then", "%else", "%end", "%unreached",
+        "%while_entry", "%while_body", "%while_end", "%land_rhs", "%land_end", "%lor_rhs", "%lor_end" };
 
-    if (block_type == "then")
-        return "\%" + block_type + std::to_string(then_n++);
-    else if (block_type == "else")
-        return "\%" + block_type + std::to_string(else_n++);
-    else if (block_type == "end")
-        return "\%" + block_type + std::to_string(end_n++);
-    else if (block_type == "unreached")
-        return "\%" + block_type + std::to_string(unreached_n++);
-    else if (block_type == "while_entry") {
-        wentry_bn_stack.push_back(wentry_n);
-        return "\%" + block_type + std::to_string(wentry_n++);
+    for (int i = 0; i < KOOPA_BLOCK_TYPE_NUM; i++) {
+        if (strcmp(block_types[i] + 1, block_type) != 0) {
+            continue;
+        }
+
+        koopa_raw_basic_block_t bb = ctx->builder.new_block(block_types[i], ctx->block_n[i]++);
+        if (i == 4) {
+            ctx->wentry_bb_stack.push_back(bb);
+        }
+        else if (i == 6) {
+            ctx->wend_bb_stack.push_back(bb);
+        }
+        return bb;
+    }
+    return ctx->builder.new_block("%wrong_block_type");
+}
+
+void
+BaseAST::GenKoopaCond(koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb) {
+    // materialize the value and branch on it (a comparison feeds br directly)
+    GenKoopa();
+    koopa_raw_value_t cond = get_koopa_symbol();
+    if (cond->kind.tag == KOOPA_RVT_INTEGER) {
+        ctx->builder.new_jump(cond->kind.data.integer.value != 0 ? true_bb : false_bb);
+    }
+    else {
+        ctx->builder.new_branch(cond, true_bb, false_bb);
     }
-    else if (block_type == "while_body")
-        return "\%" + block_type + std::to_string(wbody_n++);
-    else if (block_type == "while_end") {
-        wend_bn_stack.push_back(wend_n);
-        return "\%" + block_type + std::to_string(wend_n++);
-    }  
-    else
-        return "\%wrong_block_type";
 }
 
 void
 BaseAST::update_current_symtab(sym_name_t sym, sym_info_t info) {
-    current_symtab->symtab[sym] = info;
+    ctx->symtab.insert(sym, info);
+}
+
+void
+BaseAST::semantic_error(const std::string &msg, sym_name_t sym) {
+    // GenKoopa goes on with a placeholder, CompileSource fails afterwards
+    if (ctx->err_msg.empty()) {
+        ctx->err_msg = "error: " + msg;
+        if (sym >= 0) {
+            ctx->err_msg = ctx->err_msg + " '" + ctx->idents.name(sym) + "'";
+        }
+    }
 }
\ No newline at end of file
@@ -4,8 +4,12 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include <cassert>
-#include "symtab.hpp"
+#include "koopa.h"
+#include "arena.hpp"
+#include "context.hpp"
+#include "interp.hpp"
 
 /*
 Current EBNF:
@@ -52,6 +56,11 @@ EqExp         ::= RelExp | EqExp ("==" | "!=") RelExp;
 LAndExp       ::= EqExp | LAndExp "&&" EqExp;
 LOrExp        ::= LAndExp | LOrExp "||" LAndExp;
 ConstExp      ::= Exp;
+
+Unit productions that only forward to their child (e.g. Exp ::= LOrExp,
+BlockItem ::= Decl | Stmt) do not get their own node: the parser passes the
+child through. Lists are stored as child arrays instead of left-deep chains.
+All nodes are allocated from the Arena of the current CompileContext.
 */
 
 // Base class for all ASTs
@@ -61,6 +70,9 @@ class BaseAST {
         virtual ~BaseAST() = default;
         virtual void Dump() const = 0;
         virtual void GenKoopa() = 0;
+        // condition in control flow context: ends the current block with
+        // branches to true_bb/false_bb
+        virtual void GenKoopaCond(koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb);
         virtual int GetValue() {
             return 0;
         };
@@ -69,26 +81,22 @@ class BaseAST {
         };
 
         // member methods
-        std::string get_koopa_symbol();
-        void new_koopa_symbol();
-        std::string new_koopa_block(std::string block_type);
+        koopa_raw_value_t get_koopa_symbol();
+        void new_koopa_symbol(koopa_raw_value_t value);
+        void new_koopa_binary(koopa_raw_binary_op_t op, koopa_raw_value_t lhs, koopa_raw_value_t rhs); // folded when possible
+        koopa_raw_basic_block_t new_koopa_block(const char *block_type);
         void update_current_symtab(sym_name_t sym, sym_info_t info);
+        void semantic_error(const std::string &msg, sym_name_t sym = -1); // keeps the first one
 
-        // static memeber variables
-        static int sym_num; // next koopa symbol number
-        // static bool sym_type; // next koopa symbol name type
-        static std::pair<bool, int> proc_const; // bool: processing const or not; int: const value
-        static std::string var_mode; // "load" or "store" for different LVal koopa code
-        static std::shared_ptr<SymTable> current_symtab; // current block symbol table
-        static std::vector<int> wentry_bn_stack; // stack of all while entry name index
-        static std::vector<int> wend_bn_stack; // stack of all while end name index
+        // context of the compilation running on this thread
+        static thread_local CompileContext *ctx;
         // static std::stringstream cout_bin;
 };
 
 // CompUnit AST
 class CompUnitAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> func_def;
+        BaseAST *func_def;
 
         void Dump() const override {
             std::cout << "CompUnitAST {\n";
@@ -104,36 +112,32 @@ class CompUnitAST : public BaseAST {
 // FuncDef AST
 class FuncDefAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> func_type;
-        std::string ident;
-        std::unique_ptr<BaseAST> block;
+        BaseAST *func_type;
+        sym_name_t ident;
+        BaseAST *block;
 
         void Dump() const override {
             std::cout << "FuncDefAST {\n";
             func_type->Dump();
-            std::cout << ", " << ident << ", ";
+            std::cout << ", " << ctx->idents.name(ident) << ", ";
             block->Dump();
             std::cout << "\n}";
         }
 
         void GenKoopa() override {
-            std::cout << "fun @" << ident << "(): ";
+            ctx->builder.new_function(std::string("@") + ctx->idents.name(ident), ctx->builder.int32_type());
             func_type->GenKoopa();
 
-            // create first block symtab
-            auto sym_table = std::make_shared<SymTable>();
-            current_symtab = sym_table;
-
             // first block is entry block
-            std::cout << " {\n";
-            std::cout << "\%entry:\n";
+            ctx->builder.insert_block(ctx->builder.new_block("%entry"));
 
-            auto old_symtab = current_symtab;
+            // function body scope
+            ctx->symtab.enter_scope();
             block->GenKoopa();
-            current_symtab = old_symtab;
+            ctx->symtab.exit_scope();
 
-            std::cout << "\tret 0\n";
-            std::cout << "}";
+            ctx->builder.new_return(ctx->builder.new_integer(0));
+            ctx->builder.end_function();
         }
 };
 
@@ -148,14 +152,14 @@ class FuncTypeAST : public BaseAST {
         }
 
         void GenKoopa() override {
-            std::cout << koopa_str;
+            // return type is always i32 for now
         }
 };
 
 // Block AST
 class BlockAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> block_item_lst;
+        BaseAST *block_item_lst;
 
         void Dump() const override {
             std::cout << "BlockAST {\n";
@@ -169,50 +173,25 @@ class BlockAST : public BaseAST {
 };
 
 // BlockItemList AST
-class BlockItemListAST_emp : public BaseAST {
-    public:
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-
-        }
-};
-class BlockItemListAST_lst : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> block_item_lst;
-        std::unique_ptr<BaseAST> block_item;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            block_item_lst->GenKoopa();
-            block_item->GenKoopa();
-        }
-};
-
-// BlockItem AST
-class BlockItemAST : public BaseAST {
+class BlockItemListAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> some_block;
+        std::vector<BaseAST *> block_items;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            some_block->GenKoopa();
+            for (BaseAST *block_item : block_items) {
+                block_item->GenKoopa();
+            }
         }
 };
 
 // Stmt AST
 class MatchedStmtAST_ret : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> exp_list;
+        BaseAST *exp_list;
 
         void Dump() const override {
 
@@ -222,21 +201,16 @@ class MatchedStmtAST_ret : public BaseAST {
             exp_list->GenKoopa();
 
             // ret code
-            std::string sym_name = get_koopa_symbol();
-            std::cout << "\tret " << sym_name << "\n";
-
-            // no more code should be generated
-            // std::cout.rdbuf(cout_bin.rdbuf());
+            ctx->builder.new_return(get_koopa_symbol());
 
             // add a unreachable basic block
-            std::string unreached_bn = new_koopa_block("unreached");
-            std::cout << "\n" << unreached_bn << ":\n";
+            ctx->builder.insert_block(new_koopa_block("unreached"));
         }
 };
 class MatchedStmtAST_var : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> l_val;
-        std::unique_ptr<BaseAST> exp;
+        BaseAST *l_val;
+        BaseAST *exp;
 
         void Dump() const override {
 
@@ -245,36 +219,29 @@ class MatchedStmtAST_var : public BaseAST {
         void GenKoopa() override {
             exp->GenKoopa();
 
-            var_mode = "store";
+            ctx->var_mode = "store";
             l_val->GenKoopa();
-            var_mode = "none";
+            ctx->var_mode = "none";
         }
 };
 class MatchedStmtAST_blk : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> block;
+        BaseAST *block;
     
         void Dump() const override {
 
         }
 
         void GenKoopa() override {
-            // save old symtab
-            auto old_symtab = current_symtab;
-
-            // create empty block symtab
-            auto sym_table = std::make_shared<SymTable>();
-            sym_table->parent_symtab = old_symtab;
-
-            // entering block
-            current_symtab = sym_table;
+            // entering block scope
+            ctx->symtab.enter_scope();
             block->GenKoopa();
-            current_symtab = old_symtab;
+            ctx->symtab.exit_scope();
         }
 };
 class MatchedStmtAST_lst : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> exp_list;
+        BaseAST *exp_list;
     
         void Dump() const override {
 
@@ -282,80 +249,77 @@ class MatchedStmtAST_lst : public BaseAST {
 
         void GenKoopa() override {
             exp_list->GenKoopa();
+            // the value is unused: drop a folded constant, it would
+            // otherwise stand in for the next symbol
+            ctx->proc_const.first = false;
         }
 };
 class MatchedStmtAST_ifelse : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> exp;
-        std::unique_ptr<BaseAST> matched_stmt_if;
-        std::unique_ptr<BaseAST> matched_stmt_else;
+        BaseAST *exp;
+        BaseAST *matched_stmt_if;
+        BaseAST *matched_stmt_else;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            // calculate if exp
-            exp->GenKoopa();
-
-            // assign block names
-            std::string then_bn = new_koopa_block("then");
-            std::string else_bn = new_koopa_block("else");
-            std::string end_bn = new_koopa_block("end");
+            // create blocks
+            koopa_raw_basic_block_t then_bb = new_koopa_block("then");
+            koopa_raw_basic_block_t else_bb = new_koopa_block("else");
+            koopa_raw_basic_block_t end_bb = new_koopa_block("end");
 
-            // br
-            std::cout << "\tbr " << get_koopa_symbol();
-            std::cout << ", " << then_bn << ", " << else_bn << "\n";
+            // branch on if exp
+            exp->GenKoopaCond(then_bb, else_bb);
 
             // then block
-            std::cout << "\n" << then_bn << ":\n";
+            ctx->builder.insert_block(then_bb);
             matched_stmt_if->GenKoopa();
-            std::cout << "\tjump " << end_bn << "\n";
+            ctx->builder.new_jump(end_bb);
 
             // else block
-            std::cout << "\n" << else_bn << ":\n";
+            ctx->builder.insert_block(else_bb);
             matched_stmt_else->GenKoopa();
-            std::cout << "\tjump " << end_bn << "\n";
+            ctx->builder.new_jump(end_bb);
 
             // end block
-            std::cout << "\n" << end_bn << ":\n";
+            ctx->builder.insert_block(end_bb);
         }
 };
 class MatchedStmtAST_while : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> exp;
-        std::unique_ptr<BaseAST> matched_stmt;
+        BaseAST *exp;
+        BaseAST *matched_stmt;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            // assign block names
-            std::string wentry_bn = new_koopa_block("while_entry");
-            std::string wbody_bn = new_koopa_block("while_body");
-            std::string wend_bn = new_koopa_block("while_end");
+            // create blocks
+            koopa_raw_basic_block_t wentry_bb = new_koopa_block("while_entry");
+            koopa_raw_basic_block_t wbody_bb = new_koopa_block("while_body");
+            koopa_raw_basic_block_t wend_bb = new_koopa_block("while_end");
 
             // jump to while entry
-            std::cout << "\tjump " << wentry_bn << "\n";
+            ctx->builder.new_jump(wentry_bb);
 
             // while entry block
-            std::cout << "\n" << wentry_bn << ":\n";
-            exp->GenKoopa();
-            std::cout << "\tbr " << get_koopa_symbol();
-            std::cout << ", " << wbody_bn << ", " << wend_bn << "\n";
+            ctx->builder.insert_block(wentry_bb);
+            exp->GenKoopaCond(wbody_bb, wend_bb);
 
             // while body block
-            std::cout << "\n" << wbody_bn << ":\n";
+            ctx->builder.insert_block(wbody_bb);
             matched_stmt->GenKoopa();
-            std::cout << "\tjump " << wentry_bn << "\n";
+            ctx->builder.new_jump(wentry_bb);
 
             // end block
-            std::cout << "\n" << wend_bn << ":\n";
+            ctx->builder.insert_block(wend_bb);
 
             // pop stack info
-            wentry_bn_stack.pop_back();
-            wend_bn_stack.pop_back();
+            ctx->wentry_bb_stack.pop_back();
+            ctx->wend_bb_stack.pop_back();
         }
 };
 class MatchedStmtAST_break : public BaseAST {
@@ -366,15 +330,11 @@ class MatchedStmtAST_break : public BaseAST {
         } 
 
         void GenKoopa() override {
-            // get current while end block name
-            std::string curr_end_bn = "\%while_end" + std::to_string(wend_bn_stack.back());
-
-            // jump to current end
-            std::cout << "\tjump " << curr_end_bn << "\n";
+            // jump to current while end
+            ctx->builder.new_jump(ctx->wend_bb_stack.back());
 
             // add a unreachable basic block
-            std::string unreached_bn = new_koopa_block("unreached");
-            std::cout << "\n" << unreached_bn << ":\n";
+            ctx->builder.insert_block(new_koopa_block("unreached"));
         }
 };
 class MatchedStmtAST_continue : public BaseAST {
@@ -385,182 +345,90 @@ class MatchedStmtAST_continue : public BaseAST {
         } 
 
         void GenKoopa() override {
-            // get current while end block name
-            std::string curr_wentry_bn = "\%while_entry" + std::to_string(wentry_bn_stack.back());
-
-            // jump to current entry
-            std::cout << "\tjump " << curr_wentry_bn << "\n";
+            // jump to current while entry
+            ctx->builder.new_jump(ctx->wentry_bb_stack.back());
 
             // add a unreachable basic block
-            std::string unreached_bn = new_koopa_block("unreached");
-            std::cout << "\n" << unreached_bn << ":\n";
+            ctx->builder.insert_block(new_koopa_block("unreached"));
         }
 };
 
 class UnmatchedStmtAST_if : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> exp;
-        std::unique_ptr<BaseAST> stmt;
+        BaseAST *exp;
+        BaseAST *stmt;
 
         void Dump() const override {
         } 
 
         void GenKoopa() override {
-            // calculate if exp
-            exp->GenKoopa();
-
-            // assign block names
-            std::string then_bn = new_koopa_block("then");
-            std::string end_bn = new_koopa_block("end");
+            // create blocks
+            koopa_raw_basic_block_t then_bb = new_koopa_block("then");
+            koopa_raw_basic_block_t end_bb = new_koopa_block("end");
 
-            // br
-            std::cout << "\tbr " << get_koopa_symbol();
-            std::cout << ", " << then_bn << ", " << end_bn << "\n";
+            // branch on if exp
+            exp->GenKoopaCond(then_bb, end_bb);
 
             // then block
-            std::cout << "\n" << then_bn << ":\n";
+            ctx->builder.insert_block(then_bb);
             stmt->GenKoopa();
-            std::cout << "\tjump " << end_bn << "\n";
+            ctx->builder.new_jump(end_bb);
 
             // end block
-            std::cout << "\n" << end_bn << ":\n";
+            ctx->builder.insert_block(end_bb);
         }
 };
 class UnmatchedStmtAST_ifelse : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> exp;
-        std::unique_ptr<BaseAST> matched_stmt;
-        std::unique_ptr<BaseAST> unmatched_stmt;
+        BaseAST *exp;
+        BaseAST *matched_stmt;
+        BaseAST *unmatched_stmt;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            // calculate if exp
-            exp->GenKoopa();
-
-            // assign block names
-            std::string then_bn = new_koopa_block("then");
-            std::string else_bn = new_koopa_block("else");
-            std::string end_bn = new_koopa_block("end");
+            // create blocks
+            koopa_raw_basic_block_t then_bb = new_koopa_block("then");
+            koopa_raw_basic_block_t else_bb = new_koopa_block("else");
+            koopa_raw_basic_block_t end_bb = new_koopa_block("end");
 
-            // br
-            std::cout << "\tbr " << get_koopa_symbol();
-            std::cout << ", " << then_bn << ", " << else_bn << "\n";
+            // branch on if exp
+            exp->GenKoopaCond(then_bb, else_bb);
 
             // then block
-            std::cout << "\n" << then_bn << ":\n";
+            ctx->builder.insert_block(then_bb);
             matched_stmt->GenKoopa();
-            std::cout << "\tjump " << end_bn << "\n";
+            ctx->builder.new_jump(end_bb);
 
             // else block
-            std::cout << "\n" << else_bn << ":\n";
+            ctx->builder.insert_block(else_bb);
             unmatched_stmt->GenKoopa();
-            std::cout << "\tjump " << end_bn << "\n";
+            ctx->builder.new_jump(end_bb);
 
             // end block
-            std::cout << "\n" << end_bn << ":\n";
-        }
-};
-
-class StmtAST : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> some_stmt;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            some_stmt->GenKoopa();
-        }
-};
-
-// ConstExp AST
-class ConstExpAST : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> exp;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return exp->GetValue();
+            ctx->builder.insert_block(end_bb);
         }
 };
 
 // ExpList AST
-class ExpListAST_emp : public BaseAST {
+class ExpListAST : public BaseAST {
     public:
+        std::vector<BaseAST *> exps;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-
-        }
-};
-class ExpListAST_lst : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> exp_list;
-        std::unique_ptr<BaseAST> exp;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            exp_list->GenKoopa();
-            exp->GenKoopa();
-        }
-};
-
-// Exp AST
-class ExpAST : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> some_exp;
-
-        void Dump() const override {
-            std::cout << "ExpAST {\n";
-            some_exp->Dump();
-            std::cout << "\n}";
-        }
-
-        void GenKoopa() override {
-            some_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return some_exp->GetValue();
+            for (BaseAST *exp : exps) {
+                exp->GenKoopa();
+            }
         }
 };
 
 // PrimaryExp AST
-class PrimaryExpAST_exp : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> exp;
-
-        void Dump () const override {
-            std::cout << "PrimaryExpAST_exp {\n";
-            exp->Dump();
-            std::cout << "\n}";
-        }
-
-        void GenKoopa() override {
-            exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return exp->GetValue();
-        }
-};
 class PrimaryExpAST_num : public BaseAST {
     public:
         int number;
@@ -572,8 +440,8 @@ class PrimaryExpAST_num : public BaseAST {
         }
 
         void GenKoopa() override {
-            proc_const.first = true;
-            proc_const.second = number;
+            ctx->proc_const.first = true;
+            ctx->proc_const.second = number;
         }
 
         int GetValue() override {
@@ -582,16 +450,16 @@ class PrimaryExpAST_num : public BaseAST {
 };
 class PrimaryExpAST_val : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> l_val;
+        BaseAST *l_val;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            var_mode = "load";
+            ctx->var_mode = "load";
             l_val->GenKoopa();
-            var_mode = "none";
+            ctx->var_mode = "none";
         }
 
         int GetValue() override {
@@ -600,28 +468,10 @@ class PrimaryExpAST_val : public BaseAST {
 };
 
 // UnaryExp AST
-class UnaryExpAST_pri : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> primary_exp;
-
-        void Dump () const override {
-            std::cout << "UnaryExpAST_pri {\n";
-            primary_exp->Dump();
-            std::cout << "\n}";
-        }
-
-        void GenKoopa() override {
-            primary_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return primary_exp->GetValue();
-        }
-};
 class UnaryExpAST_uop : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> unary_op;
-        std::unique_ptr<BaseAST> unary_exp;
+        BaseAST *unary_op;
+        BaseAST *unary_exp;
 
         void Dump () const override {
             std::cout << "UnaryExpAST_uop {\n";
@@ -636,6 +486,16 @@ class UnaryExpAST_uop : public BaseAST {
             unary_op->GenKoopa();
         }
 
+        void GenKoopaCond(koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb) override {
+            // -x and +x are nonzero exactly when x is, !x swaps the targets
+            if (unary_op->GetOp() == "!") {
+                unary_exp->GenKoopaCond(false_bb, true_bb);
+            }
+            else {
+                unary_exp->GenKoopaCond(true_bb, false_bb);
+            }
+        }
+
         int GetValue() override {
             std::string op = unary_op->GetOp();
             if (op == "+") {
@@ -666,16 +526,12 @@ class UnaryOpAST : public BaseAST {
                 return;
             }
 
-            std::string sym_name = get_koopa_symbol();
-            if (op == "+") {
-            }
-            else if (op == "-") {
-                new_koopa_symbol();
-                std::cout << " = sub 0, " << sym_name << "\n";
+            koopa_raw_value_t sym = get_koopa_symbol();
+            if (op == "-") {
+                new_koopa_binary(KOOPA_RBO_SUB, ctx->builder.new_integer(0), sym);
             }
             else if (op == "!") {
-                new_koopa_symbol();
-                std::cout << " = eq " << sym_name << ", 0\n";
+                new_koopa_binary(KOOPA_RBO_EQ, sym, ctx->builder.new_integer(0));
             }
         }
 
@@ -685,26 +541,11 @@ class UnaryOpAST : public BaseAST {
 };
 
 // MulExp AST
-class MulExpAST_una : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> unary_exp;
-
-        void Dump() const override {
-        }
-
-        void GenKoopa() override {
-            unary_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return unary_exp->GetValue();
-        }
-};
 class MulExpAST_mul : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> mul_exp;
+        BaseAST *mul_exp;
         std::string op;
-        std::unique_ptr<BaseAST> unary_exp;
+        BaseAST *unary_exp;
 
         void Dump() const override {
         }
@@ -712,24 +553,21 @@ class MulExpAST_mul : public BaseAST {
         void GenKoopa() override {
             // right exp
             unary_exp->GenKoopa();
-            std::string rsym_name = get_koopa_symbol();
+            koopa_raw_value_t rsym = get_koopa_symbol();
 
             // left exp
             mul_exp->GenKoopa();
-            std::string lsym_name = get_koopa_symbol();
+            koopa_raw_value_t lsym = get_koopa_symbol();
 
             // combine two exps
             if (op == "*") {
-                new_koopa_symbol();
-                std::cout << " = mul " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_MUL, lsym, rsym);
             }
             else if (op == "/") {
-                new_koopa_symbol();
-                std::cout << " = div " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_DIV, lsym, rsym);
             }
             else if (op == "%") {
-                new_koopa_symbol();
-                std::cout << " = mod " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_MOD, lsym, rsym);
             }
         }
 
@@ -737,11 +575,15 @@ class MulExpAST_mul : public BaseAST {
             if (op == "*") {
                 return mul_exp->GetValue() * unary_exp->GetValue();
             }
-            else if (op == "/") {
-                return mul_exp->GetValue() / unary_exp->GetValue();
-            }
-            else if (op == "%") {
-                return mul_exp->GetValue() % unary_exp->GetValue();
+            else if (op == "/" || op == "%") {
+                // same semantics as at run time, division by zero is an error here
+                int32_t value;
+                if (!interp_binary(op == "/" ? KOOPA_RBO_DIV : KOOPA_RBO_MOD, mul_exp->GetValue(),
+                    unary_exp->GetValue(), value)) {
+                    semantic_error("division by zero in constant expression");
+                    return 0;
+                }
+                return value;
             }
             assert(false);
             return 0;
@@ -749,26 +591,11 @@ class MulExpAST_mul : public BaseAST {
 };
 
 // AddExp AST
-class AddExpAST_mul : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> mul_exp;
-
-        void Dump() const override {
-        }
-
-        void GenKoopa() override {
-            mul_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return mul_exp->GetValue();
-        }
-};
 class AddExpAST_add : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> add_exp;
+        BaseAST *add_exp;
         std::string op;
-        std::unique_ptr<BaseAST> mul_exp;
+        BaseAST *mul_exp;
 
         void Dump() const override {
         }
@@ -776,19 +603,17 @@ class AddExpAST_add : public BaseAST {
         void GenKoopa() override {
             // right exp
             mul_exp->GenKoopa();
-            std::string rsym_name = get_koopa_symbol();
+            koopa_raw_value_t rsym = get_koopa_symbol();
 
             // left exp
             add_exp->GenKoopa();
-            std::string lsym_name = get_koopa_symbol();
+            koopa_raw_value_t lsym = get_koopa_symbol();
 
             if (op == "+") {
-                new_koopa_symbol();
-                std::cout << " = add " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_ADD, lsym, rsym);
             }
             else if (op == "-") {
-                new_koopa_symbol();
-                std::cout << " = sub " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_SUB, lsym, rsym);
             }
         }
 
@@ -805,26 +630,11 @@ class AddExpAST_add : public BaseAST {
 };
 
 // RelExp AST
-class RelExpAST_add : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> add_exp;
-
-        void Dump() const override {
-        }
-
-        void GenKoopa() override {
-            add_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return add_exp->GetValue();
-        }
-};
 class RelExpAST_rel : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> rel_exp;
+        BaseAST *rel_exp;
         std::string op;
-        std::unique_ptr<BaseAST> add_exp;
+        BaseAST *add_exp;
 
         void Dump() const override {
         }
@@ -832,27 +642,23 @@ class RelExpAST_rel : public BaseAST {
         void GenKoopa() override {
             // right exp
             add_exp->GenKoopa();
-            std::string rsym_name = get_koopa_symbol();
+            koopa_raw_value_t rsym = get_koopa_symbol();
 
             // left exp
             rel_exp->GenKoopa();
-            std::string lsym_name = get_koopa_symbol();
+            koopa_raw_value_t lsym = get_koopa_symbol();
 
             if (op == "<") {
-                new_koopa_symbol();
-                std::cout << " = lt " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_LT, lsym, rsym);
             }
             else if (op == ">") {
-                new_koopa_symbol();
-                std::cout << " = gt " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_GT, lsym, rsym);
             }
             else if (op == "<=") {
-                new_koopa_symbol();
-                std::cout << " = le " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_LE, lsym, rsym);
             }
             else if (op == ">=") {
-                new_koopa_symbol();
-                std::cout << " = ge " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_GE, lsym, rsym);
             }
         }
 
@@ -875,26 +681,11 @@ class RelExpAST_rel : public BaseAST {
 };
 
 // EqExp AST
-class EqExpAST_rel : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> rel_exp;
-
-        void Dump() const override {
-        }
-
-        void GenKoopa() override {
-            rel_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return rel_exp->GetValue();
-        }
-};
 class EqExpAST_eq : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> eq_exp;
+        BaseAST *eq_exp;
         std::string op;
-        std::unique_ptr<BaseAST> rel_exp;
+        BaseAST *rel_exp;
 
         void Dump() const override {
         }
@@ -902,19 +693,17 @@ class EqExpAST_eq : public BaseAST {
         void GenKoopa() override {
             // right exp
             rel_exp->GenKoopa();
-            std::string rsym_name = get_koopa_symbol();
+            koopa_raw_value_t rsym = get_koopa_symbol();
 
             // left exp
             eq_exp->GenKoopa();
-            std::string lsym_name = get_koopa_symbol();
+            koopa_raw_value_t lsym = get_koopa_symbol();
 
             if (op == "==") {
-                new_koopa_symbol();
-                std::cout << " = eq " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_EQ, lsym, rsym);
             }
             else if (op == "!=") {
-                new_koopa_symbol();
-                std::cout << " = ne " << lsym_name << ", " << rsym_name << "\n";
+                new_koopa_binary(KOOPA_RBO_NOT_EQ, lsym, rsym);
             }
         }
 
@@ -931,48 +720,53 @@ class EqExpAST_eq : public BaseAST {
 };
 
 // LAndExp AST
-class LAndExpAST_eq : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> eq_exp;
-
-        void Dump() const override {
-        }
-
-        void GenKoopa() override {
-            eq_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return eq_exp->GetValue();
-        }
-};
 class LAndExpAST_and : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> land_exp;
-        std::unique_ptr<BaseAST> eq_exp;
+        BaseAST *land_exp;
+        BaseAST *eq_exp;
 
         void Dump() const override {
         }
 
         void GenKoopa() override {
-            // right exp
-            eq_exp->GenKoopa();
-            std::string rsym_name = get_koopa_symbol();
-
             // left exp
             land_exp->GenKoopa();
-            std::string lsym_name = get_koopa_symbol();
+            koopa_raw_value_t lsym = get_koopa_symbol();
+            if (lsym->kind.tag == KOOPA_RVT_INTEGER) {
+                if (lsym->kind.data.integer.value == 0) {
+                    ctx->proc_const.first = true;
+                    ctx->proc_const.second = 0;
+                    return;
+                }
+                eq_exp->GenKoopa();
+                new_koopa_binary(KOOPA_RBO_NOT_EQ, get_koopa_symbol(), ctx->builder.new_integer(0));
+                return;
+            }
 
-            new_koopa_symbol();
-            std::cout << " = ne " << lsym_name << ", 0\n";
-            lsym_name = get_koopa_symbol();
+            // result slot is 0 unless the right exp runs
+            koopa_raw_basic_block_t rhs_bb = new_koopa_block("land_rhs");
+            koopa_raw_basic_block_t end_bb = new_koopa_block("land_end");
+            koopa_raw_value_t result = ctx->builder.new_alloc(std::string("@") + (end_bb->name + 1));
+            ctx->builder.new_store(ctx->builder.new_integer(0), result);
+            ctx->builder.new_branch(lsym, rhs_bb, end_bb);
 
-            new_koopa_symbol();
-            std::cout << " = ne " << rsym_name << ", 0\n";
-            rsym_name = get_koopa_symbol();
+            // right exp
+            ctx->builder.insert_block(rhs_bb);
+            eq_exp->GenKoopa();
+            new_koopa_binary(KOOPA_RBO_NOT_EQ, get_koopa_symbol(), ctx->builder.new_integer(0));
+            ctx->builder.new_store(get_koopa_symbol(), result);
+            ctx->builder.new_jump(end_bb);
 
-            new_koopa_symbol();
-            std::cout << " = and " << lsym_name << ", " << rsym_name << "\n";
+            ctx->builder.insert_block(end_bb);
+            new_koopa_symbol(ctx->builder.new_load(result));
+        }
+
+        void GenKoopaCond(koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb) override {
+            // the right exp only runs if the left one is true
+            koopa_raw_basic_block_t rhs_bb = new_koopa_block("land_rhs");
+            land_exp->GenKoopaCond(rhs_bb, false_bb);
+            ctx->builder.insert_block(rhs_bb);
+            eq_exp->GenKoopaCond(true_bb, false_bb);
         }
 
         int GetValue() override {
@@ -981,74 +775,65 @@ class LAndExpAST_and : public BaseAST {
 };
 
 // LorExp AST
-class LOrExpAST_and : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> land_exp;
-
-        void Dump() const override {
-        }
-
-        void GenKoopa() override {
-            land_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return land_exp->GetValue();
-        }
-};
 class LOrExpAST_or : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> lor_exp;
-        std::unique_ptr<BaseAST> land_exp;
+        BaseAST *lor_exp;
+        BaseAST *land_exp;
 
         void Dump() const override {
         }
 
         void GenKoopa() override {
-            // right exp
-            land_exp->GenKoopa();
-            std::string rsym_name = get_koopa_symbol();
-
             // left exp
             lor_exp->GenKoopa();
-            std::string lsym_name = get_koopa_symbol();
+            koopa_raw_value_t lsym = get_koopa_symbol();
+            if (lsym->kind.tag == KOOPA_RVT_INTEGER) {
+                if (lsym->kind.data.integer.value != 0) {
+                    ctx->proc_const.first = true;
+                    ctx->proc_const.second = 1;
+                    return;
+                }
+                land_exp->GenKoopa();
+                new_koopa_binary(KOOPA_RBO_NOT_EQ, get_koopa_symbol(), ctx->builder.new_integer(0));
+                return;
+            }
 
-            new_koopa_symbol();
-            std::cout << " = ne " << lsym_name << ", 0\n";
-            lsym_name = get_koopa_symbol();
+            // result slot is 1 unless the right exp runs
+            koopa_raw_basic_block_t rhs_bb = new_koopa_block("lor_rhs");
+            koopa_raw_basic_block_t end_bb = new_koopa_block("lor_end");
+            koopa_raw_value_t result = ctx->builder.new_alloc(std::string("@") + (end_bb->name + 1));
+            ctx->builder.new_store(ctx->builder.new_integer(1), result);
+            ctx->builder.new_branch(lsym, end_bb, rhs_bb);
 
-            new_koopa_symbol();
-            std::cout << " = ne " << rsym_name << ", 0\n";
-            rsym_name = get_koopa_symbol();
+            // right exp
+            ctx->builder.insert_block(rhs_bb);
+            land_exp->GenKoopa();
+            new_koopa_binary(KOOPA_RBO_NOT_EQ, get_koopa_symbol(), ctx->builder.new_integer(0));
+            ctx->builder.new_store(get_koopa_symbol(), result);
+            ctx->builder.new_jump(end_bb);
 
-            new_koopa_symbol();
-            std::cout << " = or " << lsym_name << ", " << rsym_name << "\n";
+            ctx->builder.insert_block(end_bb);
+            new_koopa_symbol(ctx->builder.new_load(result));
         }
 
-        int GetValue() override {
-            return lor_exp->GetValue() || land_exp->GetValue();
+        void GenKoopaCond(koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb) override {
+            // the right exp only runs if the left one is false
+            koopa_raw_basic_block_t rhs_bb = new_koopa_block("lor_rhs");
+            lor_exp->GenKoopaCond(true_bb, rhs_bb);
+            ctx->builder.insert_block(rhs_bb);
+            land_exp->GenKoopaCond(true_bb, false_bb);
         }
-};
-
-// Decl AST
-class DeclAST : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> some_decl;
-
-        void Dump() const override {
-
-        } 
 
-        void GenKoopa() override {
-            some_decl->GenKoopa();
+        int GetValue() override {
+            return lor_exp->GetValue() || land_exp->GetValue();
         }
 };
 
 // ConstDecl AST
 class ConstDeclAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> b_type;
-        std::unique_ptr<BaseAST> const_def_list;
+        BaseAST *b_type;
+        BaseAST *const_def_list;
 
         void Dump() const override {
 
@@ -1060,22 +845,9 @@ class ConstDeclAST : public BaseAST {
 };
 
 // ConstDefList AST
-class ConstDefListAST_def : public BaseAST {
+class ConstDefListAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> const_def;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            const_def->GenKoopa();
-        }
-};
-class ConstDefListAST_lst : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> const_def_list;
-        std::unique_ptr<BaseAST> const_def;
+        std::vector<BaseAST *> const_defs;
 
         void Dump() const override {
 
@@ -1083,8 +855,9 @@ class ConstDefListAST_lst : public BaseAST {
 
         void GenKoopa() override {
             // from left to right
-            const_def_list->GenKoopa();
-            const_def->GenKoopa();
+            for (BaseAST *const_def : const_defs) {
+                const_def->GenKoopa();
+            }
         }
 };
 
@@ -1105,8 +878,8 @@ class BTypeAST : public BaseAST {
 // ConstDef AST
 class ConstDefAST : public BaseAST {
     public:
-        std::string ident;
-        std::unique_ptr<BaseAST> const_init_val;
+        sym_name_t ident;
+        BaseAST *const_init_val;
 
         void Dump() const override {
 
@@ -1119,54 +892,43 @@ class ConstDefAST : public BaseAST {
         }
 };
 
-// ConstInitVal AST
-class ConstInitValAST : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> const_exp;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            const_exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return const_exp->GetValue();
-        }
-};
-
 // LVal AST
 class LValAST : public BaseAST {
     public:
-        std::string ident;
+        sym_name_t ident;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            sym_info_t info = current_symtab->get_sym_value(ident);
-            if (var_mode == "store") {
+            if (!ctx->symtab.has_sym(ident)) {
+                // undeclared: loads read 0, stores go nowhere
+                semantic_error("undeclared identifier", ident);
+                if (ctx->var_mode == "load") {
+                    ctx->proc_const.first = true;
+                    ctx->proc_const.second = 0;
+                }
+                return;
+            }
+            sym_info_t info = ctx->symtab.get_sym_value(ident);
+            if (ctx->var_mode == "store") {
                 // generate koopa code for store to variable
                 if (info.index() == 1) { // var
-                    std::string sym_name = get_koopa_symbol();
-                    std::cout << "\tstore " << sym_name << ", " << std::get<std::string>(info) << "\n";
+                    ctx->builder.new_store(get_koopa_symbol(), std::get<koopa_raw_value_t>(info));
                 }
                 else { // store to const, wrong senmatics
-                    assert(false);
+                    semantic_error("assignment to const", ident);
                 }
             }
-            else if (var_mode == "load") {
+            else if (ctx->var_mode == "load") {
                 // generate koopa code for load to variable
                 if (info.index() == 0) { // const
-                    proc_const.first = true;
-                    proc_const.second = std::get<int>(info);
+                    ctx->proc_const.first = true;
+                    ctx->proc_const.second = std::get<int>(info);
                 }
                 else if (info.index() == 1){ // var
-                    new_koopa_symbol();
-                    std::cout << " = load " << std::get<std::string>(info) << "\n";
+                    new_koopa_symbol(ctx->builder.new_load(std::get<koopa_raw_value_t>(info)));
                 }
                 else {
                     assert(false);
@@ -1177,13 +939,17 @@ class LValAST : public BaseAST {
 
         int GetValue() override {
             // search from symbol table by ident to get value
-            sym_info_t info = current_symtab->get_sym_value(ident);
+            if (!ctx->symtab.has_sym(ident)) {
+                semantic_error("undeclared identifier", ident);
+                return 0;
+            }
+            sym_info_t info = ctx->symtab.get_sym_value(ident);
             if (info.index() == 0) {
                 int value = std::get<int>(info);
                 return value;
             }
             else {
-                assert(false);
+                semantic_error("constant expression reads variable", ident);
                 return 0;
             }
         }
@@ -1192,8 +958,8 @@ class LValAST : public BaseAST {
 // VarDecl AST
 class VarDeclAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> b_type;
-        std::unique_ptr<BaseAST> var_def_list;
+        BaseAST *b_type;
+        BaseAST *var_def_list;
 
         void Dump() const override {
 
@@ -1205,95 +971,60 @@ class VarDeclAST : public BaseAST {
 };
 
 // VarDefList AST
-class VarDefListAST_def : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> var_def;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            var_def->GenKoopa();
-        }
-};
-class VarDefListAST_lst : public BaseAST {
+class VarDefListAST : public BaseAST {
     public:
-        std::unique_ptr<BaseAST> var_def_list;
-        std::unique_ptr<BaseAST> var_def;
+        std::vector<BaseAST *> var_defs;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            var_def_list->GenKoopa();
-            var_def->GenKoopa();
+            for (BaseAST *var_def : var_defs) {
+                var_def->GenKoopa();
+            }
         }
 };
 // VarDef AST
 class VarDefAST_dec : public BaseAST {
     public:
-        std::string ident;
+        sym_name_t ident;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            // insert alloc name to symtab
-            std::string alloc_name = "@" + ident + "_" + std::to_string(current_symtab->index);
-            sym_info_t info = alloc_name;
+            // generate koopa code for alloc and insert it to symtab
+            std::string alloc_name = std::string("@") + ctx->idents.name(ident) + "_" + std::to_string(ctx->symtab.scope_index());
+            sym_info_t info = ctx->builder.new_alloc(alloc_name);
             update_current_symtab(ident, info);
-
-            // generate koopa code
-            std::cout << alloc_name << " = alloc i32\n";
         }
 };
 class VarDefAST_def : public BaseAST {
     public:
-        std::string ident;
-        std::unique_ptr<BaseAST> init_val;
+        sym_name_t ident;
+        BaseAST *init_val;
 
         void Dump() const override {
 
         } 
 
         void GenKoopa() override {
-            // insert alloc name to symtab
-            std::string alloc_name = "@" + ident + "_" + std::to_string(current_symtab->index);
-            sym_info_t info = alloc_name;
+            // generate koopa code for alloc and insert it to symtab
+            std::string alloc_name = std::string("@") + ctx->idents.name(ident) + "_" + std::to_string(ctx->symtab.scope_index());
+            koopa_raw_value_t alloc = ctx->builder.new_alloc(alloc_name);
+            sym_info_t info = alloc;
             update_current_symtab(ident, info);
 
-            // generate koopa code for alloc
-            std::cout << "\t" << alloc_name << " = alloc i32\n";
-
             // generate koopa code for init_val calculation
             init_val->GenKoopa();
 
             // store result
-            std::cout << "\tstore " << get_koopa_symbol() << ", " << alloc_name << "\n";
-            proc_const.first = false;
+            ctx->builder.new_store(get_koopa_symbol(), alloc);
+            ctx->proc_const.first = false;
         }
 };
-// InitVal AST
-class InitValAST : public BaseAST {
-    public:
-        std::unique_ptr<BaseAST> exp;
-
-        void Dump() const override {
-
-        } 
-
-        void GenKoopa() override {
-            exp->GenKoopa();
-        }
-
-        int GetValue() override {
-            return exp->GetValue();
-        }
-};
-
 // Number is not an AST type in this implementation
 // class NumberAST : public BaseAST {
 //     public:
@@ -0,0 +1,133 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <link.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cache.hpp"
+#include "driver.hpp"
+#include "sha256.hpp"
+
+// version of the entry format, bump when the layout changes
+#define CACHE_FORMAT "sysy-cache 1 "
+
+CompileCache::CompileCache(const std::string &dir) : dir(dir) {
+    mkdir(dir.c_str(), 0755);
+}
+
+std::string
+CompileCache::key(const char *mode, const std::string &opt_flags, const std::string &source) const {
+    // fields are separated by '\0' so they cannot run into each other
+    Sha256 h;
+    h.update(compiler_build_id().c_str(), compiler_build_id().size() + 1);
+    h.update(mode, strlen(mode) + 1);
+    h.update(opt_flags.c_str(), opt_flags.size() + 1);
+    h.update(source);
+    return h.hex_digest();
+}
+
+bool
+CompileCache::lookup(const std::string &key, std::string &output) const {
+    std::string entry;
+    if (!read_file(entry_path(key).c_str(), entry)) {
+        return false;
+    }
+
+    // header: CACHE_FORMAT <output length>\n
+    size_t prefix = strlen(CACHE_FORMAT);
+    size_t eol = entry.find('\n');
+    if (eol == std::string::npos || entry.compare(0, prefix, CACHE_FORMAT) != 0) {
+        return false;
+    }
+    unsigned long long len = strtoull(entry.c_str() + prefix, nullptr, 10);
+    if (len != entry.size() - eol - 1) {
+        return false;
+    }
+    output.assign(entry, eol + 1, std::string::npos);
+    return true;
+}
+
+bool
+CompileCache::store(const std::string &key, const char *data, size_t len) const {
+    static std::atomic<unsigned> tmp_num(0);
+
+    std::string sub_dir = entry_dir(key);
+    if (mkdir(sub_dir.c_str(), 0755) < 0 && errno != EEXIST) {
+        return false;
+    }
+
+    // private temp file in the same directory (rename is atomic there)
+    std::string tmp_path = sub_dir + "/.tmp-" + std::to_string(getpid()) + "-" + std::to_string(tmp_num++);
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    std::string header = CACHE_FORMAT + std::to_string(len) + "\n";
+    bool ok = write_full(fd, header.data(), header.size()) && write_full(fd, data, len);
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), entry_path(key).c_str()) < 0) {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string
+CompileCache::entry_dir(const std::string &key) const {
+    return dir + "/" + key.substr(0, 2);
+}
+
+std::string
+CompileCache::entry_path(const std::string &key) const {
+    return entry_dir(key) + "/" + key.substr(2);
+}
+
+// GNU build-id note of the main executable, empty if it has none
+static int find_build_id(struct dl_phdr_info *info, size_t size, void *data) {
+    std::string &id = *static_cast<std::string *>(data);
+    for (int i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+        if (phdr.p_type != PT_NOTE) {
+            continue;
+        }
+        const char *p = reinterpret_cast<const char *>(info->dlpi_addr + phdr.p_vaddr);
+        const char *end = p + phdr.p_memsz;
+        while (p + sizeof(ElfW(Nhdr)) <= end) {
+            const ElfW(Nhdr) *note = reinterpret_cast<const ElfW(Nhdr) *>(p);
+            const char *name = p + sizeof(ElfW(Nhdr));
+            const char *desc = name + ((note->n_namesz + 3) & ~3u);
+            if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && memcmp(name, "GNU", 4) == 0) {
+                static const char digits[] = "0123456789abcdef";
+                for (unsigned j = 0; j < note->n_descsz; j++) {
+                    unsigned char b = desc[j];
+                    id.push_back(digits[b >> 4]);
+                    id.push_back(digits[b & 0xf]);
+                }
+                return 1;
+            }
+            p = desc + ((note->n_descsz + 3) & ~3u);
+        }
+    }
+    // only the first object (the executable itself) is inspected
+    return 1;
+}
+
+const std::string &
+compiler_build_id() {
+    static const std::string id = [] {
+        std::string id;
+        dl_iterate_phdr(find_build_id, &id);
+        if (!id.empty()) {
+            return "build-id:" + id;
+        }
+        struct stat st;
+        if (stat("/proc/self/exe", &st) == 0) {
+            return "exe:" + std::to_string(st.st_size) + ":" + std::to_string(st.st_mtim.tv_sec) +
+                "." + std::to_string(st.st_mtim.tv_nsec);
+        }
+        return std::string("unknown");
+    }();
+    return id;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Content-addressed on-disk cache of compiler outputs.
+// The key is the SHA-256 of the compiler build ID, the mode, the optimization
+// flags and the source bytes; an entry lives at <dir>/<key[0:2]>/<key[2:]>.
+// Entries are written to a private temp file and renamed into place, so
+// readers in other processes see either no entry or a complete one, and
+// concurrent writers of the same key simply replace each other's identical
+// output. Only successful compilations are stored.
+class CompileCache {
+    public:
+        explicit CompileCache(const std::string &dir);
+
+        std::string key(const char *mode, const std::string &opt_flags, const std::string &source) const;
+        bool lookup(const std::string &key, std::string &output) const;
+        bool store(const std::string &key, const char *data, size_t len) const;
+
+    private:
+        std::string entry_dir(const std::string &key) const;
+        std::string entry_path(const std::string &key) const;
+
+        std::string dir;
+};
+
+// identifies the running compiler binary (GNU build-id note if present,
+// otherwise size and mtime of the executable)
+const std::string &compiler_build_id();
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cassert>
+#include "cfg.hpp"
+
+// blocks, edges and reverse postorder of func
+void BuildCFG(const koopa_raw_function_t &func, koopa_cfg_t &cfg) {
+  size_t bb_num = func->bbs.len;
+  cfg.bbs.clear();
+  cfg.bb_id.clear();
+  for (size_t i = 0; i < bb_num; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]);
+    cfg.bbs.push_back(bb);
+    cfg.bb_id[bb] = i;
+  }
+
+  // edges from the terminators
+  cfg.succs.assign(bb_num, std::vector<int>());
+  cfg.preds.assign(bb_num, std::vector<int>());
+  auto add_edge = [&](int from, koopa_raw_basic_block_t to) {
+    int to_id = cfg.bb_id.at(to);
+    if (std::find(cfg.succs[from].begin(), cfg.succs[from].end(), to_id) == cfg.succs[from].end()) {
+      cfg.succs[from].push_back(to_id);
+      cfg.preds[to_id].push_back(from);
+    }
+  };
+  for (size_t i = 0; i < bb_num; ++i) {
+    koopa_raw_value_t term = block_terminator(cfg.bbs[i]);
+    if (!term) {
+      continue;
+    }
+    if (term->kind.tag == KOOPA_RVT_BRANCH) {
+      add_edge(i, term->kind.data.branch.true_bb);
+      add_edge(i, term->kind.data.branch.false_bb);
+    }
+    else if (term->kind.tag == KOOPA_RVT_JUMP) {
+      add_edge(i, term->kind.data.jump.target);
+    }
+  }
+
+  // postorder by an explicit DFS stack of (block, next successor)
+  cfg.rpo.clear();
+  cfg.rpo_index.assign(bb_num, -1);
+  if (bb_num == 0) {
+    return;
+  }
+  std::vector<bool> visited(bb_num, false);
+  std::vector<std::pair<int, size_t>> stack;
+  stack.emplace_back(0, 0);
+  visited[0] = true;
+  while (!stack.empty()) {
+    auto &top = stack.back();
+    if (top.second < cfg.succs[top.first].size()) {
+      int succ = cfg.succs[top.first][top.second++];
+      if (!visited[succ]) {
+        visited[succ] = true;
+        stack.emplace_back(succ, 0);
+      }
+    }
+    else {
+      cfg.rpo.push_back(top.first);
+      stack.pop_back();
+    }
+  }
+  std::reverse(cfg.rpo.begin(), cfg.rpo.end());
+  for (size_t i = 0; i < cfg.rpo.size(); ++i) {
+    cfg.rpo_index[cfg.rpo[i]] = i;
+  }
+}
+
+// dominator tree (iterative algorithm of Cooper, Harvey and Kennedy)
+void ComputeDominators(koopa_cfg_t &cfg) {
+  size_t bb_num = cfg.bbs.size();
+  cfg.idom.assign(bb_num, -1);
+  cfg.dom_children.assign(bb_num, std::vector<int>());
+  if (cfg.rpo.empty()) {
+    return;
+  }
+
+  // walk up both fingers until they meet (rpo index decreases towards the entry)
+  auto intersect = [&](int a, int b) {
+    while (a != b) {
+      while (cfg.rpo_index[a] > cfg.rpo_index[b]) {
+        a = cfg.idom[a];
+      }
+      while (cfg.rpo_index[b] > cfg.rpo_index[a]) {
+        b = cfg.idom[b];
+      }
+    }
+    return a;
+  };
+
+  int entry = cfg.rpo[0];
+  cfg.idom[entry] = entry;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 1; i < cfg.rpo.size(); ++i) {
+      int b = cfg.rpo[i];
+      int new_idom = -1;
+      for (int p : cfg.preds[b]) {
+        if (cfg.idom[p] < 0) {
+          continue; // unreachable or not processed yet
+        }
+        new_idom = new_idom < 0 ? p : intersect(p, new_idom);
+      }
+      if (new_idom != cfg.idom[b]) {
+        cfg.idom[b] = new_idom;
+        changed = true;
+      }
+    }
+  }
+  cfg.idom[entry] = -1;
+
+  for (int b : cfg.rpo) {
+    if (cfg.idom[b] >= 0) {
+      cfg.dom_children[cfg.idom[b]].push_back(b);
+    }
+  }
+}
+
+// dominance frontier of every block, needs the dominator tree
+void ComputeDominanceFrontiers(const koopa_cfg_t &cfg, std::vector<std::vector<int>> &df) {
+  df.assign(cfg.bbs.size(), std::vector<int>());
+  for (int b : cfg.rpo) {
+    if (cfg.preds[b].size() < 2) {
+      continue;
+    }
+    for (int p : cfg.preds[b]) {
+      if (cfg.rpo_index[p] < 0) {
+        continue;
+      }
+      // every block from p up to (not including) idom(b) has b in its frontier
+      for (int runner = p; runner >= 0 && runner != cfg.idom[b]; runner = cfg.idom[runner]) {
+        if (df[runner].empty() || df[runner].back() != b) {
+          df[runner].push_back(b);
+        }
+      }
+    }
+  }
+}
+
+// helper functions
+// last instruction of bb, null for an empty block
+koopa_raw_value_t block_terminator(const koopa_raw_basic_block_t &bb) {
+  if (bb->insts.len == 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[bb->insts.len - 1]);
+}
+
+// a dominates b (both reachable)
+bool dominates(const koopa_cfg_t &cfg, int a, int b) {
+  assert(cfg.rpo_index[a] >= 0 && cfg.rpo_index[b] >= 0);
+  while (b >= 0 && b != a) {
+    b = cfg.idom[b];
+  }
+  return b == a;
+}
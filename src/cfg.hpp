@@ -0,0 +1,34 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "koopa.h"
+
+// Control flow graph of a koopa raw function, used by the optimization passes.
+// Blocks are numbered in func->bbs order (block 0 is the entry). Dominators
+// are only computed for the blocks reachable from the entry.
+struct koopa_cfg_t {
+  std::vector<koopa_raw_basic_block_t> bbs;
+  std::unordered_map<koopa_raw_basic_block_t, int> bb_id;
+  std::vector<std::vector<int>> succs; // without duplicates
+  std::vector<std::vector<int>> preds; // without duplicates
+  std::vector<int> rpo;                // reachable blocks in reverse postorder
+  std::vector<int> rpo_index;          // block id -> position in rpo, -1 if unreachable
+
+  // filled by ComputeDominators
+  std::vector<int> idom;               // immediate dominator, -1 for the entry and unreachable blocks
+  std::vector<std::vector<int>> dom_children;
+};
+
+// blocks, edges and reverse postorder of func
+void BuildCFG(const koopa_raw_function_t &func, koopa_cfg_t &cfg);
+
+// dominator tree (iterative algorithm of Cooper, Harvey and Kennedy)
+void ComputeDominators(koopa_cfg_t &cfg);
+
+// dominance frontier of every block, needs the dominator tree
+void ComputeDominanceFrontiers(const koopa_cfg_t &cfg, std::vector<std::vector<int>> &df);
+
+// helper functions
+koopa_raw_value_t block_terminator(const koopa_raw_basic_block_t &bb);
+bool dominates(const koopa_cfg_t &cfg, int a, int b);
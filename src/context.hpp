@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "koopa.h"
+#include "arena.hpp"
+#include "intern.hpp"
+#include "irbuilder.hpp"
+#include "symtab.hpp"
+
+// number of named block types handed out by BaseAST::new_koopa_block
+#define KOOPA_BLOCK_TYPE_NUM 11
+
+// All frontend state of one compilation.
+// Nothing in here is shared between compilations, so any number of contexts
+// can be alive at once (one per thread in batch mode).
+struct CompileContext {
+    StringInterner idents; // interned identifiers (filled by the lexer)
+    Arena ast_arena; // owns all AST nodes
+    KoopaBuilder builder; // in-memory koopa IR builder
+    SymTable symtab; // scoped symbol table
+
+    // GenKoopa state
+    koopa_raw_value_t last_symbol = nullptr; // latest koopa symbol
+    std::pair<bool, int> proc_const{false, 0}; // bool: processing const or not; int: const value
+    std::string var_mode = "none"; // "load" or "store" for different LVal koopa code
+    std::vector<koopa_raw_basic_block_t> wentry_bb_stack; // stack of all while entry blocks
+    std::vector<koopa_raw_basic_block_t> wend_bb_stack; // stack of all while end blocks
+    int block_n[KOOPA_BLOCK_TYPE_NUM] = { 0 }; // next index of each named block type
+    std::string err_msg; // first semantic error, empty if none
+};
@@ -0,0 +1,337 @@
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ast.hpp"
+#include "rvsim.hpp"
+#include "context.hpp"
+#include "driver.hpp"
+#include "interp.hpp"
+#include "irdump.hpp"
+#include "opt.hpp"
+#include "stats.hpp"
+#include "threadpool.hpp"
+#include "timer.hpp"
+#include "visit.hpp"
+
+// reentrant lexer and pure parser (see sysy.l / sysy.y)
+// sysy.tab.hpp is not included for the same reason as in main.cpp
+typedef void *yyscan_t;
+extern int yylex_init_extra(StringInterner *extra, yyscan_t *scanner);
+extern struct yy_buffer_state *yy_scan_bytes(const char *bytes, int len, yyscan_t scanner);
+extern int yylex_destroy(yyscan_t scanner);
+extern int yyparse(yyscan_t scanner, BaseAST *&ast, Arena &arena, std::string &err_msg);
+
+bool CompileSource(const char *mode, const std::string &source, const std::string &opt_flags,
+  Emitter &out, std::string &err_msg) {
+  CompileContext ctx;
+  CompileContext *outer_ctx = BaseAST::ctx;
+  BaseAST::ctx = &ctx;
+
+  // source -> lexer -> parser -> AST (all nodes live in ctx.ast_arena)
+  BaseAST *ast = nullptr;
+  int ret_parser;
+  {
+    TimeScope scope("parse");
+    yyscan_t scanner;
+    yylex_init_extra(&ctx.idents, &scanner);
+    yy_scan_bytes(source.data(), source.size(), scanner);
+    ret_parser = yyparse(scanner, ast, ctx.ast_arena, err_msg);
+    yylex_destroy(scanner);
+  }
+  if (ret_parser != 0 || !ast) {
+    if (err_msg.empty()) {
+      err_msg = "error: parse failed";
+    }
+    BaseAST::ctx = outer_ctx;
+    return false;
+  }
+
+  // (debug) AST -> EBNF str
+  // ast->Dump();
+
+  // AST -> Koopa IR program (built in memory, no IR text round trip)
+  {
+    TimeScope scope("genkoopa");
+    ast->GenKoopa();
+  }
+  if (!ctx.err_msg.empty()) {
+    err_msg = ctx.err_msg;
+    BaseAST::ctx = outer_ctx;
+    return false;
+  }
+  koopa_raw_program_t raw;
+  {
+    TimeScope scope("build");
+    raw = ctx.builder.build();
+  }
+
+  // Koopa IR program -> optimized Koopa IR program (in place)
+  {
+    TimeScope scope("opt");
+    RunPasses(opt_flags, ctx.builder, raw);
+  }
+
+  if (strcmp(mode, "-koopa") == 0) {
+    // -koopa mode: Koopa IR program -> Koopa IR text
+    TimeScope scope("dump");
+    DumpKoopa(raw, out);
+  }
+  else if (strcmp(mode, "-interp") == 0) {
+    // -interp mode: run the Koopa IR program, output result and profile
+    TimeScope scope("interp");
+    if (!Interpret(raw, out, err_msg)) {
+      BaseAST::ctx = outer_ctx;
+      return false;
+    }
+  }
+  else {
+    // Koopa IR program -> RISC-V program
+    TimeScope scope("backend");
+    Visit(raw, out);
+  }
+
+  BaseAST::ctx = outer_ctx;
+  return true;
+}
+
+bool CompileFile(const char *mode, const char *input, const char *output,
+  const compile_options_t &opts, std::string &err_msg, TimeReport *report, CompileStats *stats) {
+  TimeReport *outer_report = TimeReport::active;
+  CompileStats *outer_stats = CompileStats::active;
+  TimeReport::active = report;
+  CompileStats::active = stats;
+  bool ok;
+  {
+    TimeScope scope("total");
+    ok = compile_file(mode, input, output, opts, err_msg);
+  }
+  TimeReport::active = outer_report;
+  CompileStats::active = outer_stats;
+  return ok;
+}
+
+bool compile_file(const char *mode, const char *input, const char *output,
+  const compile_options_t &opts, std::string &err_msg) {
+  std::string source;
+  bool ok_read;
+  {
+    TimeScope scope("read");
+    ok_read = read_file(input, source);
+  }
+  if (!ok_read) {
+    err_msg = std::string("error: cannot read ") + input;
+    return false;
+  }
+
+  // (a cache hit would leave the stats empty, so they bypass the cache)
+  if (opts.cache && !CompileStats::active) {
+    // cache hit: no lexing, GenKoopa or Visit at all
+    std::string key = opts.cache->key(mode, opts.opt_flags, source);
+    std::string cached;
+    bool ok;
+    {
+      TimeScope scope("cache");
+      ok = opts.cache->lookup(key, cached);
+    }
+    if (!ok) {
+      Emitter out;
+      if (!CompileSource(mode, source, opts.opt_flags, out, err_msg)) {
+        return false;
+      }
+      opts.cache->store(key, out.data(), out.size());
+      cached.assign(out.data(), out.size());
+    }
+    if (!write_file(output, cached.data(), cached.size())) {
+      err_msg = std::string("error: cannot write ") + output;
+      return false;
+    }
+    return true;
+  }
+
+  int out_fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0) {
+    err_msg = std::string("error: cannot open ") + output;
+    return false;
+  }
+
+  bool ok;
+  {
+    Emitter out(out_fd);
+    ok = CompileSource(mode, source, opts.opt_flags, out, err_msg);
+    TimeScope scope("write");
+    if (ok && !out.flush()) {
+      err_msg = std::string("error: cannot write ") + output;
+      ok = false;
+    }
+  }
+  close(out_fd);
+
+  // do not leave a half-written output behind
+  if (!ok) {
+    unlink(output);
+  }
+  return ok;
+}
+
+int CompileBatch(const char *mode, const char *list_file, int num_threads, const compile_options_t &opts) {
+  // list -> (infile, outfile) jobs
+  std::string list;
+  if (!read_file(list_file, list)) {
+    std::cerr << "error: cannot read " << list_file << std::endl;
+    return 1;
+  }
+
+  std::vector<std::pair<std::string, std::string>> jobs;
+  std::istringstream lines(list);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string input, output;
+    if (!(fields >> input)) {
+      continue;
+    }
+    if (!(fields >> output)) {
+      std::cerr << "error: no output file for " << input << std::endl;
+      return 1;
+    }
+    jobs.emplace_back(input, output);
+  }
+
+  // run jobs, every job only touches its own slot of err_msgs and reports
+  bool timed = opts.time_report || opts.time_trace;
+  std::vector<std::string> err_msgs(jobs.size());
+  std::vector<TimeReport> reports(timed ? jobs.size() : 0);
+  std::vector<CompileStats> stats(opts.stats_json ? jobs.size() : 0);
+  ThreadPool pool(num_threads);
+  pool.run(jobs.size(), [&](size_t i) {
+    TimeReport *report = timed ? &reports[i] : nullptr;
+    CompileStats *job_stats = opts.stats_json ? &stats[i] : nullptr;
+    CompileFile(mode, jobs[i].first.c_str(), jobs[i].second.c_str(), opts, err_msgs[i], report, job_stats);
+  });
+
+  // report in list order
+  int failures = 0;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (!err_msgs[i].empty()) {
+      std::cerr << jobs[i].first << ": " << err_msgs[i] << std::endl;
+      failures = failures + 1;
+    }
+  }
+
+  if (timed) {
+    std::vector<std::string> titles;
+    std::vector<const TimeReport *> report_ptrs;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      titles.push_back(jobs[i].first);
+      report_ptrs.push_back(&reports[i]);
+    }
+    if (!ReportTimes(opts, titles, report_ptrs)) {
+      failures = failures + 1;
+    }
+  }
+
+  // --stats=json: array of per-file objects, in list order
+  if (opts.stats_json) {
+    std::cout << "[";
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      std::cout << (i == 0 ? "\n" : ",\n");
+      stats[i].write_json(std::cout, jobs[i].first);
+    }
+    std::cout << "\n]" << std::endl;
+  }
+  return failures;
+}
+
+int Simulate(const char *asm_file, const pipeline_config_t &config) {
+  std::string text;
+  if (!read_file(asm_file, text)) {
+    std::cerr << "error: cannot read " << asm_file << std::endl;
+    return 1;
+  }
+
+  RiscvSimulator sim(config);
+  sim_result_t result;
+  if (!sim.assemble(text) || !sim.run(result)) {
+    std::cerr << "error: " << sim.error() << std::endl;
+    return 1;
+  }
+  std::cout << "return: " << result.ret << "\n";
+  std::cout << "instructions: " << result.insts << "\n";
+  std::cout << "loads: " << result.loads << "\n";
+  std::cout << "stores: " << result.stores << "\n";
+  std::cout << "cycles: " << result.cycles << "\n";
+  return 0;
+}
+
+bool ReportTimes(const compile_options_t &opts, const std::vector<std::string> &titles,
+  const std::vector<const TimeReport *> &reports) {
+  if (opts.time_report) {
+    for (size_t i = 0; i < reports.size(); ++i) {
+      reports[i]->print(std::cerr, titles[i].c_str());
+    }
+  }
+  if (opts.time_trace && !write_chrome_trace(opts.time_trace, reports)) {
+    std::cerr << "error: cannot write " << opts.time_trace << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// helper functions
+bool read_file(const char *path, std::string &content) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream buf;
+  buf << in.rdbuf();
+  content = buf.str();
+  return true;
+}
+
+bool write_file(const char *path, const char *data, size_t len) {
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = write_full(fd, data, len);
+  return close(fd) == 0 && ok;
+}
+
+bool read_full(int fd, void *buf, size_t n) {
+  size_t done = 0;
+  while (done < n) {
+    ssize_t r = read(fd, (char *)buf + done, n - done);
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r <= 0) {
+      return false;
+    }
+    done = done + r;
+  }
+  return true;
+}
+
+bool write_full(int fd, const void *buf, size_t n) {
+  size_t done = 0;
+  while (done < n) {
+    ssize_t r = write(fd, (const char *)buf + done, n - done);
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r <= 0) {
+      return false;
+    }
+    done = done + r;
+  }
+  return true;
+}
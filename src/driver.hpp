@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "cache.hpp"
+#include "emitter.hpp"
+#include "opt.hpp"
+#include "rvsim.hpp"
+#include "stats.hpp"
+#include "timer.hpp"
+
+// options shared by all compilations of one compiler invocation
+struct compile_options_t {
+  const CompileCache *cache = nullptr; // optional output cache
+  std::string opt_flags = opt_level_flags(1); // canonical optimization flags (part of the cache key)
+  bool time_report = false; // -ftime-report: phase table on stderr
+  const char *time_trace = nullptr; // -ftime-trace [file]: Chrome trace JSON
+  bool stats_json = false; // --stats=json: counters as JSON on stdout
+};
+
+// One compilation: SysY source -> koopa IR text (mode "-koopa"), result and
+// execution profile of the koopa IR (mode "-interp") or RISC-V assembly
+// (any other mode), with the koopa IR optimized by the passes in opt_flags.
+// All state lives in a CompileContext local to the call, so these functions
+// may run concurrently on different threads.
+// On error false is returned and err_msg is set; nothing is written to stderr.
+bool CompileSource(const char *mode, const std::string &source, const std::string &opt_flags,
+  Emitter &out, std::string &err_msg);
+// Phases are timed into report and counted into stats (each if not null).
+bool CompileFile(const char *mode, const char *input, const char *output,
+  const compile_options_t &opts, std::string &err_msg,
+  TimeReport *report = nullptr, CompileStats *stats = nullptr);
+
+// Batch mode: every non-empty line of list_file is "infile outfile".
+// Files are compiled on num_threads workers; each output only depends on its
+// own input, and diagnostics are reported in list order once all jobs are done,
+// so the result does not depend on scheduling. Returns the number of failures.
+int CompileBatch(const char *mode, const char *list_file, int num_threads, const compile_options_t &opts);
+
+// Run an assembly file on the built-in simulator and print the result,
+// dynamic counts and estimated cycles on stdout. Returns the exit status.
+int Simulate(const char *asm_file, const pipeline_config_t &config);
+
+// -ftime-report tables (stderr, in the given order) and the -ftime-trace file
+// (one trace thread per report); returns false if the trace cannot be written
+bool ReportTimes(const compile_options_t &opts, const std::vector<std::string> &titles,
+  const std::vector<const TimeReport *> &reports);
+
+// helper functions
+bool compile_file(const char *mode, const char *input, const char *output,
+  const compile_options_t &opts, std::string &err_msg);
+bool read_file(const char *path, std::string &content);
+bool write_file(const char *path, const char *data, size_t len);
+bool read_full(int fd, void *buf, size_t n);
+bool write_full(int fd, const void *buf, size_t n);
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "emitter.hpp"
+
+Emitter::Emitter(int fd, size_t capacity) : fd(fd), buf(capacity) {
+    len = 0;
+    failed = false;
+}
+
+Emitter::Emitter() : fd(-1), buf(1 << 16) {
+    len = 0;
+    failed = false;
+}
+
+Emitter::~Emitter() {
+    flush();
+}
+
+Emitter &
+Emitter::operator<<(const char *s) {
+    put(s, std::strlen(s));
+    return *this;
+}
+
+Emitter &
+Emitter::operator<<(const std::string &s) {
+    put(s.data(), s.size());
+    return *this;
+}
+
+Emitter &
+Emitter::operator<<(char c) {
+    reserve(1);
+    buf[len++] = c;
+    return *this;
+}
+
+Emitter &
+Emitter::operator<<(int32_t value) {
+    reserve(12);
+    len = len + format_int(value, buf.data() + len);
+    return *this;
+}
+
+void
+Emitter::put(const char *s, size_t n) {
+    reserve(n);
+    std::memcpy(buf.data() + len, s, n);
+    len = len + n;
+}
+
+bool
+Emitter::flush() {
+    if (fd < 0) {
+        return !failed;
+    }
+
+    // one write per flush (looping only on short writes)
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::write(fd, buf.data() + done, len - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        done = done + n;
+    }
+    len = 0;
+    return !failed;
+}
+
+std::string
+Emitter::str() const {
+    return std::string(buf.data(), len);
+}
+
+const char *
+Emitter::data() const {
+    return buf.data();
+}
+
+size_t
+Emitter::size() const {
+    return len;
+}
+
+void
+Emitter::reserve(size_t n) {
+    if (len + n <= buf.size()) {
+        return;
+    }
+    if (fd >= 0) {
+        flush();
+    }
+    if (len + n > buf.size()) {
+        buf.resize(std::max(buf.size() * 2, len + n));
+    }
+}
+
+size_t format_int(int32_t value, char *out) {
+    // digits are produced backwards into a small scratch buffer
+    char tmp[12];
+    size_t n = 0;
+    uint32_t u = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    do {
+        tmp[n++] = '0' + (u % 10);
+        u = u / 10;
+    } while (u != 0);
+
+    size_t len = 0;
+    if (value < 0) {
+        out[len++] = '-';
+    }
+    while (n > 0) {
+        out[len++] = tmp[--n];
+    }
+    return len;
+}
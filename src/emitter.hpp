@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Buffered output writer for koopa IR text and RISC-V assembly.
+// Text is appended to one contiguous buffer and handed to the OS with a
+// single write() per flush, without iostream locale/virtual overhead.
+// Without a file descriptor the whole output is kept in memory (str()).
+class Emitter {
+    public:
+        explicit Emitter(int fd, size_t capacity = 1 << 20);
+        Emitter();
+        ~Emitter();
+        Emitter(const Emitter &) = delete;
+        Emitter &operator=(const Emitter &) = delete;
+
+        Emitter &operator<<(const char *s);
+        Emitter &operator<<(const std::string &s);
+        Emitter &operator<<(char c);
+        Emitter &operator<<(int32_t value);
+
+        void put(const char *s, size_t n);
+
+        // write buffered bytes to the file descriptor; returns false on IO error
+        bool flush();
+
+        // in-memory output (only without a file descriptor)
+        std::string str() const;
+        const char *data() const;
+        size_t size() const;
+
+    private:
+        void reserve(size_t n);
+
+        int fd;
+        std::vector<char> buf;
+        size_t len;
+        bool failed;
+};
+
+// format a 32-bit integer into `out` (at least 12 bytes), return length
+size_t format_int(int32_t value, char *out);
@@ -0,0 +1,167 @@
+#include <cassert>
+#include <unordered_map>
+#include "flatir.hpp"
+
+// koopa raw function -> flat function
+// raw pointers are resolved to dense ids once here, so the backend never
+// looks up a koopa_raw_value_t again.
+void LowerFunction(const koopa_raw_function_t &func, flat_function_t &flat) {
+  flat.name = (func->name)+1;
+  flat.blocks.clear();
+  flat.insts.clear();
+  flat.operands.clear();
+
+  // number blocks and instructions in program order
+  std::unordered_map<const void *, int> bb_id;
+  std::unordered_map<const void *, int> value_id;
+  size_t inst_count = 0;
+  for (size_t i = 0; i < func->bbs.len; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]);
+    bb_id[bb] = i;
+    inst_count = inst_count + bb->params.len + bb->insts.len;
+  }
+  value_id.reserve(inst_count);
+  flat.blocks.reserve(func->bbs.len);
+  flat.insts.reserve(inst_count);
+  flat.operands.reserve(2 * inst_count);
+
+  int next_id = 0;
+  for (size_t i = 0; i < func->bbs.len; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]);
+    for (size_t j = 0; j < bb->params.len; ++j) {
+      value_id[bb->params.buffer[j]] = next_id++;
+    }
+    for (size_t j = 0; j < bb->insts.len; ++j) {
+      value_id[bb->insts.buffer[j]] = next_id++;
+    }
+  }
+
+  // operand of raw value
+  auto add_operand = [&](koopa_raw_value_t value) {
+    flat_operand_t opd;
+    if (value->kind.tag == KOOPA_RVT_INTEGER) {
+      opd.kind = FLAT_OPD_IMM;
+      opd.value = value->kind.data.integer.value;
+    }
+    else {
+      auto it = value_id.find(value);
+      assert(it != value_id.end());
+      opd.kind = FLAT_OPD_VALUE;
+      opd.value = it->second;
+    }
+    flat.operands.push_back(opd);
+  };
+  auto add_args = [&](const koopa_raw_slice_t &args) {
+    for (size_t k = 0; k < args.len; ++k) {
+      add_operand(reinterpret_cast<koopa_raw_value_t>(args.buffer[k]));
+    }
+    return (int)args.len;
+  };
+
+  // fill blocks, instructions and operands
+  for (size_t i = 0; i < func->bbs.len; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]);
+    flat_block_t fbb;
+    fbb.name = (bb->name)+1;
+    fbb.inst_begin = flat.insts.size();
+    fbb.param_num = bb->params.len;
+
+    for (size_t j = 0; j < bb->params.len; ++j) {
+      flat_inst_t param;
+      param.tag = KOOPA_RVT_BLOCK_ARG_REF;
+      param.op = 0;
+      param.has_result = true;
+      param.opd_begin = flat.operands.size();
+      param.opd_num = 0;
+      param.targets[0] = -1;
+      param.targets[1] = -1;
+      param.arg_num[0] = 0;
+      param.arg_num[1] = 0;
+      param.bb = i;
+      flat.insts.push_back(param);
+    }
+
+    for (size_t j = 0; j < bb->insts.len; ++j) {
+      auto value = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[j]);
+      const auto &kind = value->kind;
+      flat_inst_t inst;
+      inst.tag = kind.tag;
+      inst.op = 0;
+      inst.has_result = (value->ty->tag == KOOPA_RTT_INT32);
+      inst.opd_begin = flat.operands.size();
+      inst.targets[0] = -1;
+      inst.targets[1] = -1;
+      inst.arg_num[0] = 0;
+      inst.arg_num[1] = 0;
+      inst.bb = i;
+
+      switch (kind.tag) {
+        case KOOPA_RVT_ALLOC:
+          break;
+        case KOOPA_RVT_LOAD:
+          add_operand(kind.data.load.src);
+          break;
+        case KOOPA_RVT_STORE:
+          add_operand(kind.data.store.value);
+          add_operand(kind.data.store.dest);
+          break;
+        case KOOPA_RVT_BINARY:
+          inst.op = kind.data.binary.op;
+          add_operand(kind.data.binary.lhs);
+          add_operand(kind.data.binary.rhs);
+          break;
+        case KOOPA_RVT_BRANCH:
+          add_operand(kind.data.branch.cond);
+          inst.targets[0] = bb_id.at(kind.data.branch.true_bb);
+          inst.targets[1] = bb_id.at(kind.data.branch.false_bb);
+          inst.arg_num[0] = add_args(kind.data.branch.true_args);
+          inst.arg_num[1] = add_args(kind.data.branch.false_args);
+          break;
+        case KOOPA_RVT_JUMP:
+          inst.targets[0] = bb_id.at(kind.data.jump.target);
+          inst.arg_num[0] = add_args(kind.data.jump.args);
+          break;
+        case KOOPA_RVT_RETURN:
+          if (kind.data.ret.value) {
+            add_operand(kind.data.ret.value);
+          }
+          break;
+        default:
+          assert(false);
+      }
+
+      inst.opd_num = flat.operands.size() - inst.opd_begin;
+      flat.insts.push_back(inst);
+    }
+
+    fbb.inst_end = flat.insts.size();
+    flat.blocks.push_back(fbb);
+  }
+
+  // liveness side tables
+  flat.use_count.assign(flat.insts.size(), 0);
+  flat.last_use.assign(flat.insts.size(), -1);
+  for (size_t id = 0; id < flat.insts.size(); ++id) {
+    const flat_inst_t &inst = flat.insts[id];
+    for (int k = 0; k < inst.opd_num; ++k) {
+      const flat_operand_t &opd = flat.operands[inst.opd_begin + k];
+      if (opd.kind == FLAT_OPD_VALUE) {
+        flat.use_count[opd.value] = flat.use_count[opd.value] + 1;
+        flat.last_use[opd.value] = id;
+      }
+    }
+  }
+}
+
+// helper functions
+const flat_operand_t &flat_operand(const flat_function_t &flat, const flat_inst_t &inst, int i) {
+  assert(i < inst.opd_num);
+  return flat.operands[inst.opd_begin + i];
+}
+
+// arg i passed to block param i of target (0: true/jump, 1: false)
+const flat_operand_t &flat_arg(const flat_function_t &flat, const flat_inst_t &inst, int target, int i) {
+  assert(i < inst.arg_num[target]);
+  int begin = inst.opd_num - inst.arg_num[0] - inst.arg_num[1] + (target == 1 ? inst.arg_num[0] : 0);
+  return flat.operands[inst.opd_begin + begin + i];
+}
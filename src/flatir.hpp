@@ -0,0 +1,59 @@
+#pragma once
+
+#include "koopa.h"
+#include <vector>
+
+// Dense index-based view of a koopa function, used by the backend.
+// Every instruction gets an integer id equal to its index in `insts`
+// (program order), blocks are numbered the same way, and all operands
+// live in one contiguous array. Block parameters are placed at the start
+// of their block as KOOPA_RVT_BLOCK_ARG_REF instructions without operands.
+// Per-value backend state (stack offsets, registers, liveness) is then kept
+// in vectors indexed by value id.
+
+// operand kinds
+enum flat_operand_kind_t {
+  FLAT_OPD_VALUE, // result of another instruction (value id)
+  FLAT_OPD_IMM,   // integer constant
+};
+
+typedef struct {
+  flat_operand_kind_t kind;
+  int32_t value; // value id or immediate
+} flat_operand_t;
+
+typedef struct {
+  koopa_raw_value_tag_t tag;
+  koopa_raw_binary_op_t op; // binary op, only for KOOPA_RVT_BINARY
+  bool has_result;          // produces an i32 that needs a home
+  int opd_begin;            // first operand in flat_function_t::operands
+  int opd_num;              // operand count
+  int targets[2];           // branch true/false or jump target block id, -1 if none
+  int arg_num[2];           // block args passed to each target, last operands
+  int bb;                   // owner block id
+} flat_inst_t;
+
+typedef struct {
+  const char *name; // without '%', points into the raw program
+  int inst_begin;   // first instruction id
+  int param_num;    // block parameters, the first param_num "instructions"
+  int inst_end;     // one past the last instruction id
+} flat_block_t;
+
+typedef struct {
+  const char *name; // without '@', points into the raw program
+  std::vector<flat_block_t> blocks;
+  std::vector<flat_inst_t> insts;
+  std::vector<flat_operand_t> operands;
+
+  // side tables indexed by value id
+  std::vector<int> use_count; // number of uses as an operand
+  std::vector<int> last_use;  // id of the last instruction using the value, -1 if unused
+} flat_function_t;
+
+// koopa raw function -> flat function
+void LowerFunction(const koopa_raw_function_t &func, flat_function_t &flat);
+
+// helper functions
+const flat_operand_t &flat_operand(const flat_function_t &flat, const flat_inst_t &inst, int i);
+const flat_operand_t &flat_arg(const flat_function_t &flat, const flat_inst_t &inst, int target, int i);
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "opt.hpp"
+#include "cfg.hpp"
+#include "stats.hpp"
+
+// key of a binary: op and operands, operands in canonical order
+typedef std::tuple<int, koopa_raw_value_t, koopa_raw_value_t> gvn_key_t;
+
+// a op b == b swapped_op a, -1 if op does not allow swapping
+static int swapped_op(koopa_raw_binary_op_t op) {
+  switch (op) {
+    case KOOPA_RBO_ADD:
+    case KOOPA_RBO_MUL:
+    case KOOPA_RBO_AND:
+    case KOOPA_RBO_OR:
+    case KOOPA_RBO_XOR:
+    case KOOPA_RBO_EQ:
+    case KOOPA_RBO_NOT_EQ:
+      return op;
+    case KOOPA_RBO_LT: return KOOPA_RBO_GT;
+    case KOOPA_RBO_GT: return KOOPA_RBO_LT;
+    case KOOPA_RBO_LE: return KOOPA_RBO_GE;
+    case KOOPA_RBO_GE: return KOOPA_RBO_LE;
+    default: return -1;
+  }
+}
+
+// Global value numbering over the dominator tree.
+// Walking the tree in preorder, a binary with the same op and operands as
+// one in a dominating block (or earlier in its own block) is replaced by it.
+// Loads are numbered per alloc: a load reuses the value last loaded from or
+// stored to the alloc, unless a store to it may run in between. Allocs never
+// alias (no pointers escape them), so only stores to the same alloc count.
+// Scoped tables are restored when the walk leaves a subtree.
+void GVN(KoopaBuilder &builder, const koopa_raw_function_t &func) {
+  remove_unreachable_blocks(builder, func);
+  koopa_cfg_t cfg;
+  BuildCFG(func, cfg);
+  ComputeDominators(cfg);
+  size_t bb_num = cfg.bbs.size();
+  if (bb_num == 0) {
+    return;
+  }
+
+  // allocs stored to in every block
+  std::vector<std::vector<koopa_raw_value_t>> stored(bb_num);
+  for (size_t b = 0; b < bb_num; ++b) {
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      if (inst->kind.tag == KOOPA_RVT_STORE) {
+        stored[b].push_back(inst->kind.data.store.dest);
+      }
+    }
+  }
+
+  std::unordered_map<koopa_raw_value_t, koopa_raw_value_t> repl; // removed value -> value
+  auto resolve = [&](koopa_raw_value_t v) {
+    auto it = repl.find(v);
+    while (it != repl.end()) {
+      v = it->second;
+      it = repl.find(v);
+    }
+    return v;
+  };
+  // one integer value per constant, so operands compare by pointer
+  std::unordered_map<int32_t, koopa_raw_value_t> ints;
+  auto number = [&](koopa_raw_value_t v) {
+    if (v->kind.tag != KOOPA_RVT_INTEGER) {
+      return v;
+    }
+    return ints.emplace(v->kind.data.integer.value, v).first->second;
+  };
+
+  // scoped tables, undo logs restore them when leaving a subtree
+  std::map<gvn_key_t, koopa_raw_value_t> exprs;
+  std::unordered_map<koopa_raw_value_t, koopa_raw_value_t> loads; // alloc -> value in it
+  std::vector<std::pair<gvn_key_t, koopa_raw_value_t>> expr_undo;
+  std::vector<std::pair<koopa_raw_value_t, koopa_raw_value_t>> load_undo;
+  auto set_load = [&](koopa_raw_value_t alloc, koopa_raw_value_t v) {
+    auto it = loads.find(alloc);
+    load_undo.emplace_back(alloc, it == loads.end() ? nullptr : it->second);
+    loads[alloc] = v;
+  };
+
+  // allocs possibly stored to between the end of idom(b) and the start of b:
+  // stores of every block reaching b without passing through idom(b)
+  std::vector<int> seen(bb_num, -1);
+  std::vector<int> worklist;
+  auto kill_loads = [&](int b) {
+    int d = cfg.idom[b];
+    worklist.assign(cfg.preds[b].begin(), cfg.preds[b].end());
+    while (!worklist.empty()) {
+      int p = worklist.back();
+      worklist.pop_back();
+      if (p == d || seen[p] == b) {
+        continue;
+      }
+      seen[p] = b;
+      for (koopa_raw_value_t alloc : stored[p]) {
+        set_load(alloc, nullptr);
+      }
+      worklist.insert(worklist.end(), cfg.preds[p].begin(), cfg.preds[p].end());
+    }
+  };
+
+  int binary_num = 0;
+  int load_num = 0;
+  std::vector<std::tuple<int, size_t, size_t>> stack; // (block, undo marks), SIZE_MAX before entering
+  stack.emplace_back(0, SIZE_MAX, SIZE_MAX);
+  while (!stack.empty()) {
+    int b = std::get<0>(stack.back());
+    if (std::get<1>(stack.back()) != SIZE_MAX) {
+      // leave the subtree of b
+      size_t expr_mark = std::get<1>(stack.back());
+      size_t load_mark = std::get<2>(stack.back());
+      while (expr_undo.size() > expr_mark) {
+        if (expr_undo.back().second) {
+          exprs[expr_undo.back().first] = expr_undo.back().second;
+        }
+        else {
+          exprs.erase(expr_undo.back().first);
+        }
+        expr_undo.pop_back();
+      }
+      while (load_undo.size() > load_mark) {
+        loads[load_undo.back().first] = load_undo.back().second;
+        load_undo.pop_back();
+      }
+      stack.pop_back();
+      continue;
+    }
+    std::get<1>(stack.back()) = expr_undo.size();
+    std::get<2>(stack.back()) = load_undo.size();
+
+    if (b != 0 && !loads.empty()) {
+      kill_loads(b);
+    }
+
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    std::vector<const void *> insts;
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      for_each_operand(builder, inst, [&](koopa_raw_value_t &opd) {
+        opd = resolve(opd);
+      });
+      const auto &kind = inst->kind;
+      if (kind.tag == KOOPA_RVT_BINARY) {
+        int op = kind.data.binary.op;
+        koopa_raw_value_t lhs = number(kind.data.binary.lhs);
+        koopa_raw_value_t rhs = number(kind.data.binary.rhs);
+        int swapped = swapped_op(kind.data.binary.op);
+        if (swapped >= 0 && std::less<koopa_raw_value_t>()(rhs, lhs)) {
+          std::swap(lhs, rhs);
+          op = swapped;
+        }
+        gvn_key_t key(op, lhs, rhs);
+        auto it = exprs.find(key);
+        if (it != exprs.end()) {
+          repl[inst] = it->second;
+          binary_num = binary_num + 1;
+          continue;
+        }
+        expr_undo.emplace_back(key, nullptr);
+        exprs[key] = inst;
+      }
+      else if (kind.tag == KOOPA_RVT_LOAD) {
+        auto it = loads.find(kind.data.load.src);
+        if (it != loads.end() && it->second) {
+          repl[inst] = it->second;
+          load_num = load_num + 1;
+          continue;
+        }
+        set_load(kind.data.load.src, inst);
+      }
+      else if (kind.tag == KOOPA_RVT_STORE) {
+        set_load(kind.data.store.dest, kind.data.store.value);
+      }
+      insts.push_back(inst);
+    }
+    builder.mutable_block(bb)->insts = builder.new_slice(insts, KOOPA_RSIK_VALUE);
+
+    for (auto it = cfg.dom_children[b].rbegin(); it != cfg.dom_children[b].rend(); ++it) {
+      stack.emplace_back(*it, SIZE_MAX, SIZE_MAX);
+    }
+  }
+
+  if (CompileStats::active) {
+    CompileStats::active->count_opt("gvn.binaries", binary_num);
+    CompileStats::active->count_opt("gvn.loads", load_num);
+  }
+}
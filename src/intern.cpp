@@ -0,0 +1,68 @@
+#include <cstring>
+#include "intern.hpp"
+
+static uint32_t hash_str(const char *s, size_t len) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+    }
+    return h;
+}
+
+StringInterner::StringInterner() : slots(256, -1), storage(16 * 1024) {
+}
+
+sym_id_t
+StringInterner::intern(const char *s, size_t len) {
+    uint32_t h = hash_str(s, len);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; ; i = (i + 1) & mask) {
+        sym_id_t id = slots[i];
+        if (id < 0) {
+            // new identifier
+            char *str = static_cast<char *>(storage.allocate(len + 1, 1));
+            std::memcpy(str, s, len);
+            str[len] = '\0';
+
+            id = strs.size();
+            strs.push_back(str);
+            lens.push_back(len);
+            hashes.push_back(h);
+            slots[i] = id;
+
+            // keep load factor below 1/2
+            if (2 * strs.size() > slots.size()) {
+                grow();
+            }
+            return id;
+        }
+        if (hashes[id] == h && lens[id] == len && std::memcmp(strs[id], s, len) == 0) {
+            return id;
+        }
+    }
+}
+
+const char *
+StringInterner::name(sym_id_t id) const {
+    return strs[id];
+}
+
+size_t
+StringInterner::size() const {
+    return strs.size();
+}
+
+void
+StringInterner::grow() {
+    std::vector<sym_id_t> new_slots(slots.size() * 2, -1);
+    size_t mask = new_slots.size() - 1;
+    for (sym_id_t id = 0; id < static_cast<sym_id_t>(strs.size()); id++) {
+        size_t i = hashes[id] & mask;
+        while (new_slots[i] >= 0) {
+            i = (i + 1) & mask;
+        }
+        new_slots[i] = id;
+    }
+    slots.swap(new_slots);
+}
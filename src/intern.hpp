@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "arena.hpp"
+
+// dense id of an interned identifier
+typedef int32_t sym_id_t;
+
+// Identifier interner.
+// The lexer interns every IDENT once; the rest of the compiler only handles
+// dense sym_id_t values (0, 1, 2, ...), so symbol lookups never hash or
+// compare strings again.
+class StringInterner {
+    public:
+        StringInterner();
+
+        sym_id_t intern(const char *s, size_t len);
+        const char *name(sym_id_t id) const;
+        size_t size() const;
+
+    private:
+        void grow();
+
+        // open addressing (linear probing) table of ids, -1 marks an empty slot
+        std::vector<sym_id_t> slots;
+        std::vector<const char *> strs;
+        std::vector<uint32_t> lens;
+        std::vector<uint32_t> hashes;
+        Arena storage; // bytes of all interned strings
+};
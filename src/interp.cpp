@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "interp.hpp"
+#include "irdump.hpp"
+
+// upper bound of executed instructions, guards against endless loops
+#define INTERP_MAX_STEPS 4000000000ull
+
+bool Interpret(const koopa_raw_program_t &program, Emitter &out, std::string &err_msg) {
+  // find @main
+  koopa_raw_function_t main_func = nullptr;
+  for (size_t i = 0; i < program.funcs.len; ++i) {
+    auto func = reinterpret_cast<koopa_raw_function_t>(program.funcs.buffer[i]);
+    if (strcmp(func->name, "@main") == 0) {
+      main_func = func;
+    }
+  }
+  if (!main_func) {
+    err_msg = "error: no @main";
+    return false;
+  }
+
+  flat_function_t flat;
+  LowerFunction(main_func, flat);
+  std::vector<uint64_t> inst_count(flat.insts.size(), 0);
+  int32_t ret = 0;
+  if (!interp_function(flat, inst_count, ret, err_msg)) {
+    return false;
+  }
+
+  // a block runs as often as its first instruction (after the params)
+  std::vector<uint64_t> bb_count(flat.blocks.size(), 0);
+  uint64_t total = 0;
+  for (size_t i = 0; i < flat.blocks.size(); ++i) {
+    const flat_block_t &bb = flat.blocks[i];
+    int first = bb.inst_begin + bb.param_num;
+    bb_count[i] = first < bb.inst_end ? inst_count[first] : 0;
+  }
+  for (uint64_t n : inst_count) {
+    total = total + n;
+  }
+
+  out << "result: " << ret << "\n";
+  out << "instructions: " << std::to_string(total) << "\n";
+
+  // annotated listing (flat ids follow the raw program order)
+  out << "\nfun " << main_func->name << "\n";
+  for (size_t i = 0; i < main_func->bbs.len; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(main_func->bbs.buffer[i]);
+    int id = flat.blocks[i].inst_begin + flat.blocks[i].param_num;
+    emit_count(out, bb_count[i]);
+    DumpKoopaLabel(bb, out);
+    for (size_t j = 0; j < bb->insts.len; ++j) {
+      emit_count(out, inst_count[id++]);
+      DumpKoopa(reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[j]), out);
+    }
+  }
+
+  // hottest blocks
+  std::vector<int> order(flat.blocks.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return bb_count[a] > bb_count[b];
+  });
+  out << "\nhot blocks:\n";
+  for (size_t i = 0; i < order.size() && i < 10; ++i) {
+    emit_count(out, bb_count[order[i]]);
+    out << "%" << flat.blocks[order[i]].name << "\n";
+  }
+  return true;
+}
+
+// helper functions
+bool interp_function(const flat_function_t &flat, std::vector<uint64_t> &inst_count,
+  int32_t &ret, std::string &err_msg) {
+  // values and alloc'ed memory are both indexed by value id
+  std::vector<int32_t> values(flat.insts.size(), 0);
+  std::vector<int32_t> memory(flat.insts.size(), 0);
+  auto operand = [&](const flat_inst_t &inst, int i) {
+    const flat_operand_t &opd = flat_operand(flat, inst, i);
+    return opd.kind == FLAT_OPD_IMM ? opd.value : values[opd.value];
+  };
+  auto address = [&](const flat_inst_t &inst, int i) {
+    const flat_operand_t &opd = flat_operand(flat, inst, i);
+    assert(opd.kind == FLAT_OPD_VALUE && flat.insts[opd.value].tag == KOOPA_RVT_ALLOC);
+    return opd.value;
+  };
+
+  // block args of target k of inst, written to the params of the target
+  // (all args are read before any param is written)
+  std::vector<int32_t> args;
+  auto pass_args = [&](const flat_inst_t &inst, int k) {
+    args.clear();
+    for (int i = 0; i < inst.arg_num[k]; ++i) {
+      const flat_operand_t &opd = flat_arg(flat, inst, k, i);
+      args.push_back(opd.kind == FLAT_OPD_IMM ? opd.value : values[opd.value]);
+    }
+    int first_param = flat.blocks[inst.targets[k]].inst_begin;
+    for (size_t i = 0; i < args.size(); ++i) {
+      values[first_param + i] = args[i];
+    }
+    return inst.targets[k];
+  };
+
+  uint64_t steps = 0;
+  int bb = 0;
+  for (;;) {
+    const flat_block_t &block = flat.blocks[bb];
+    int next_bb = -1;
+    for (int id = block.inst_begin + block.param_num; id < block.inst_end && next_bb < 0; ++id) {
+      const flat_inst_t &inst = flat.insts[id];
+      inst_count[id] = inst_count[id] + 1;
+      if (++steps > INTERP_MAX_STEPS) {
+        err_msg = "error: step limit reached";
+        return false;
+      }
+
+      switch (inst.tag) {
+        case KOOPA_RVT_ALLOC:
+          break;
+        case KOOPA_RVT_LOAD:
+          values[id] = memory[address(inst, 0)];
+          break;
+        case KOOPA_RVT_STORE:
+          memory[address(inst, 1)] = operand(inst, 0);
+          break;
+        case KOOPA_RVT_BINARY:
+          if (!interp_binary(inst.op, operand(inst, 0), operand(inst, 1), values[id])) {
+            err_msg = "error: division by zero";
+            return false;
+          }
+          break;
+        case KOOPA_RVT_BRANCH:
+          next_bb = pass_args(inst, operand(inst, 0) != 0 ? 0 : 1);
+          break;
+        case KOOPA_RVT_JUMP:
+          next_bb = pass_args(inst, 0);
+          break;
+        case KOOPA_RVT_RETURN:
+          ret = inst.opd_num > 0 ? operand(inst, 0) : 0;
+          return true;
+        default:
+          err_msg = "error: unsupported instruction";
+          return false;
+      }
+    }
+    if (next_bb < 0) {
+      err_msg = "error: block without terminator";
+      return false;
+    }
+    bb = next_bb;
+  }
+}
+
+bool interp_binary(koopa_raw_binary_op_t op, int32_t lhs, int32_t rhs, int32_t &result) {
+  uint32_t ul = static_cast<uint32_t>(lhs), ur = static_cast<uint32_t>(rhs);
+  switch (op) {
+    case KOOPA_RBO_NOT_EQ: result = lhs != rhs; break;
+    case KOOPA_RBO_EQ: result = lhs == rhs; break;
+    case KOOPA_RBO_GT: result = lhs > rhs; break;
+    case KOOPA_RBO_LT: result = lhs < rhs; break;
+    case KOOPA_RBO_GE: result = lhs >= rhs; break;
+    case KOOPA_RBO_LE: result = lhs <= rhs; break;
+    case KOOPA_RBO_ADD: result = static_cast<int32_t>(ul + ur); break;
+    case KOOPA_RBO_SUB: result = static_cast<int32_t>(ul - ur); break;
+    case KOOPA_RBO_MUL: result = static_cast<int32_t>(ul * ur); break;
+    case KOOPA_RBO_DIV:
+    case KOOPA_RBO_MOD:
+      if (rhs == 0) {
+        return false;
+      }
+      // INT_MIN / -1 wraps like the RISC-V div/rem
+      if (lhs == INT32_MIN && rhs == -1) {
+        result = op == KOOPA_RBO_DIV ? lhs : 0;
+      }
+      else {
+        result = op == KOOPA_RBO_DIV ? lhs / rhs : lhs % rhs;
+      }
+      break;
+    case KOOPA_RBO_AND: result = lhs & rhs; break;
+    case KOOPA_RBO_OR: result = lhs | rhs; break;
+    case KOOPA_RBO_XOR: result = lhs ^ rhs; break;
+    case KOOPA_RBO_SHL: result = static_cast<int32_t>(ul << (ur & 31)); break;
+    case KOOPA_RBO_SHR: result = static_cast<int32_t>(ul >> (ur & 31)); break;
+    case KOOPA_RBO_SAR: result = lhs >> (ur & 31); break;
+    default: assert(false);
+  }
+  return true;
+}
+
+void emit_count(Emitter &out, uint64_t count) {
+  // right-aligned count column
+  std::string s = std::to_string(count);
+  for (size_t i = s.size(); i < 12; ++i) {
+    out << ' ';
+  }
+  out << s << "  ";
+}
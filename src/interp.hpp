@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "koopa.h"
+#include "emitter.hpp"
+#include "flatir.hpp"
+
+// Koopa IR interpreter (-interp mode).
+// Runs @main of the raw program on its flat form (dense value ids, see
+// flatir.hpp) and writes the result followed by a profile: the koopa listing
+// with the execution count of every block and instruction, and the hottest
+// blocks. Runtime errors (division by zero, step limit) return false.
+bool Interpret(const koopa_raw_program_t &program, Emitter &emitter, std::string &err_msg);
+
+// helper functions
+bool interp_function(const flat_function_t &flat, std::vector<uint64_t> &inst_count,
+  int32_t &ret, std::string &err_msg);
+bool interp_binary(koopa_raw_binary_op_t op, int32_t lhs, int32_t rhs, int32_t &result);
+void emit_count(Emitter &out, uint64_t count);
@@ -0,0 +1,302 @@
+#include <cassert>
+#include "irbuilder.hpp"
+#include "emitter.hpp"
+#include "irdump.hpp"
+#include "stats.hpp"
+
+static koopa_raw_slice_t empty_slice(koopa_raw_slice_item_kind_t kind) {
+    koopa_raw_slice_t slice;
+    slice.buffer = nullptr;
+    slice.len = 0;
+    slice.kind = kind;
+    return slice;
+}
+
+// opcode names for --stats
+static const char *value_tag_name(koopa_raw_value_tag_t tag) {
+    switch (tag) {
+        case KOOPA_RVT_INTEGER: return "integer";
+        case KOOPA_RVT_ALLOC: return "alloc";
+        case KOOPA_RVT_LOAD: return "load";
+        case KOOPA_RVT_STORE: return "store";
+        case KOOPA_RVT_BINARY: return "binary";
+        case KOOPA_RVT_BRANCH: return "br";
+        case KOOPA_RVT_JUMP: return "jump";
+        case KOOPA_RVT_RETURN: return "ret";
+        case KOOPA_RVT_BLOCK_ARG_REF: return "block_arg";
+        default: return "other";
+    }
+}
+
+KoopaBuilder::KoopaBuilder() {
+    temp_num = 0;
+    cur_func = nullptr;
+    cur_bb = nullptr;
+
+    // basic types
+    koopa_raw_type_kind_t &int32 = types.emplace_back();
+    int32.tag = KOOPA_RTT_INT32;
+    ty_int32 = &int32;
+
+    koopa_raw_type_kind_t &unit = types.emplace_back();
+    unit.tag = KOOPA_RTT_UNIT;
+    ty_unit = &unit;
+
+    koopa_raw_type_kind_t &int32_ptr = types.emplace_back();
+    int32_ptr.tag = KOOPA_RTT_POINTER;
+    int32_ptr.data.pointer.base = ty_int32;
+    ty_int32_ptr = &int32_ptr;
+}
+
+// types
+koopa_raw_type_t
+KoopaBuilder::int32_type() const {
+    return ty_int32;
+}
+
+koopa_raw_type_t
+KoopaBuilder::unit_type() const {
+    return ty_unit;
+}
+
+koopa_raw_type_t
+KoopaBuilder::int32_ptr_type() const {
+    return ty_int32_ptr;
+}
+
+// functions and basic blocks
+void
+KoopaBuilder::new_function(const std::string &name, koopa_raw_type_t ret_type) {
+    assert(!cur_func);
+
+    koopa_raw_type_kind_t &func_ty = types.emplace_back();
+    func_ty.tag = KOOPA_RTT_FUNCTION;
+    func_ty.data.function.params = empty_slice(KOOPA_RSIK_TYPE);
+    func_ty.data.function.ret = ret_type;
+
+    koopa_raw_function_data_t &func = funcs.emplace_back();
+    func.ty = &func_ty;
+    func.name = new_name(name);
+    func.params = empty_slice(KOOPA_RSIK_VALUE);
+    func.bbs = empty_slice(KOOPA_RSIK_BASIC_BLOCK);
+
+    cur_func = &func;
+    cur_bbs.clear();
+}
+
+void
+KoopaBuilder::end_function() {
+    assert(cur_func);
+    seal_block();
+    cur_func->bbs = new_slice(cur_bbs, KOOPA_RSIK_BASIC_BLOCK);
+    all_funcs.push_back(cur_func);
+    cur_func = nullptr;
+    cur_bbs.clear();
+}
+
+koopa_raw_basic_block_t
+KoopaBuilder::new_block(const char *prefix, int index) {
+    if (CompileStats::active) {
+        CompileStats::active->count_block(prefix + 1);
+    }
+
+    koopa_raw_basic_block_data_t &bb = blocks.emplace_back();
+    bb.name = index < 0 ? new_name(prefix) : new_name(prefix, index);
+    bb.params = empty_slice(KOOPA_RSIK_VALUE);
+    bb.used_by = empty_slice(KOOPA_RSIK_VALUE);
+    bb.insts = empty_slice(KOOPA_RSIK_VALUE);
+    return &bb;
+}
+
+void
+KoopaBuilder::insert_block(koopa_raw_basic_block_t bb) {
+    assert(cur_func);
+    seal_block();
+    cur_bbs.push_back(bb);
+    // blocks handed out by new_block are owned (and mutable) here
+    cur_bb = const_cast<koopa_raw_basic_block_data_t *>(bb);
+}
+
+// values
+koopa_raw_value_t
+KoopaBuilder::new_integer(int32_t value) {
+    koopa_raw_value_data_t *v = new_value(ty_int32, nullptr, KOOPA_RVT_INTEGER);
+    v->kind.data.integer.value = value;
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_alloc(const std::string &name) {
+    koopa_raw_value_data_t *v = new_value(ty_int32_ptr, new_name(name), KOOPA_RVT_ALLOC);
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_load(koopa_raw_value_t src) {
+    koopa_raw_value_data_t *v = new_value(ty_int32, new_temp_name(), KOOPA_RVT_LOAD);
+    v->kind.data.load.src = src;
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_store(koopa_raw_value_t value, koopa_raw_value_t dest) {
+    koopa_raw_value_data_t *v = new_value(ty_unit, nullptr, KOOPA_RVT_STORE);
+    v->kind.data.store.value = value;
+    v->kind.data.store.dest = dest;
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_binary(koopa_raw_binary_op_t op, koopa_raw_value_t lhs, koopa_raw_value_t rhs) {
+    koopa_raw_value_data_t *v = new_value(ty_int32, new_temp_name(), KOOPA_RVT_BINARY);
+    if (CompileStats::active) {
+        CompileStats::active->count_koopa_binary(koopa_binary_op_str(op));
+    }
+    v->kind.data.binary.op = op;
+    v->kind.data.binary.lhs = lhs;
+    v->kind.data.binary.rhs = rhs;
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_branch(koopa_raw_value_t cond, koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb) {
+    koopa_raw_value_data_t *v = new_value(ty_unit, nullptr, KOOPA_RVT_BRANCH);
+    v->kind.data.branch.cond = cond;
+    v->kind.data.branch.true_bb = true_bb;
+    v->kind.data.branch.false_bb = false_bb;
+    v->kind.data.branch.true_args = empty_slice(KOOPA_RSIK_VALUE);
+    v->kind.data.branch.false_args = empty_slice(KOOPA_RSIK_VALUE);
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_jump(koopa_raw_basic_block_t target) {
+    koopa_raw_value_data_t *v = new_value(ty_unit, nullptr, KOOPA_RVT_JUMP);
+    v->kind.data.jump.target = target;
+    v->kind.data.jump.args = empty_slice(KOOPA_RSIK_VALUE);
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_return(koopa_raw_value_t value) {
+    koopa_raw_value_data_t *v = new_value(ty_unit, nullptr, KOOPA_RVT_RETURN);
+    v->kind.data.ret.value = value;
+    append_inst(v);
+    return v;
+}
+
+koopa_raw_value_t
+KoopaBuilder::new_block_arg_ref(size_t index) {
+    koopa_raw_value_data_t *v = new_value(ty_int32, new_temp_name(), KOOPA_RVT_BLOCK_ARG_REF);
+    v->kind.data.block_arg_ref.index = index;
+    return v;
+}
+
+bool
+KoopaBuilder::remove_last_inst(koopa_raw_value_t inst) {
+    if (cur_insts.empty() || cur_insts.back() != inst) {
+        return false;
+    }
+    cur_insts.pop_back();
+    return true;
+}
+
+// rewriting built functions
+// everything handed out by this builder is owned (and mutable) here
+koopa_raw_function_data_t *
+KoopaBuilder::mutable_function(koopa_raw_function_t func) {
+    return const_cast<koopa_raw_function_data_t *>(func);
+}
+
+koopa_raw_basic_block_data_t *
+KoopaBuilder::mutable_block(koopa_raw_basic_block_t bb) {
+    return const_cast<koopa_raw_basic_block_data_t *>(bb);
+}
+
+koopa_raw_value_data_t *
+KoopaBuilder::mutable_value(koopa_raw_value_t value) {
+    return const_cast<koopa_raw_value_data_t *>(value);
+}
+
+// slices and names
+koopa_raw_slice_t
+KoopaBuilder::new_slice(std::vector<const void *> items, koopa_raw_slice_item_kind_t kind) {
+    if (items.empty()) {
+        return empty_slice(kind);
+    }
+
+    std::vector<const void *> &buf = slice_bufs.emplace_back(std::move(items));
+    koopa_raw_slice_t slice;
+    slice.buffer = buf.data();
+    slice.len = buf.size();
+    slice.kind = kind;
+    return slice;
+}
+
+const char *
+KoopaBuilder::new_name(const std::string &name) {
+    return names.emplace_back(name).c_str();
+}
+
+const char *
+KoopaBuilder::new_name(const char *prefix, int index) {
+    std::string &name = names.emplace_back(prefix);
+    char digits[12];
+    name.append(digits, format_int(index, digits));
+    return name.c_str();
+}
+
+const char *
+KoopaBuilder::new_temp_name() {
+    return new_name("%", temp_num++);
+}
+
+koopa_raw_program_t
+KoopaBuilder::build() {
+    assert(!cur_func);
+    koopa_raw_program_t program;
+    program.values = empty_slice(KOOPA_RSIK_VALUE);
+    program.funcs = new_slice(all_funcs, KOOPA_RSIK_FUNCTION);
+    return program;
+}
+
+// private helpers
+koopa_raw_value_data_t *
+KoopaBuilder::new_value(koopa_raw_type_t ty, const char *name, koopa_raw_value_tag_t tag) {
+    if (CompileStats::active) {
+        CompileStats::active->count_koopa_value(value_tag_name(tag));
+    }
+
+    koopa_raw_value_data_t &v = values.emplace_back();
+    v.ty = ty;
+    v.name = name;
+    v.used_by = empty_slice(KOOPA_RSIK_VALUE);
+    v.kind.tag = tag;
+    return &v;
+}
+
+void
+KoopaBuilder::append_inst(koopa_raw_value_t inst) {
+    // outside of a function under construction (optimization passes) the
+    // caller places the instruction itself
+    if (!cur_func) {
+        return;
+    }
+    assert(cur_bb);
+    cur_insts.push_back(inst);
+}
+
+void
+KoopaBuilder::seal_block() {
+    if (cur_bb) {
+        cur_bb->insts = new_slice(cur_insts, KOOPA_RSIK_VALUE);
+    }
+    cur_bb = nullptr;
+    cur_insts.clear();
+}
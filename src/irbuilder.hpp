@@ -0,0 +1,82 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "koopa.h"
+
+// In-memory builder of koopa raw programs.
+// GenKoopa creates values, basic blocks and functions through this class
+// directly, so no koopa IR text is formatted or parsed on the way to the backend.
+// All raw data (types, values, blocks, functions, slices, names) is owned by
+// the builder and released together with it.
+class KoopaBuilder {
+    public:
+        KoopaBuilder();
+        KoopaBuilder(const KoopaBuilder &) = delete;
+        KoopaBuilder &operator=(const KoopaBuilder &) = delete;
+
+        // types
+        koopa_raw_type_t int32_type() const;
+        koopa_raw_type_t unit_type() const;
+        koopa_raw_type_t int32_ptr_type() const;
+
+        // functions and basic blocks
+        void new_function(const std::string &name, koopa_raw_type_t ret_type);
+        void end_function();
+        koopa_raw_basic_block_t new_block(const char *prefix, int index = -1); // named prefix + index
+        void insert_block(koopa_raw_basic_block_t bb); // append to current function and make it current
+
+        // values (instructions are appended to the current basic block,
+        // outside of new_function/end_function they are only created)
+        koopa_raw_value_t new_integer(int32_t value);
+        koopa_raw_value_t new_alloc(const std::string &name);
+        koopa_raw_value_t new_load(koopa_raw_value_t src);
+        koopa_raw_value_t new_store(koopa_raw_value_t value, koopa_raw_value_t dest);
+        koopa_raw_value_t new_binary(koopa_raw_binary_op_t op, koopa_raw_value_t lhs, koopa_raw_value_t rhs);
+        koopa_raw_value_t new_branch(koopa_raw_value_t cond, koopa_raw_basic_block_t true_bb, koopa_raw_basic_block_t false_bb);
+        koopa_raw_value_t new_jump(koopa_raw_basic_block_t target);
+        koopa_raw_value_t new_return(koopa_raw_value_t value);
+        koopa_raw_value_t new_block_arg_ref(size_t index); // block parameter, not appended
+        bool remove_last_inst(koopa_raw_value_t inst); // undo the append of inst if nothing came after it
+
+        // rewriting built functions (optimization passes)
+        koopa_raw_function_data_t *mutable_function(koopa_raw_function_t func);
+        koopa_raw_basic_block_data_t *mutable_block(koopa_raw_basic_block_t bb);
+        koopa_raw_value_data_t *mutable_value(koopa_raw_value_t value);
+
+        // slices and names with builder lifetime
+        koopa_raw_slice_t new_slice(std::vector<const void *> items, koopa_raw_slice_item_kind_t kind);
+        const char *new_name(const std::string &name);
+        const char *new_name(const char *prefix, int index); // prefix + index, no temporaries
+        const char *new_temp_name(); // "%0", "%1", ...
+
+        // seal all slices and return the raw program
+        koopa_raw_program_t build();
+
+    private:
+        koopa_raw_value_data_t *new_value(koopa_raw_type_t ty, const char *name, koopa_raw_value_tag_t tag);
+        void append_inst(koopa_raw_value_t inst);
+        void seal_block();
+
+        int temp_num; // next koopa temp symbol number
+
+        // storage (deque keeps element addresses stable)
+        std::deque<koopa_raw_type_kind_t> types;
+        std::deque<koopa_raw_value_data_t> values;
+        std::deque<koopa_raw_basic_block_data_t> blocks;
+        std::deque<koopa_raw_function_data_t> funcs;
+        std::deque<std::vector<const void *>> slice_bufs;
+        std::deque<std::string> names;
+
+        koopa_raw_type_t ty_int32;
+        koopa_raw_type_t ty_unit;
+        koopa_raw_type_t ty_int32_ptr;
+
+        // construction state
+        koopa_raw_function_data_t *cur_func;
+        koopa_raw_basic_block_data_t *cur_bb;
+        std::vector<const void *> cur_bbs;
+        std::vector<const void *> cur_insts;
+        std::vector<const void *> all_funcs;
+};
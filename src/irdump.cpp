@@ -0,0 +1,187 @@
+#include <cassert>
+#include "irdump.hpp"
+
+// output of the current program
+static thread_local Emitter *out = nullptr;
+
+// dump raw program
+void DumpKoopa(const koopa_raw_program_t &program, Emitter &emitter) {
+  out = &emitter;
+  for (size_t i = 0; i < program.funcs.len; ++i) {
+    assert(program.funcs.kind == KOOPA_RSIK_FUNCTION);
+    DumpKoopa(reinterpret_cast<koopa_raw_function_t>(program.funcs.buffer[i]));
+  }
+}
+
+// dump function
+void DumpKoopa(const koopa_raw_function_t &func) {
+  *out << "fun " << func->name << "(): ";
+  dump_koopa_type(func->ty->data.function.ret);
+  *out << " {\n";
+
+  for (size_t i = 0; i < func->bbs.len; ++i) {
+    assert(func->bbs.kind == KOOPA_RSIK_BASIC_BLOCK);
+    if (i != 0) {
+      *out << "\n";
+    }
+    DumpKoopa(reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]));
+  }
+
+  *out << "}\n";
+}
+
+// dump basic block
+void DumpKoopa(const koopa_raw_basic_block_t &bb) {
+  dump_koopa_label(bb);
+  for (size_t i = 0; i < bb->insts.len; ++i) {
+    assert(bb->insts.kind == KOOPA_RSIK_VALUE);
+    DumpKoopa(reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]));
+  }
+}
+
+// dump one instruction on its own
+void DumpKoopa(const koopa_raw_value_t &value, Emitter &emitter) {
+  Emitter *outer = out;
+  out = &emitter;
+  DumpKoopa(value);
+  out = outer;
+}
+
+// dump one block label on its own
+void DumpKoopaLabel(const koopa_raw_basic_block_t &bb, Emitter &emitter) {
+  Emitter *outer = out;
+  out = &emitter;
+  dump_koopa_label(bb);
+  out = outer;
+}
+
+// dump instruction
+void DumpKoopa(const koopa_raw_value_t &value) {
+  const auto &kind = value->kind;
+  *out << "\t";
+  switch (kind.tag) {
+    case KOOPA_RVT_ALLOC:
+      *out << value->name << " = alloc ";
+      dump_koopa_type(value->ty->data.pointer.base);
+      break;
+    case KOOPA_RVT_LOAD:
+      *out << value->name << " = load ";
+      dump_koopa_operand(kind.data.load.src);
+      break;
+    case KOOPA_RVT_STORE:
+      *out << "store ";
+      dump_koopa_operand(kind.data.store.value);
+      *out << ", ";
+      dump_koopa_operand(kind.data.store.dest);
+      break;
+    case KOOPA_RVT_BINARY:
+      *out << value->name << " = " << koopa_binary_op_str(kind.data.binary.op) << " ";
+      dump_koopa_operand(kind.data.binary.lhs);
+      *out << ", ";
+      dump_koopa_operand(kind.data.binary.rhs);
+      break;
+    case KOOPA_RVT_BRANCH:
+      *out << "br ";
+      dump_koopa_operand(kind.data.branch.cond);
+      *out << ", ";
+      dump_koopa_target(kind.data.branch.true_bb, kind.data.branch.true_args);
+      *out << ", ";
+      dump_koopa_target(kind.data.branch.false_bb, kind.data.branch.false_args);
+      break;
+    case KOOPA_RVT_JUMP:
+      *out << "jump ";
+      dump_koopa_target(kind.data.jump.target, kind.data.jump.args);
+      break;
+    case KOOPA_RVT_RETURN:
+      *out << "ret";
+      if (kind.data.ret.value) {
+        *out << " ";
+        dump_koopa_operand(kind.data.ret.value);
+      }
+      break;
+    default:
+      assert(false);
+  }
+  *out << "\n";
+}
+
+// helper functions
+void dump_koopa_type(const koopa_raw_type_t &ty) {
+  switch (ty->tag) {
+    case KOOPA_RTT_INT32:
+      *out << "i32";
+      break;
+    case KOOPA_RTT_UNIT:
+      *out << "unit";
+      break;
+    case KOOPA_RTT_POINTER:
+      *out << '*';
+      dump_koopa_type(ty->data.pointer.base);
+      break;
+    default:
+      assert(false);
+  }
+}
+
+void dump_koopa_operand(const koopa_raw_value_t &value) {
+  if (value->kind.tag == KOOPA_RVT_INTEGER) {
+    *out << value->kind.data.integer.value;
+  }
+  else {
+    assert(value->name);
+    *out << value->name;
+  }
+}
+
+// block name with its args: "%bb(%0, 1)"
+void dump_koopa_target(const koopa_raw_basic_block_t &bb, const koopa_raw_slice_t &args) {
+  *out << bb->name;
+  if (args.len > 0) {
+    *out << "(";
+    for (size_t i = 0; i < args.len; ++i) {
+      *out << (i == 0 ? "" : ", ");
+      dump_koopa_operand(reinterpret_cast<koopa_raw_value_t>(args.buffer[i]));
+    }
+    *out << ")";
+  }
+}
+
+// block label with its params: "%bb(%0: i32):"
+void dump_koopa_label(const koopa_raw_basic_block_t &bb) {
+  *out << bb->name;
+  if (bb->params.len > 0) {
+    *out << "(";
+    for (size_t i = 0; i < bb->params.len; ++i) {
+      auto param = reinterpret_cast<koopa_raw_value_t>(bb->params.buffer[i]);
+      *out << (i == 0 ? "" : ", ") << param->name << ": ";
+      dump_koopa_type(param->ty);
+    }
+    *out << ")";
+  }
+  *out << ":\n";
+}
+
+const char *koopa_binary_op_str(koopa_raw_binary_op_t op) {
+  switch (op) {
+    case KOOPA_RBO_NOT_EQ: return "ne";
+    case KOOPA_RBO_EQ: return "eq";
+    case KOOPA_RBO_GT: return "gt";
+    case KOOPA_RBO_LT: return "lt";
+    case KOOPA_RBO_GE: return "ge";
+    case KOOPA_RBO_LE: return "le";
+    case KOOPA_RBO_ADD: return "add";
+    case KOOPA_RBO_SUB: return "sub";
+    case KOOPA_RBO_MUL: return "mul";
+    case KOOPA_RBO_DIV: return "div";
+    case KOOPA_RBO_MOD: return "mod";
+    case KOOPA_RBO_AND: return "and";
+    case KOOPA_RBO_OR: return "or";
+    case KOOPA_RBO_XOR: return "xor";
+    case KOOPA_RBO_SHL: return "shl";
+    case KOOPA_RBO_SHR: return "shr";
+    case KOOPA_RBO_SAR: return "sar";
+    default:
+      assert(false);
+      return "";
+  }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "koopa.h"
+#include "emitter.hpp"
+
+// koopa raw program -> koopa IR text
+void DumpKoopa(const koopa_raw_program_t &program, Emitter &emitter);
+void DumpKoopa(const koopa_raw_function_t &func);
+void DumpKoopa(const koopa_raw_basic_block_t &bb);
+void DumpKoopa(const koopa_raw_value_t &value);
+void DumpKoopa(const koopa_raw_value_t &value, Emitter &emitter); // one instruction line
+void DumpKoopaLabel(const koopa_raw_basic_block_t &bb, Emitter &emitter); // "%bb(%p: i32):" line
+
+// helper functions
+void dump_koopa_type(const koopa_raw_type_t &ty);
+void dump_koopa_operand(const koopa_raw_value_t &value);
+void dump_koopa_target(const koopa_raw_basic_block_t &bb, const koopa_raw_slice_t &args);
+void dump_koopa_label(const koopa_raw_basic_block_t &bb);
+const char *koopa_binary_op_str(koopa_raw_binary_op_t op);
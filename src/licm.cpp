@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "opt.hpp"
+#include "cfg.hpp"
+#include "stats.hpp"
+
+// Loop-invariant code motion.
+// Natural loops come from back edges (edges to a block dominating their
+// source), loops sharing a header are merged. Instructions of a loop whose
+// operands are all defined outside of it move to a preheader placed right
+// before the header, which all edges entering the loop are redirected to:
+// binaries (div/mod only by a nonzero constant, as the loop might never have
+// run them) and loads of allocs the loop does not store to. Inner loops go
+// first, so code hoisted out of them can leave the enclosing loops as well.
+// Loops without invariant code keep their shape.
+void LICM(KoopaBuilder &builder, const koopa_raw_function_t &func) {
+  remove_unreachable_blocks(builder, func);
+  koopa_cfg_t cfg;
+  BuildCFG(func, cfg);
+  ComputeDominators(cfg);
+  size_t bb_num = cfg.bbs.size();
+
+  // natural loops
+  std::vector<int> headers;
+  std::unordered_map<int, int> loop_of; // header -> loop
+  std::vector<std::vector<bool>> in_loop;
+  for (int b : cfg.rpo) {
+    for (int h : cfg.succs[b]) {
+      if (!dominates(cfg, h, b)) {
+        continue;
+      }
+      if (!loop_of.count(h)) {
+        loop_of[h] = headers.size();
+        headers.push_back(h);
+        in_loop.emplace_back(bb_num, false);
+        in_loop.back()[h] = true;
+      }
+      std::vector<bool> &body = in_loop[loop_of[h]];
+      std::vector<int> worklist = { b };
+      while (!worklist.empty()) {
+        int x = worklist.back();
+        worklist.pop_back();
+        if (body[x]) {
+          continue;
+        }
+        body[x] = true;
+        worklist.insert(worklist.end(), cfg.preds[x].begin(), cfg.preds[x].end());
+      }
+    }
+  }
+  if (headers.empty()) {
+    return;
+  }
+  std::vector<int> loop_size(headers.size());
+  std::vector<int> order(headers.size());
+  for (size_t l = 0; l < headers.size(); ++l) {
+    loop_size[l] = std::count(in_loop[l].begin(), in_loop[l].end(), true);
+    order[l] = l;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return loop_size[a] < loop_size[b];
+  });
+
+  // instructions of every block (preheaders are appended) and defining blocks
+  std::vector<koopa_raw_basic_block_t> bbs = cfg.bbs;
+  std::vector<std::vector<koopa_raw_value_t>> insts(bb_num);
+  std::unordered_map<koopa_raw_value_t, int> def_bb;
+  for (size_t b = 0; b < bb_num; ++b) {
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    for (size_t i = 0; i < bb->params.len; ++i) {
+      def_bb[reinterpret_cast<koopa_raw_value_t>(bb->params.buffer[i])] = b;
+    }
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      insts[b].push_back(inst);
+      def_bb[inst] = b;
+    }
+  }
+  std::vector<int> preheader(bb_num, -1);
+
+  int loop_num = 0;
+  int hoisted_num = 0;
+  for (int l : order) {
+    int h = headers[l];
+    std::vector<bool> &body = in_loop[l];
+    if (h == 0) {
+      // the entry has no entering edge to give a preheader
+      continue;
+    }
+
+    // blocks of the loop in dominance order, inner preheaders before their header
+    std::vector<int> blocks;
+    for (int b : cfg.rpo) {
+      if (body[b] && preheader[b] >= 0) {
+        blocks.push_back(preheader[b]);
+      }
+      if (body[b]) {
+        blocks.push_back(b);
+      }
+    }
+    std::unordered_set<koopa_raw_value_t> stored;
+    for (int b : blocks) {
+      for (koopa_raw_value_t inst : insts[b]) {
+        if (inst->kind.tag == KOOPA_RVT_STORE) {
+          stored.insert(inst->kind.data.store.dest);
+        }
+      }
+    }
+
+    // invariant instructions, operands first
+    std::unordered_set<koopa_raw_value_t> hoisted;
+    std::vector<koopa_raw_value_t> hoist_list;
+    auto outside = [&](koopa_raw_value_t v) {
+      if (v->kind.tag == KOOPA_RVT_INTEGER || hoisted.count(v)) {
+        return true;
+      }
+      auto it = def_bb.find(v);
+      return it == def_bb.end() || !body[it->second];
+    };
+    auto invariant = [&](koopa_raw_value_t inst) {
+      const auto &kind = inst->kind;
+      if (kind.tag == KOOPA_RVT_LOAD) {
+        return outside(kind.data.load.src) && !stored.count(kind.data.load.src);
+      }
+      if (kind.tag != KOOPA_RVT_BINARY || !outside(kind.data.binary.lhs) || !outside(kind.data.binary.rhs)) {
+        return false;
+      }
+      if (kind.data.binary.op == KOOPA_RBO_DIV || kind.data.binary.op == KOOPA_RBO_MOD) {
+        koopa_raw_value_t rhs = kind.data.binary.rhs;
+        return rhs->kind.tag == KOOPA_RVT_INTEGER && rhs->kind.data.integer.value != 0;
+      }
+      return true;
+    };
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (int b : blocks) {
+        for (koopa_raw_value_t inst : insts[b]) {
+          if (!hoisted.count(inst) && invariant(inst)) {
+            hoisted.insert(inst);
+            hoist_list.push_back(inst);
+            changed = true;
+          }
+        }
+      }
+    }
+    if (hoist_list.empty()) {
+      continue;
+    }
+
+    // preheader: entering edges go there, it passes their args on to the header
+    int pre = bbs.size();
+    koopa_raw_basic_block_t pre_bb = builder.new_block("%preheader", loop_num);
+    bbs.push_back(pre_bb);
+    insts.emplace_back();
+    preheader.push_back(-1);
+    preheader[h] = pre;
+    for (size_t m = 0; m < in_loop.size(); ++m) {
+      in_loop[m].push_back(m != (size_t)l && in_loop[m][h]);
+    }
+
+    // edges entering the loop
+    std::vector<koopa_raw_basic_block_t *> targets;
+    std::vector<koopa_raw_slice_t *> args;
+    for (int p : cfg.preds[h]) {
+      if (body[p]) {
+        continue;
+      }
+      auto &kind = builder.mutable_value(insts[p].back())->kind;
+      if (kind.tag == KOOPA_RVT_JUMP) {
+        targets.push_back(&kind.data.jump.target);
+        args.push_back(&kind.data.jump.args);
+        continue;
+      }
+      if (kind.data.branch.true_bb == bbs[h]) {
+        targets.push_back(&kind.data.branch.true_bb);
+        args.push_back(&kind.data.branch.true_args);
+      }
+      if (kind.data.branch.false_bb == bbs[h]) {
+        targets.push_back(&kind.data.branch.false_bb);
+        args.push_back(&kind.data.branch.false_args);
+      }
+    }
+    koopa_raw_value_t jump = builder.new_jump(bbs[h]);
+    if (targets.size() == 1) {
+      // a single entering edge hands its args to the preheader jump
+      builder.mutable_value(jump)->kind.data.jump.args = *args[0];
+      *args[0] = builder.new_slice({}, KOOPA_RSIK_VALUE);
+    }
+    else {
+      // otherwise the preheader takes the header params and forwards them
+      std::vector<const void *> params;
+      for (size_t k = 0; k < bbs[h]->params.len; ++k) {
+        params.push_back(builder.new_block_arg_ref(k));
+        def_bb[reinterpret_cast<koopa_raw_value_t>(params.back())] = pre;
+      }
+      builder.mutable_block(pre_bb)->params = builder.new_slice(params, KOOPA_RSIK_VALUE);
+      builder.mutable_value(jump)->kind.data.jump.args = builder.new_slice(params, KOOPA_RSIK_VALUE);
+    }
+    for (koopa_raw_basic_block_t *target : targets) {
+      *target = pre_bb;
+    }
+
+    // move the invariant instructions
+    for (int b : blocks) {
+      std::vector<koopa_raw_value_t> kept;
+      for (koopa_raw_value_t inst : insts[b]) {
+        if (!hoisted.count(inst)) {
+          kept.push_back(inst);
+        }
+      }
+      insts[b] = kept;
+    }
+    for (koopa_raw_value_t inst : hoist_list) {
+      insts[pre].push_back(inst);
+      def_bb[inst] = pre;
+    }
+    insts[pre].push_back(jump);
+    loop_num = loop_num + 1;
+    hoisted_num = hoisted_num + hoist_list.size();
+  }
+
+  if (loop_num > 0) {
+    // write back, preheaders right before their header
+    std::vector<const void *> func_bbs;
+    for (size_t b = 0; b < bb_num; ++b) {
+      if (preheader[b] >= 0) {
+        func_bbs.push_back(bbs[preheader[b]]);
+      }
+      func_bbs.push_back(bbs[b]);
+    }
+    for (size_t b = 0; b < bbs.size(); ++b) {
+      std::vector<const void *> items(insts[b].begin(), insts[b].end());
+      builder.mutable_block(bbs[b])->insts = builder.new_slice(items, KOOPA_RSIK_VALUE);
+    }
+    builder.mutable_function(func)->bbs = builder.new_slice(func_bbs, KOOPA_RSIK_BASIC_BLOCK);
+  }
+
+  if (CompileStats::active) {
+    CompileStats::active->count_opt("licm.loops", loop_num);
+    CompileStats::active->count_opt("licm.hoisted", hoisted_num);
+  }
+}
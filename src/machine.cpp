@@ -0,0 +1,113 @@
+#include <cstring>
+#include "machine.hpp"
+#include "stats.hpp"
+
+// print the instructions (and count them in the active stats)
+void EmitMachineCode(const std::vector<riscv_inst_t> &code, Emitter &out) {
+  CompileStats *stats = CompileStats::active;
+  for (const riscv_inst_t &inst : code) {
+    if (inst.fmt == RISCV_FMT_NOP) {
+      continue;
+    }
+    if (inst.fmt == RISCV_FMT_LABEL) {
+      out << "\n" << inst.label << ":\n";
+      continue;
+    }
+    if (stats) {
+      stats->count_riscv_inst(inst.op);
+      // every load/store of this backend addresses the stack frame
+      if (inst.fmt == RISCV_FMT_LOAD || inst.fmt == RISCV_FMT_STORE) {
+        stats->count_stack_access(inst.fmt == RISCV_FMT_STORE);
+      }
+    }
+
+    out << "\t" << inst.op;
+    switch (inst.fmt) {
+      case RISCV_FMT_R:
+        out << " " << inst.rd << ", " << inst.rs1 << ", " << inst.rs2;
+        break;
+      case RISCV_FMT_I:
+        out << " " << inst.rd << ", " << inst.rs1 << ", " << inst.imm;
+        break;
+      case RISCV_FMT_U:
+        out << " " << inst.rd << ", " << inst.rs1;
+        break;
+      case RISCV_FMT_LI:
+        out << " " << inst.rd << ", " << inst.imm;
+        break;
+      case RISCV_FMT_LOAD:
+        out << " " << inst.rd << ", " << inst.imm << "(" << inst.rs1 << ")";
+        break;
+      case RISCV_FMT_STORE:
+        out << " " << inst.rs2 << ", " << inst.imm << "(" << inst.rs1 << ")";
+        break;
+      case RISCV_FMT_BZ:
+        out << " " << inst.rs1 << ", " << inst.label;
+        break;
+      case RISCV_FMT_B:
+        out << " " << inst.rs1 << ", " << inst.rs2 << ", " << inst.label;
+        break;
+      case RISCV_FMT_J:
+        out << " " << inst.label;
+        break;
+      default:
+        break;
+    }
+    out << "\n";
+  }
+}
+
+// helper functions
+bool same_reg(const char *a, const char *b) {
+  return a && b && strcmp(a, b) == 0;
+}
+
+// inst reads reg as a source operand
+bool inst_reads(const riscv_inst_t &inst, const char *reg) {
+  switch (inst.fmt) {
+    case RISCV_FMT_R:
+    case RISCV_FMT_STORE:
+    case RISCV_FMT_B:
+      return same_reg(inst.rs1, reg) || same_reg(inst.rs2, reg);
+    case RISCV_FMT_I:
+    case RISCV_FMT_U:
+    case RISCV_FMT_LOAD:
+    case RISCV_FMT_BZ:
+      return same_reg(inst.rs1, reg);
+    default:
+      return false;
+  }
+}
+
+// inst writes reg
+bool inst_writes(const riscv_inst_t &inst, const char *reg) {
+  switch (inst.fmt) {
+    case RISCV_FMT_R:
+    case RISCV_FMT_I:
+    case RISCV_FMT_U:
+    case RISCV_FMT_LI:
+    case RISCV_FMT_LOAD:
+      return same_reg(inst.rd, reg);
+    default:
+      return false;
+  }
+}
+
+// label, branch, jump or return: the end of straight-line code
+bool is_control(const riscv_inst_t &inst) {
+  switch (inst.fmt) {
+    case RISCV_FMT_BZ:
+    case RISCV_FMT_B:
+    case RISCV_FMT_J:
+    case RISCV_FMT_RET:
+    case RISCV_FMT_LABEL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// immediate of an I-type instruction
+bool fits_imm12(int32_t imm) {
+  return imm >= -2048 && imm <= 2047;
+}
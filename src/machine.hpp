@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "emitter.hpp"
+
+// RISC-V machine instructions of one function.
+// The backend appends instructions and labels to a list instead of writing
+// text, so the list can still be rewritten (Peephole) before EmitMachineCode
+// prints it. Registers are ABI names ("t0", "sp", "x0"), compared by content.
+
+// operand formats
+enum riscv_fmt_t {
+  RISCV_FMT_R,     // op rd, rs1, rs2
+  RISCV_FMT_I,     // op rd, rs1, imm
+  RISCV_FMT_U,     // op rd, rs1 (mv, seqz, snez, neg, not)
+  RISCV_FMT_LI,    // li rd, imm
+  RISCV_FMT_LOAD,  // lw rd, imm(rs1)
+  RISCV_FMT_STORE, // sw rs2, imm(rs1)
+  RISCV_FMT_BZ,    // op rs1, label (beqz, bnez)
+  RISCV_FMT_B,     // op rs1, rs2, label (beq, bne, blt, bge)
+  RISCV_FMT_J,     // j label
+  RISCV_FMT_RET,   // ret
+  RISCV_FMT_LABEL, // label:
+  RISCV_FMT_NOP,   // deleted, not printed
+};
+
+typedef struct {
+  riscv_fmt_t fmt;
+  const char *op; // mnemonic (static string)
+  const char *rd;
+  const char *rs1;
+  const char *rs2;
+  int32_t imm;
+  std::string label; // branch/jump target or label name
+} riscv_inst_t;
+
+// print the instructions (and count them in the active stats)
+void EmitMachineCode(const std::vector<riscv_inst_t> &code, Emitter &out);
+
+// window-based peephole optimization, see peephole.cpp
+void Peephole(std::vector<riscv_inst_t> &code, const std::vector<const char *> &scratch);
+
+// helper functions
+bool same_reg(const char *a, const char *b);
+bool inst_reads(const riscv_inst_t &inst, const char *reg);
+bool inst_writes(const riscv_inst_t &inst, const char *reg);
+bool is_control(const riscv_inst_t &inst);
+bool fits_imm12(int32_t imm);
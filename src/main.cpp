@@ -1,82 +1,106 @@
-#include <cassert>
-#include <cstdio>
+#include <cstdlib>
 #include <iostream>
-#include <sstream>
-#include <fstream>
 #include <memory>
 #include <string>
 #include <string.h>
-#include "ast.hpp"
-#include "koopa.h"
-#include "visit.hpp"
+#include <thread>
+#include "cache.hpp"
+#include "driver.hpp"
+#include "rvsim.hpp"
+#include "server.hpp"
 
 using namespace std;
 
-// 声明 lexer 的输入, 以及 parser 函数
-// 为什么不引用 sysy.tab.hpp 呢? 因为首先里面没有 yyin 的定义
-// 其次, 因为这个文件不是我们自己写的, 而是被 Bison 生成出来的
-// 你的代码编辑器/IDE 很可能找不到这个文件, 然后会给你报错 (虽然编译不会出错)
-// 看起来会很烦人, 于是干脆采用这种看起来 dirty 但实际很有效的手段
-extern FILE *yyin;
-extern int yyparse(unique_ptr<BaseAST> &ast);
-
 int main(int argc, const char *argv[]) {
-  // compiler [mode] [infile] -o [outfile]
-  assert(argc == 5);
-  auto mode = argv[1];
-  auto input = argv[2];
-  auto output = argv[4];
-
-  // infile -> lexer
-  yyin = fopen(input, "r");
-  assert(yyin);
-
-  // parser -> AST
-  unique_ptr<BaseAST> ast;
-  auto ret_parser = yyparse(ast);
-  assert(!ret_parser);
-
-  // (debug) AST -> EBNF str
-  // ast->Dump();
-
-  // AST -> Koopa str
-  stringstream koopa_stream;
-  auto coutbuf = std::cout.rdbuf(koopa_stream.rdbuf());
-  ast->sym_num = 0;
-  ast->GenKoopa();
-  std::cout.rdbuf(coutbuf);
-
-  // -koopa mode
-  if (strcmp(mode, "-koopa") == 0) {
-    ofstream koopa_outfile(output);
-    koopa_outfile << koopa_stream.rdbuf();
-    koopa_outfile.close();
-
-    return 0;
+  // common options (may appear anywhere, removed from argv):
+  //   -cache [dir], -ftime-report, -ftime-trace [file], --stats=json,
+  //   -O<level>, -f<pass>, -fno-<pass>
+  compile_options_t opts;
+  unique_ptr<CompileCache> cache;
+  int n = 1;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-cache") == 0 && i + 1 < argc) {
+      cache.reset(new CompileCache(argv[++i]));
+      opts.cache = cache.get();
+      continue;
+    }
+    if (strcmp(argv[i], "--stats=json") == 0) {
+      opts.stats_json = true;
+      continue;
+    }
+    if (strcmp(argv[i], "-ftime-report") == 0) {
+      opts.time_report = true;
+      continue;
+    }
+    if (strcmp(argv[i], "-ftime-trace") == 0 && i + 1 < argc) {
+      opts.time_trace = argv[++i];
+      continue;
+    }
+    if (parse_opt_flag(argv[i], opts.opt_flags)) {
+      continue;
+    }
+    argv[n++] = argv[i];
   }
+  argc = n;
 
-  // Koopa IR string -> Koopa IR char array
-  // std::ifstream koopa_file(output);
-  // koopa_sstr << koopa_file.rdbuf();
-  std::string koopa_str = koopa_stream.str();
-  const char *koopa_chararr = koopa_str.c_str();
+  // compiler -sim [asmfile] [-pipeline key=value,...]
+  if ((argc == 3 || argc == 5) && strcmp(argv[1], "-sim") == 0) {
+    pipeline_config_t config;
+    if (argc == 5 && (strcmp(argv[3], "-pipeline") != 0 || !parse_pipeline_config(argv[4], config))) {
+      cerr << "error: bad pipeline config" << endl;
+      return 1;
+    }
+    return Simulate(argv[2], config);
+  }
 
-  // Koopa IR char array -> Koopa IR program
-  koopa_program_t program;
-  koopa_error_code_t ret_koopa = koopa_parse_from_string(koopa_chararr, &program);
-  assert(ret_koopa == KOOPA_EC_SUCCESS);
-  koopa_raw_program_builder_t builder = koopa_new_raw_program_builder();
-  koopa_raw_program_t raw = koopa_build_raw_program(builder, program);
-  koopa_delete_program(program);
+  // compiler --serve [socket]
+  if (argc == 3 && strcmp(argv[1], "--serve") == 0) {
+    return Serve(argv[2], opts);
+  }
 
-  // Koopa IR program -> RISC-V program
-  ofstream riscv_outfile(output);
-  coutbuf = std::cout.rdbuf(riscv_outfile.rdbuf());
-  Visit(raw);
-  std::cout.rdbuf(coutbuf);
+  // compiler [mode] -batch [listfile] [-j threads]
+  if (argc >= 4 && strcmp(argv[2], "-batch") == 0) {
+    auto mode = argv[1];
+    auto list = argv[3];
+    int num_threads = thread::hardware_concurrency();
+    if (argc == 6 && strcmp(argv[4], "-j") == 0) {
+      num_threads = atoi(argv[5]);
+    }
+    else if (argc != 4) {
+      cerr << "usage: compiler [mode] -batch [listfile] [-j threads]" << endl;
+      return 1;
+    }
+    if (num_threads < 1) {
+      num_threads = 1;
+    }
+    return CompileBatch(mode, list, num_threads, opts) == 0 ? 0 : 1;
+  }
 
-  // release memory of raw program builder
-  koopa_delete_raw_program_builder(builder);
+  // compiler [mode] [infile] -o [outfile]
+  if (argc != 5 || strcmp(argv[3], "-o") != 0) {
+    cerr << "usage: compiler [mode] [infile] -o [outfile]" << endl;
+    return 1;
+  }
+  auto mode = argv[1];
+  auto input = argv[2];
+  auto output = argv[4];
 
+  // infile -> lexer -> parser -> Koopa IR -> outfile
+  string err_msg;
+  TimeReport report;
+  CompileStats stats;
+  bool timed = opts.time_report || opts.time_trace;
+  if (!CompileFile(mode, input, output, opts, err_msg, timed ? &report : nullptr,
+    opts.stats_json ? &stats : nullptr)) {
+    cerr << err_msg << endl;
+    return 1;
+  }
+  if (opts.stats_json) {
+    stats.write_json(cout, input);
+    cout << endl;
+  }
+  if (timed && !ReportTimes(opts, { input }, { &report })) {
+    return 1;
+  }
   return 0;
 }
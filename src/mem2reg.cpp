@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "opt.hpp"
+#include "cfg.hpp"
+#include "stats.hpp"
+
+// Promote allocs to SSA values (Cytron et al.).
+// An "alloc i32" that is only loaded from and stored to gets a block
+// parameter in every block of the iterated dominance frontier of its stores.
+// A walk over the dominator tree then replaces each load by the value
+// reaching it, drops the stores and the alloc, and passes the reaching
+// values as block args on every edge. Parameters whose incoming args are
+// all the same value, or that are never used, are removed again.
+void Mem2Reg(KoopaBuilder &builder, const koopa_raw_function_t &func) {
+  remove_unreachable_blocks(builder, func);
+  koopa_cfg_t cfg;
+  BuildCFG(func, cfg);
+  ComputeDominators(cfg);
+  size_t bb_num = cfg.bbs.size();
+  if (bb_num == 0) {
+    return;
+  }
+
+  // promotable allocs: i32 slots never used other than by load/store address
+  std::unordered_map<koopa_raw_value_t, int> alloc_id;
+  std::vector<koopa_raw_value_t> allocs;
+  for (koopa_raw_basic_block_t bb : cfg.bbs) {
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      if (inst->kind.tag == KOOPA_RVT_ALLOC && inst->ty->data.pointer.base->tag == KOOPA_RTT_INT32) {
+        alloc_id[inst] = allocs.size();
+        allocs.push_back(inst);
+      }
+    }
+  }
+  std::vector<bool> escaped(allocs.size(), false);
+  auto mark_escaped = [&](koopa_raw_value_t &opd) {
+    auto it = alloc_id.find(opd);
+    if (it != alloc_id.end()) {
+      escaped[it->second] = true;
+    }
+  };
+  for (koopa_raw_basic_block_t bb : cfg.bbs) {
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      if (inst->kind.tag == KOOPA_RVT_LOAD) {
+        continue;
+      }
+      if (inst->kind.tag == KOOPA_RVT_STORE) {
+        mark_escaped(builder.mutable_value(inst)->kind.data.store.value);
+        continue;
+      }
+      for_each_operand(builder, inst, mark_escaped);
+    }
+  }
+  auto promoted = [&](koopa_raw_value_t ptr) {
+    auto it = alloc_id.find(ptr);
+    return it != alloc_id.end() && !escaped[it->second] ? it->second : -1;
+  };
+
+  // blocks storing to each alloc
+  std::vector<std::vector<int>> def_bbs(allocs.size());
+  for (size_t b = 0; b < bb_num; ++b) {
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      int a = inst->kind.tag == KOOPA_RVT_STORE ? promoted(inst->kind.data.store.dest) : -1;
+      if (a >= 0 && (def_bbs[a].empty() || def_bbs[a].back() != (int)b)) {
+        def_bbs[a].push_back(b);
+      }
+    }
+  }
+
+  // block parameters on the iterated dominance frontier of the stores
+  std::vector<std::vector<int>> df;
+  ComputeDominanceFrontiers(cfg, df);
+  std::vector<std::vector<int>> param_allocs(bb_num); // block -> alloc of each param
+  std::vector<int> placed(bb_num, -1);
+  std::vector<int> queued(bb_num, -1);
+  int promoted_num = 0;
+  for (size_t a = 0; a < allocs.size(); ++a) {
+    if (escaped[a]) {
+      continue;
+    }
+    promoted_num = promoted_num + 1;
+    std::vector<int> worklist = def_bbs[a];
+    for (int b : worklist) {
+      queued[b] = a;
+    }
+    while (!worklist.empty()) {
+      int b = worklist.back();
+      worklist.pop_back();
+      for (int d : df[b]) {
+        if (placed[d] == (int)a || d == 0) {
+          continue;
+        }
+        placed[d] = a;
+        param_allocs[d].push_back(a);
+        if (queued[d] != (int)a) {
+          queued[d] = a;
+          worklist.push_back(d);
+        }
+      }
+    }
+  }
+  if (promoted_num == 0) {
+    return;
+  }
+
+  std::vector<std::vector<koopa_raw_value_t>> params(bb_num);
+  for (size_t b = 0; b < bb_num; ++b) {
+    for (size_t k = 0; k < param_allocs[b].size(); ++k) {
+      params[b].push_back(builder.new_block_arg_ref(k));
+    }
+  }
+
+  // rename along the dominator tree; cur holds the value reaching the
+  // current point for every alloc, undo restores it when leaving a subtree
+  std::unordered_map<koopa_raw_value_t, koopa_raw_value_t> repl; // removed load -> value
+  auto resolve = [&](koopa_raw_value_t v) {
+    auto it = repl.find(v);
+    while (it != repl.end()) {
+      v = it->second;
+      it = repl.find(v);
+    }
+    return v;
+  };
+  koopa_raw_value_t undef = builder.new_integer(0);
+  std::vector<koopa_raw_value_t> cur(allocs.size(), undef);
+  std::vector<std::pair<int, koopa_raw_value_t>> undo;
+  auto set_cur = [&](int a, koopa_raw_value_t v) {
+    undo.emplace_back(a, cur[a]);
+    cur[a] = v;
+  };
+  auto args_for = [&](koopa_raw_basic_block_t target) {
+    int t = cfg.bb_id.at(target);
+    std::vector<const void *> args;
+    for (int a : param_allocs[t]) {
+      args.push_back(cur[a]);
+    }
+    return builder.new_slice(args, KOOPA_RSIK_VALUE);
+  };
+
+  std::vector<std::pair<int, size_t>> stack; // (block, undo mark), SIZE_MAX before entering
+  stack.emplace_back(0, SIZE_MAX);
+  while (!stack.empty()) {
+    int b = stack.back().first;
+    if (stack.back().second != SIZE_MAX) {
+      // leave the subtree of b
+      size_t mark = stack.back().second;
+      while (undo.size() > mark) {
+        cur[undo.back().first] = undo.back().second;
+        undo.pop_back();
+      }
+      stack.pop_back();
+      continue;
+    }
+    stack.back().second = undo.size();
+
+    for (size_t k = 0; k < param_allocs[b].size(); ++k) {
+      set_cur(param_allocs[b][k], params[b][k]);
+    }
+
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    std::vector<const void *> insts;
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      const auto &kind = inst->kind;
+      if (kind.tag == KOOPA_RVT_ALLOC && promoted(inst) >= 0) {
+        continue;
+      }
+      if (kind.tag == KOOPA_RVT_LOAD && promoted(kind.data.load.src) >= 0) {
+        repl[inst] = cur[promoted(kind.data.load.src)];
+        continue;
+      }
+      if (kind.tag == KOOPA_RVT_STORE && promoted(kind.data.store.dest) >= 0) {
+        set_cur(promoted(kind.data.store.dest), resolve(kind.data.store.value));
+        continue;
+      }
+      for_each_operand(builder, inst, [&](koopa_raw_value_t &opd) {
+        opd = resolve(opd);
+      });
+      if (kind.tag == KOOPA_RVT_BRANCH) {
+        auto &branch = builder.mutable_value(inst)->kind.data.branch;
+        branch.true_args = args_for(branch.true_bb);
+        branch.false_args = args_for(branch.false_bb);
+      }
+      else if (kind.tag == KOOPA_RVT_JUMP) {
+        auto &jump = builder.mutable_value(inst)->kind.data.jump;
+        jump.args = args_for(jump.target);
+      }
+      insts.push_back(inst);
+    }
+    builder.mutable_block(bb)->insts = builder.new_slice(insts, KOOPA_RSIK_VALUE);
+
+    for (auto it = cfg.dom_children[b].rbegin(); it != cfg.dom_children[b].rend(); ++it) {
+      stack.emplace_back(*it, SIZE_MAX);
+    }
+  }
+
+  // drop parameters that are trivial (one incoming value besides themselves)
+  // or dead (only passed on to dead parameters), until nothing changes
+  std::vector<std::vector<bool>> keep(bb_num);
+  for (size_t b = 0; b < bb_num; ++b) {
+    keep[b].assign(params[b].size(), true);
+  }
+  // args passed to parameter k of block b from each predecessor
+  auto incoming = [&](int b, size_t k, std::vector<koopa_raw_value_t> &args) {
+    args.clear();
+    for (int p : cfg.preds[b]) {
+      koopa_raw_value_t term = block_terminator(cfg.bbs[p]);
+      const auto &kind = term->kind;
+      const koopa_raw_slice_t *slice = nullptr;
+      if (kind.tag == KOOPA_RVT_JUMP) {
+        slice = &kind.data.jump.args;
+      }
+      else if (kind.data.branch.true_bb == cfg.bbs[b]) {
+        slice = &kind.data.branch.true_args;
+      }
+      else {
+        slice = &kind.data.branch.false_args;
+      }
+      args.push_back(resolve(reinterpret_cast<koopa_raw_value_t>(slice->buffer[k])));
+    }
+  };
+
+  std::vector<koopa_raw_value_t> args;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t b = 0; b < bb_num; ++b) {
+      for (size_t k = 0; k < params[b].size(); ++k) {
+        if (!keep[b][k]) {
+          continue;
+        }
+        incoming(b, k, args);
+        koopa_raw_value_t same = nullptr;
+        bool trivial = true;
+        for (koopa_raw_value_t arg : args) {
+          if (arg == params[b][k] || (same && same_value(arg, same))) {
+            continue;
+          }
+          if (same) {
+            trivial = false;
+            break;
+          }
+          same = arg;
+        }
+        if (trivial) {
+          repl[params[b][k]] = same ? same : undef;
+          keep[b][k] = false;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  // live parameters: used by a non-arg operand, or passed to a live parameter
+  std::unordered_map<koopa_raw_value_t, std::pair<int, int>> param_pos;
+  for (size_t b = 0; b < bb_num; ++b) {
+    for (size_t k = 0; k < params[b].size(); ++k) {
+      if (keep[b][k]) {
+        param_pos[params[b][k]] = std::make_pair(b, k);
+      }
+    }
+  }
+  std::vector<std::vector<bool>> live(bb_num);
+  for (size_t b = 0; b < bb_num; ++b) {
+    live[b].assign(params[b].size(), false);
+  }
+  std::vector<std::pair<int, int>> worklist;
+  auto mark_live = [&](koopa_raw_value_t v) {
+    auto it = param_pos.find(resolve(v));
+    if (it != param_pos.end() && !live[it->second.first][it->second.second]) {
+      live[it->second.first][it->second.second] = true;
+      worklist.push_back(it->second);
+    }
+  };
+  for (koopa_raw_basic_block_t bb : cfg.bbs) {
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      const auto &kind = inst->kind;
+      if (kind.tag == KOOPA_RVT_JUMP) {
+        continue;
+      }
+      if (kind.tag == KOOPA_RVT_BRANCH) {
+        mark_live(kind.data.branch.cond);
+        continue;
+      }
+      for_each_operand(builder, inst, [&](koopa_raw_value_t &opd) {
+        mark_live(opd);
+      });
+    }
+  }
+  while (!worklist.empty()) {
+    auto pos = worklist.back();
+    worklist.pop_back();
+    incoming(pos.first, pos.second, args);
+    for (koopa_raw_value_t arg : args) {
+      mark_live(arg);
+    }
+  }
+
+  // rewrite: resolve all operands, keep live parameters and their args
+  for (koopa_raw_basic_block_t bb : cfg.bbs) {
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      for_each_operand(builder, inst, [&](koopa_raw_value_t &opd) {
+        opd = resolve(opd);
+      });
+    }
+  }
+  for (size_t b = 0; b < bb_num; ++b) {
+    std::vector<const void *> all(params[b].begin(), params[b].end());
+    builder.mutable_block(cfg.bbs[b])->params = builder.new_slice(all, KOOPA_RSIK_VALUE);
+  }
+  int param_num = 0;
+  remove_block_params(builder, func, [&](koopa_raw_value_t param) {
+    auto it = param_pos.find(param);
+    bool kept = it != param_pos.end() && live[it->second.first][it->second.second];
+    param_num = param_num + kept;
+    return kept;
+  });
+
+  if (CompileStats::active) {
+    CompileStats::active->count_opt("mem2reg.promoted_allocs", promoted_num);
+    CompileStats::active->count_opt("mem2reg.block_params", param_num);
+  }
+}
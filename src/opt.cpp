@@ -0,0 +1,220 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include "opt.hpp"
+#include "cfg.hpp"
+#include "timer.hpp"
+
+// pass table, in pipeline order
+typedef struct {
+  const char *name;
+  int level; // lowest -O level enabling the pass
+  void (*run)(KoopaBuilder &builder, const koopa_raw_function_t &func);
+} opt_pass_t;
+
+static const opt_pass_t opt_passes[] = {
+  { "mem2reg", 1, Mem2Reg },
+  { "sccp", 1, SCCP },
+  { "gvn", 1, GVN },
+  { "licm", 1, LICM },
+};
+
+#define OPT_PASS_NUM (sizeof(opt_passes) / sizeof(opt_passes[0]))
+
+// canonical flags <-> enabled pass table
+static std::string join_passes(const bool *enabled) {
+  std::string flags;
+  for (size_t i = 0; i < OPT_PASS_NUM; ++i) {
+    if (enabled[i]) {
+      flags += flags.empty() ? "" : ",";
+      flags += opt_passes[i].name;
+    }
+  }
+  return flags;
+}
+
+static bool pass_enabled(const std::string &opt_flags, const char *name) {
+  size_t len = strlen(name);
+  for (size_t pos = 0; pos <= opt_flags.size();) {
+    size_t end = opt_flags.find(',', pos);
+    if (end == std::string::npos) {
+      end = opt_flags.size();
+    }
+    if (end - pos == len && opt_flags.compare(pos, len, name) == 0) {
+      return true;
+    }
+    pos = end + 1;
+  }
+  return false;
+}
+
+// -O<level> -> canonical flags
+std::string opt_level_flags(int level) {
+  bool enabled[OPT_PASS_NUM];
+  for (size_t i = 0; i < OPT_PASS_NUM; ++i) {
+    enabled[i] = level >= opt_passes[i].level;
+  }
+  return join_passes(enabled);
+}
+
+// -O0..-O3, -f<pass>, -fno-<pass>
+bool parse_opt_flag(const char *arg, std::string &opt_flags) {
+  if (strncmp(arg, "-O", 2) == 0 && arg[2] >= '0' && arg[2] <= '3' && arg[3] == '\0') {
+    opt_flags = opt_level_flags(arg[2] - '0');
+    return true;
+  }
+  if (strncmp(arg, "-f", 2) != 0) {
+    return false;
+  }
+
+  bool on = strncmp(arg, "-fno-", 5) != 0;
+  const char *name = on ? arg + 2 : arg + 5;
+  bool enabled[OPT_PASS_NUM];
+  bool found = false;
+  for (size_t i = 0; i < OPT_PASS_NUM; ++i) {
+    enabled[i] = pass_enabled(opt_flags, opt_passes[i].name);
+    if (strcmp(name, opt_passes[i].name) == 0) {
+      enabled[i] = on;
+      found = true;
+    }
+  }
+  if (found) {
+    opt_flags = join_passes(enabled);
+  }
+  return found;
+}
+
+// run the enabled passes on every function of the program
+void RunPasses(const std::string &opt_flags, KoopaBuilder &builder, const koopa_raw_program_t &program) {
+  for (size_t i = 0; i < OPT_PASS_NUM; ++i) {
+    if (!pass_enabled(opt_flags, opt_passes[i].name)) {
+      continue;
+    }
+    TimeScope scope(opt_passes[i].name);
+    for (size_t j = 0; j < program.funcs.len; ++j) {
+      auto func = reinterpret_cast<koopa_raw_function_t>(program.funcs.buffer[j]);
+      opt_passes[i].run(builder, func);
+    }
+  }
+}
+
+// helper functions
+// drop the blocks that cannot be reached from the entry
+void remove_unreachable_blocks(KoopaBuilder &builder, const koopa_raw_function_t &func) {
+  koopa_cfg_t cfg;
+  BuildCFG(func, cfg);
+  if (cfg.rpo.size() == cfg.bbs.size()) {
+    return;
+  }
+  std::vector<const void *> kept;
+  for (size_t i = 0; i < cfg.bbs.size(); ++i) {
+    if (cfg.rpo_index[i] >= 0) {
+      kept.push_back(cfg.bbs[i]);
+    }
+  }
+  builder.mutable_function(func)->bbs = builder.new_slice(kept, KOOPA_RSIK_BASIC_BLOCK);
+}
+
+// drop the block params keep() rejects, and the args passed to them on every edge
+void remove_block_params(KoopaBuilder &builder, const koopa_raw_function_t &func,
+  const std::function<bool(koopa_raw_value_t)> &keep) {
+  // block -> kept mask of its params
+  std::unordered_map<koopa_raw_basic_block_t, std::vector<bool>> masks;
+  for (size_t i = 0; i < func->bbs.len; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]);
+    if (bb->params.len == 0) {
+      continue;
+    }
+    std::vector<bool> &mask = masks[bb];
+    std::vector<const void *> kept;
+    for (size_t k = 0; k < bb->params.len; ++k) {
+      auto param = reinterpret_cast<koopa_raw_value_t>(bb->params.buffer[k]);
+      mask.push_back(keep(param));
+      if (mask.back()) {
+        builder.mutable_value(param)->kind.data.block_arg_ref.index = kept.size();
+        kept.push_back(param);
+      }
+    }
+    builder.mutable_block(bb)->params = builder.new_slice(kept, KOOPA_RSIK_VALUE);
+  }
+
+  auto filter_args = [&](koopa_raw_basic_block_t target, koopa_raw_slice_t &args) {
+    auto it = masks.find(target);
+    if (it == masks.end()) {
+      return;
+    }
+    std::vector<const void *> kept;
+    for (size_t k = 0; k < args.len; ++k) {
+      if (it->second[k]) {
+        kept.push_back(args.buffer[k]);
+      }
+    }
+    args = builder.new_slice(kept, KOOPA_RSIK_VALUE);
+  };
+  for (size_t i = 0; i < func->bbs.len; ++i) {
+    auto bb = reinterpret_cast<koopa_raw_basic_block_t>(func->bbs.buffer[i]);
+    koopa_raw_value_t term = block_terminator(bb);
+    if (!term) {
+      continue;
+    }
+    auto &kind = builder.mutable_value(term)->kind;
+    if (kind.tag == KOOPA_RVT_BRANCH) {
+      filter_args(kind.data.branch.true_bb, kind.data.branch.true_args);
+      filter_args(kind.data.branch.false_bb, kind.data.branch.false_args);
+    }
+    else if (kind.tag == KOOPA_RVT_JUMP) {
+      filter_args(kind.data.jump.target, kind.data.jump.args);
+    }
+  }
+}
+
+// call fn on every value operand of inst (block args included), fn may replace it
+void for_each_operand(KoopaBuilder &builder, koopa_raw_value_t inst,
+  const std::function<void(koopa_raw_value_t &)> &fn) {
+  auto &kind = builder.mutable_value(inst)->kind;
+  auto each_arg = [&](koopa_raw_slice_t &args) {
+    for (size_t i = 0; i < args.len; ++i) {
+      auto arg = reinterpret_cast<koopa_raw_value_t>(args.buffer[i]);
+      fn(arg);
+      args.buffer[i] = arg;
+    }
+  };
+  switch (kind.tag) {
+    case KOOPA_RVT_LOAD:
+      fn(kind.data.load.src);
+      break;
+    case KOOPA_RVT_STORE:
+      fn(kind.data.store.value);
+      fn(kind.data.store.dest);
+      break;
+    case KOOPA_RVT_BINARY:
+      fn(kind.data.binary.lhs);
+      fn(kind.data.binary.rhs);
+      break;
+    case KOOPA_RVT_BRANCH:
+      fn(kind.data.branch.cond);
+      each_arg(kind.data.branch.true_args);
+      each_arg(kind.data.branch.false_args);
+      break;
+    case KOOPA_RVT_JUMP:
+      each_arg(kind.data.jump.args);
+      break;
+    case KOOPA_RVT_RETURN:
+      if (kind.data.ret.value) {
+        fn(kind.data.ret.value);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// same value, or integer constants with the same value
+bool same_value(koopa_raw_value_t a, koopa_raw_value_t b) {
+  if (a == b) {
+    return true;
+  }
+  return a->kind.tag == KOOPA_RVT_INTEGER && b->kind.tag == KOOPA_RVT_INTEGER &&
+    a->kind.data.integer.value == b->kind.data.integer.value;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "koopa.h"
+#include "irbuilder.hpp"
+
+// Koopa IR optimization passes.
+// The passes rewrite the raw program built by GenKoopa in place, before it is
+// dumped, interpreted or lowered to RISC-V. Values, blocks and slices they
+// create come from the KoopaBuilder that owns the program.
+// Passes are selected by name: -O1 (the default) enables all of them, -O0
+// none, and -f<pass>/-fno-<pass> toggle one. The canonical flags (enabled
+// passes in pipeline order, comma separated) are part of the cache key.
+
+// -O<level> -> canonical flags
+std::string opt_level_flags(int level);
+
+// apply one command line option to the canonical flags,
+// false if arg is not an optimization option
+bool parse_opt_flag(const char *arg, std::string &opt_flags);
+
+// run the enabled passes on every function of the program
+void RunPasses(const std::string &opt_flags, KoopaBuilder &builder, const koopa_raw_program_t &program);
+
+// passes
+void Mem2Reg(KoopaBuilder &builder, const koopa_raw_function_t &func);
+void SCCP(KoopaBuilder &builder, const koopa_raw_function_t &func);
+void GVN(KoopaBuilder &builder, const koopa_raw_function_t &func);
+void LICM(KoopaBuilder &builder, const koopa_raw_function_t &func);
+
+// helper functions
+void remove_unreachable_blocks(KoopaBuilder &builder, const koopa_raw_function_t &func);
+void remove_block_params(KoopaBuilder &builder, const koopa_raw_function_t &func,
+  const std::function<bool(koopa_raw_value_t)> &keep);
+void for_each_operand(KoopaBuilder &builder, koopa_raw_value_t inst,
+  const std::function<void(koopa_raw_value_t &)> &fn);
+bool same_value(koopa_raw_value_t a, koopa_raw_value_t b);
@@ -0,0 +1,325 @@
+#include <cstring>
+#include <string>
+#include "machine.hpp"
+#include "stats.hpp"
+
+// Window-based peephole optimization over the machine instructions of one
+// function, before they are printed.
+// Every pattern of the table is tried at every instruction; a pattern looks
+// at the window starting there (at most PEEPHOLE_WINDOW instructions, never
+// past the end of straight-line code) and rewrites it in place, deleted
+// instructions become RISCV_FMT_NOP. Sweeps repeat until nothing changes, so
+// the result of one pattern is seen by the others.
+// New patterns are one function and one table entry.
+
+#define PEEPHOLE_WINDOW 8
+
+typedef struct {
+  const char *name; // stats counter "peephole.<name>"
+  bool (*rewrite)(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &scratch);
+} peephole_pattern_t;
+
+// next instruction after i that is not deleted (code.size() if none)
+static size_t next_inst(const std::vector<riscv_inst_t> &code, size_t i) {
+  do {
+    i = i + 1;
+  } while (i < code.size() && code[i].fmt == RISCV_FMT_NOP);
+  return i;
+}
+
+static void delete_inst(riscv_inst_t &inst) {
+  inst.fmt = RISCV_FMT_NOP;
+}
+
+static void make_move(riscv_inst_t &inst, const char *rd, const char *rs) {
+  if (same_reg(rs, "x0")) {
+    inst.fmt = RISCV_FMT_LI;
+    inst.op = "li";
+    inst.imm = 0;
+  }
+  else {
+    inst.fmt = RISCV_FMT_U;
+    inst.op = "mv";
+    inst.rs1 = rs;
+  }
+  inst.rd = rd;
+}
+
+// reg is not read after code[i] before being written; scratch registers are
+// also dead at the end of straight-line code, other registers are not
+static bool dead_after(const std::vector<riscv_inst_t> &code, size_t i, const char *reg,
+  const std::vector<const char *> &scratch) {
+  for (size_t j = next_inst(code, i); j < code.size(); j = next_inst(code, j)) {
+    if (inst_reads(code[j], reg)) {
+      return false;
+    }
+    if (inst_writes(code[j], reg)) {
+      return true;
+    }
+    if (is_control(code[j])) {
+      for (const char *s : scratch) {
+        if (same_reg(s, reg)) {
+          return true;
+        }
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+// patterns
+// sw/lw rA, off(sp) leaves rA in the slot: later loads of it become moves
+// (or go away when they load rA again) and stores of rA to it go away, until
+// rA or the slot changes
+static bool forward_slot(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &) {
+  const riscv_inst_t &inst = code[i];
+  if (inst.fmt != RISCV_FMT_STORE && inst.fmt != RISCV_FMT_LOAD) {
+    return false;
+  }
+  const char *reg = inst.fmt == RISCV_FMT_STORE ? inst.rs2 : inst.rd;
+  const char *base = inst.rs1;
+  if (same_reg(reg, base)) {
+    return false;
+  }
+
+  bool changed = false;
+  size_t j = next_inst(code, i);
+  for (int n = 1; n < PEEPHOLE_WINDOW && j < code.size() && !is_control(code[j]); ++n, j = next_inst(code, j)) {
+    riscv_inst_t &cur = code[j];
+    bool same_slot = (cur.fmt == RISCV_FMT_LOAD || cur.fmt == RISCV_FMT_STORE) &&
+      same_reg(cur.rs1, base) && cur.imm == inst.imm;
+    if (same_slot && cur.fmt == RISCV_FMT_LOAD) {
+      if (same_reg(cur.rd, reg)) {
+        delete_inst(cur);
+      }
+      else {
+        make_move(cur, cur.rd, reg);
+      }
+      changed = true;
+    }
+    else if (same_slot && same_reg(cur.rs2, reg)) {
+      delete_inst(cur);
+      changed = true;
+    }
+    else if (same_slot) {
+      break;
+    }
+    if (inst_writes(cur, reg) || inst_writes(cur, base)) {
+      break;
+    }
+  }
+  return changed;
+}
+
+// register-register ops with an immediate form
+typedef struct {
+  const char *op;
+  const char *imm_op;
+  bool commutative;
+  bool shift; // immediate is a shift amount
+} imm_form_t;
+
+static const imm_form_t imm_forms[] = {
+  { "add", "addi", true, false },
+  { "and", "andi", true, false },
+  { "or", "ori", true, false },
+  { "xor", "xori", true, false },
+  { "slt", "slti", false, false },
+  { "sltu", "sltiu", false, false },
+  { "sll", "slli", false, true },
+  { "srl", "srli", false, true },
+  { "sra", "srai", false, true },
+};
+
+// li rS, imm; op rd, rs, rS -> opi rd, rs, imm (sub: addi with -imm) and
+// li rS, imm; mv rd, rS -> li rd, imm, if rS is dead afterwards
+static bool fold_li(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &scratch) {
+  const riscv_inst_t &li = code[i];
+  size_t j = next_inst(code, i);
+  if (li.fmt != RISCV_FMT_LI || j == code.size()) {
+    return false;
+  }
+  riscv_inst_t &use = code[j];
+  if (!inst_reads(use, li.rd) || (!inst_writes(use, li.rd) && !dead_after(code, j, li.rd, scratch))) {
+    return false;
+  }
+
+  if (use.fmt == RISCV_FMT_U && strcmp(use.op, "mv") == 0) {
+    use.fmt = RISCV_FMT_LI;
+    use.op = "li";
+    use.imm = li.imm;
+    delete_inst(code[i]);
+    return true;
+  }
+  if (use.fmt != RISCV_FMT_R || same_reg(use.rs1, use.rs2)) {
+    return false;
+  }
+  const char *rs = same_reg(use.rs2, li.rd) ? use.rs1 : use.rs2;
+  bool swapped = same_reg(use.rs1, li.rd);
+  int32_t imm = li.imm;
+  const char *imm_op = nullptr;
+  if (strcmp(use.op, "sub") == 0 && !swapped && imm != INT32_MIN) {
+    imm_op = "addi";
+    imm = -imm;
+  }
+  for (const imm_form_t &form : imm_forms) {
+    if (strcmp(use.op, form.op) == 0 && (!swapped || form.commutative)) {
+      imm_op = form.imm_op;
+      if (form.shift) {
+        imm = imm & 31;
+      }
+    }
+  }
+  if (!imm_op || !fits_imm12(imm)) {
+    return false;
+  }
+  use.fmt = RISCV_FMT_I;
+  use.op = imm_op;
+  use.rs1 = rs;
+  use.rs2 = nullptr;
+  use.imm = imm;
+  delete_inst(code[i]);
+  return true;
+}
+
+// ops with x0 or 0 that only copy: add/sub/or/xor rd, rs, x0 and
+// addi/ori/xori/slli/srli/srai rd, rs, 0 -> mv rd, rs
+static bool fold_identity(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &) {
+  riscv_inst_t &inst = code[i];
+  static const char *const r_ops[] = { "add", "sub", "or", "xor" };
+  static const char *const i_ops[] = { "addi", "ori", "xori", "slli", "srli", "srai" };
+  if (inst.fmt == RISCV_FMT_R && same_reg(inst.rs2, "x0")) {
+    for (const char *op : r_ops) {
+      if (strcmp(inst.op, op) == 0) {
+        make_move(inst, inst.rd, inst.rs1);
+        return true;
+      }
+    }
+  }
+  if (inst.fmt == RISCV_FMT_R && same_reg(inst.rs1, "x0") && strcmp(inst.op, "sub") != 0) {
+    for (const char *op : r_ops) {
+      if (strcmp(inst.op, op) == 0) {
+        make_move(inst, inst.rd, inst.rs2);
+        return true;
+      }
+    }
+  }
+  if (inst.fmt == RISCV_FMT_I && inst.imm == 0) {
+    for (const char *op : i_ops) {
+      if (strcmp(inst.op, op) == 0) {
+        make_move(inst, inst.rd, inst.rs1);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// mv rA, rA
+static bool drop_self_move(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &) {
+  riscv_inst_t &inst = code[i];
+  if (inst.fmt == RISCV_FMT_U && strcmp(inst.op, "mv") == 0 && same_reg(inst.rd, inst.rs1)) {
+    delete_inst(inst);
+    return true;
+  }
+  return false;
+}
+
+// j L / branch to L right before L:
+static bool drop_jump_to_next(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &) {
+  riscv_inst_t &inst = code[i];
+  if (inst.fmt != RISCV_FMT_J && inst.fmt != RISCV_FMT_BZ && inst.fmt != RISCV_FMT_B) {
+    return false;
+  }
+  size_t j = next_inst(code, i);
+  if (j < code.size() && code[j].fmt == RISCV_FMT_LABEL && code[j].label == inst.label) {
+    delete_inst(inst);
+    return true;
+  }
+  return false;
+}
+
+// branch with the opposite condition
+static const char *inverse_branch(const char *op) {
+  static const char *const pairs[][2] = {
+    { "beqz", "bnez" }, { "beq", "bne" }, { "blt", "bge" }, { "bltu", "bgeu" },
+  };
+  for (const auto &pair : pairs) {
+    if (strcmp(op, pair[0]) == 0) {
+      return pair[1];
+    }
+    if (strcmp(op, pair[1]) == 0) {
+      return pair[0];
+    }
+  }
+  return nullptr;
+}
+
+// b L1; j L2; L1: -> !b L2; L1:
+static bool invert_branch_over_jump(std::vector<riscv_inst_t> &code, size_t i, const std::vector<const char *> &) {
+  riscv_inst_t &branch = code[i];
+  if (branch.fmt != RISCV_FMT_BZ && branch.fmt != RISCV_FMT_B) {
+    return false;
+  }
+  size_t j = next_inst(code, i);
+  size_t k = j < code.size() ? next_inst(code, j) : j;
+  if (k >= code.size() || code[j].fmt != RISCV_FMT_J || code[k].fmt != RISCV_FMT_LABEL ||
+    code[k].label != branch.label) {
+    return false;
+  }
+  const char *op = inverse_branch(branch.op);
+  if (!op) {
+    return false;
+  }
+  branch.op = op;
+  branch.label = code[j].label;
+  delete_inst(code[j]);
+  return true;
+}
+
+static const peephole_pattern_t peephole_patterns[] = {
+  { "forward_slot", forward_slot },
+  { "fold_li", fold_li },
+  { "fold_identity", fold_identity },
+  { "drop_self_move", drop_self_move },
+  { "drop_jump_to_next", drop_jump_to_next },
+  { "invert_branch_over_jump", invert_branch_over_jump },
+};
+
+#define PEEPHOLE_PATTERN_NUM (sizeof(peephole_patterns) / sizeof(peephole_patterns[0]))
+
+// scratch: registers never live across labels, branches and jumps
+void Peephole(std::vector<riscv_inst_t> &code, const std::vector<const char *> &scratch) {
+  long counts[PEEPHOLE_PATTERN_NUM] = {};
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < code.size(); ++i) {
+      for (size_t p = 0; p < PEEPHOLE_PATTERN_NUM && code[i].fmt != RISCV_FMT_NOP; ++p) {
+        if (peephole_patterns[p].rewrite(code, i, scratch)) {
+          counts[p] = counts[p] + 1;
+          changed = true;
+        }
+      }
+    }
+
+    // drop the deleted instructions
+    size_t kept = 0;
+    for (size_t i = 0; i < code.size(); ++i) {
+      if (code[i].fmt != RISCV_FMT_NOP) {
+        if (kept != i) {
+          code[kept] = std::move(code[i]);
+        }
+        kept = kept + 1;
+      }
+    }
+    code.resize(kept);
+  }
+
+  if (CompileStats::active) {
+    for (size_t p = 0; p < PEEPHOLE_PATTERN_NUM; ++p) {
+      CompileStats::active->count_opt((std::string("peephole.") + peephole_patterns[p].name).c_str(), counts[p]);
+    }
+  }
+}
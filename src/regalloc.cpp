@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include "regalloc.hpp"
+
+// t5/t6 are left out: the backend keeps them as scratch registers for
+// immediates and spilled values
+const char *const
+riscv_reg_lst[RISCV_REG_NUM] = {"t0", "t1", "t2", "t3", "t4",
+  "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+  "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11"};
+
+// first callee-saved register in riscv_reg_lst
+#define CALLEE_SAVED_BEGIN 13
+
+// live intervals of all values with a result, sorted by start
+void ComputeLiveIntervals(const flat_function_t &flat, std::vector<live_interval_t> &intervals) {
+  size_t n = flat.insts.size();
+  std::vector<int> start(n, -1);
+  std::vector<int> end(n, -1);
+
+  // intervals of values used inside their own block come from def and uses;
+  // values used in other blocks get a dense index for block liveness
+  std::vector<int> global_id(n, -1);
+  std::vector<int> global_values;
+  for (size_t id = 0; id < n; ++id) {
+    const flat_inst_t &inst = flat.insts[id];
+    for (int k = 0; k < inst.opd_num; ++k) {
+      const flat_operand_t &opd = flat_operand(flat, inst, k);
+      if (opd.kind != FLAT_OPD_VALUE) {
+        continue;
+      }
+      int v = opd.value;
+      end[v] = std::max(end[v], (int)(2 * id));
+      if (flat.insts[v].bb != inst.bb && global_id[v] < 0) {
+        global_id[v] = global_values.size();
+        global_values.push_back(v);
+      }
+    }
+    if (inst.tag == KOOPA_RVT_BLOCK_ARG_REF) {
+      // the params of a block are all written on entry (by the block args
+      // copies of the predecessor), so they start together
+      const flat_block_t &bb = flat.blocks[inst.bb];
+      start[id] = 2 * bb.inst_begin;
+      end[id] = std::max(end[id], 2 * (bb.inst_begin + bb.param_num) - 1);
+    }
+    else if (inst.has_result) {
+      start[id] = 2 * id + 1;
+      end[id] = std::max(end[id], start[id]);
+    }
+  }
+
+  if (!global_values.empty()) {
+    // per-block bitsets over the global values
+    size_t words = (global_values.size() + 63) / 64;
+    size_t bb_num = flat.blocks.size();
+    std::vector<uint64_t> use(bb_num * words, 0);
+    std::vector<uint64_t> def(bb_num * words, 0);
+    std::vector<uint64_t> live_in(bb_num * words, 0);
+    std::vector<uint64_t> live_out(bb_num * words, 0);
+
+    for (size_t b = 0; b < bb_num; ++b) {
+      const flat_block_t &bb = flat.blocks[b];
+      uint64_t *bb_use = &use[b * words];
+      uint64_t *bb_def = &def[b * words];
+      for (int id = bb.inst_begin; id < bb.inst_end; ++id) {
+        const flat_inst_t &inst = flat.insts[id];
+        for (int k = 0; k < inst.opd_num; ++k) {
+          const flat_operand_t &opd = flat_operand(flat, inst, k);
+          int g = opd.kind == FLAT_OPD_VALUE ? global_id[opd.value] : -1;
+          if (g >= 0 && !(bb_def[g / 64] >> (g % 64) & 1)) {
+            bb_use[g / 64] |= 1ull << (g % 64);
+          }
+        }
+        if (global_id[id] >= 0) {
+          bb_def[global_id[id] / 64] |= 1ull << (global_id[id] % 64);
+        }
+      }
+    }
+
+    // live_out = union of live_in of successors, live_in = use + (live_out - def)
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t b = bb_num; b-- > 0;) {
+        const flat_block_t &bb = flat.blocks[b];
+        if (bb.inst_begin == bb.inst_end) {
+          continue;
+        }
+        const flat_inst_t &term = flat.insts[bb.inst_end - 1];
+        uint64_t *out = &live_out[b * words];
+        uint64_t *in = &live_in[b * words];
+        for (int k = 0; k < 2; ++k) {
+          if (term.targets[k] < 0) {
+            continue;
+          }
+          const uint64_t *succ_in = &live_in[term.targets[k] * words];
+          for (size_t w = 0; w < words; ++w) {
+            out[w] |= succ_in[w];
+          }
+        }
+        for (size_t w = 0; w < words; ++w) {
+          uint64_t new_in = use[b * words + w] | (out[w] & ~def[b * words + w]);
+          if (new_in != in[w]) {
+            in[w] = new_in;
+            changed = true;
+          }
+        }
+      }
+    }
+
+    // stretch intervals over the block boundaries they are live at
+    for (size_t b = 0; b < bb_num; ++b) {
+      const flat_block_t &bb = flat.blocks[b];
+      if (bb.inst_begin == bb.inst_end) {
+        continue;
+      }
+      int bb_start = 2 * bb.inst_begin;
+      int bb_end = 2 * (bb.inst_end - 1) + 1;
+      for (size_t g = 0; g < global_values.size(); ++g) {
+        int v = global_values[g];
+        if (live_in[b * words + g / 64] >> (g % 64) & 1) {
+          start[v] = std::min(start[v], bb_start);
+          end[v] = std::max(end[v], bb_start);
+        }
+        if (live_out[b * words + g / 64] >> (g % 64) & 1) {
+          start[v] = std::min(start[v], bb_end);
+          end[v] = std::max(end[v], bb_end);
+        }
+      }
+    }
+  }
+
+  intervals.clear();
+  for (size_t id = 0; id < n; ++id) {
+    if (flat.insts[id].has_result) {
+      intervals.push_back({ (int)id, start[id], end[id] });
+    }
+  }
+  std::sort(intervals.begin(), intervals.end(), [](const live_interval_t &a, const live_interval_t &b) {
+    return a.start != b.start ? a.start < b.start : a.value < b.value;
+  });
+}
+
+// flat function -> register of every value
+void AllocateRegisters(const flat_function_t &flat, reg_assignment_t &regs) {
+  std::vector<live_interval_t> intervals;
+  ComputeLiveIntervals(flat, intervals);
+
+  regs.value_reg.assign(flat.insts.size(), -1);
+  regs.value_slot.assign(flat.insts.size(), -1);
+  regs.reg_used.assign(RISCV_REG_NUM, false);
+  regs.spill_count = 0;
+  regs.slot_num = 0;
+  regs.peak_live = 0;
+
+  bool reg_free[RISCV_REG_NUM];
+  std::fill(reg_free, reg_free + RISCV_REG_NUM, true);
+
+  // intervals holding a register, sorted by end
+  std::vector<live_interval_t> active;
+  auto by_end = [](const live_interval_t &a, const live_interval_t &b) {
+    return a.end < b.end;
+  };
+
+  for (const live_interval_t &cur : intervals) {
+    // release registers of intervals that ended before cur
+    size_t expired = 0;
+    while (expired < active.size() && active[expired].end < cur.start) {
+      reg_free[regs.value_reg[active[expired].value]] = true;
+      expired = expired + 1;
+    }
+    active.erase(active.begin(), active.begin() + expired);
+
+    int reg = -1;
+    for (int r = 0; r < RISCV_REG_NUM; ++r) {
+      if (reg_free[r]) {
+        reg = r;
+        break;
+      }
+    }
+
+    if (reg < 0) {
+      // no register left: spill whichever of cur and the active intervals ends last
+      regs.spill_count = regs.spill_count + 1;
+      const live_interval_t &last = active.back();
+      if (last.end <= cur.end) {
+        continue;
+      }
+      reg = regs.value_reg[last.value];
+      regs.value_reg[last.value] = -1;
+      active.pop_back();
+    }
+
+    regs.value_reg[cur.value] = reg;
+    regs.reg_used[reg] = true;
+    reg_free[reg] = false;
+    active.insert(std::upper_bound(active.begin(), active.end(), cur, by_end), cur);
+    regs.peak_live = std::max(regs.peak_live, (int)active.size());
+  }
+
+  // spill slots: the same scan over the spilled intervals, with unlimited slots
+  std::vector<int> free_slots;
+  std::vector<live_interval_t> slot_active; // sorted by end
+  for (const live_interval_t &cur : intervals) {
+    if (regs.value_reg[cur.value] >= 0) {
+      continue;
+    }
+    size_t expired = 0;
+    while (expired < slot_active.size() && slot_active[expired].end < cur.start) {
+      free_slots.push_back(regs.value_slot[slot_active[expired].value]);
+      expired = expired + 1;
+    }
+    slot_active.erase(slot_active.begin(), slot_active.begin() + expired);
+
+    int slot;
+    if (free_slots.empty()) {
+      slot = regs.slot_num;
+      regs.slot_num = regs.slot_num + 1;
+    }
+    else {
+      slot = free_slots.back();
+      free_slots.pop_back();
+    }
+    regs.value_slot[cur.value] = slot;
+    slot_active.insert(std::upper_bound(slot_active.begin(), slot_active.end(), cur, by_end), cur);
+  }
+}
+
+// helper functions
+bool is_callee_saved(int reg) {
+  assert(reg >= 0 && reg < RISCV_REG_NUM);
+  return reg >= CALLEE_SAVED_BEGIN;
+}
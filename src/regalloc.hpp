@@ -0,0 +1,42 @@
+#pragma once
+
+#include "flatir.hpp"
+#include <vector>
+
+// Linear-scan register allocation over a flat function.
+// Every value with a result gets one live interval (the hull of the ranges
+// where it is live, from block-level liveness), intervals are scanned in
+// order of their start, and a value is spilled only when all registers are
+// taken. A spilled value keeps a stack slot for its whole lifetime; the
+// slots are handed out by a second scan over the spilled intervals, so
+// values that are never live at once share one.
+
+// allocatable registers, in order of preference (callee-saved last)
+#define RISCV_REG_NUM 25
+extern const char *const riscv_reg_lst[RISCV_REG_NUM];
+
+// positions: instruction i reads its operands at 2*i and writes its result
+// at 2*i+1, so a result may take the register of an operand dying at i
+typedef struct {
+  int value; // value id
+  int start; // first live position
+  int end;   // last live position
+} live_interval_t;
+
+typedef struct {
+  std::vector<int> value_reg;  // value id -> register index, -1 if spilled or no result
+  std::vector<int> value_slot; // value id -> spill slot, -1 if in a register or no result
+  std::vector<bool> reg_used;  // register index -> assigned to some value
+  int spill_count;             // values without a register
+  int slot_num;                // spill slots, shared by spilled values not live at once
+  int peak_live;               // most registers in use at one position
+} reg_assignment_t;
+
+// live intervals of all values with a result, sorted by start
+void ComputeLiveIntervals(const flat_function_t &flat, std::vector<live_interval_t> &intervals);
+
+// flat function -> register of every value
+void AllocateRegisters(const flat_function_t &flat, reg_assignment_t &regs);
+
+// helper functions
+bool is_callee_saved(int reg);
@@ -0,0 +1,471 @@
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include "machine.hpp"
+#include "rvsim.hpp"
+
+// initial stack pointer, the stack grows down from here
+#define SIM_STACK_TOP 0x7ffff000u
+// return address of main, ret to it ends the run
+#define SIM_EXIT_RA 0
+
+// operand layout of each mnemonic
+enum sim_format_t {
+    FMT_R, // rd, rs1, rs2
+    FMT_I, // rd, rs1, imm
+    FMT_U, // rd, rs1
+    FMT_LI, // rd, imm
+    FMT_LOAD, // rd, imm(rs1)
+    FMT_STORE, // rs2, imm(rs1)
+    FMT_B, // rs1, rs2, label
+    FMT_BZ, // rs1, label
+    FMT_J, // label
+    FMT_NONE,
+};
+
+struct sim_mnemonic_t {
+    int op;
+    sim_format_t format;
+};
+
+RiscvSimulator::RiscvSimulator(const pipeline_config_t &config, uint32_t stack_size, uint64_t max_insts)
+    : config(config), stack_size(stack_size), max_insts(max_insts) {
+}
+
+const std::string &
+RiscvSimulator::error() const {
+    return err;
+}
+
+bool
+RiscvSimulator::fail(const std::string &msg) {
+    err = msg;
+    return false;
+}
+
+static std::string trim(const std::string &s) {
+    size_t b = 0, e = s.size();
+    while (b < e && isspace(static_cast<unsigned char>(s[b]))) {
+        b++;
+    }
+    while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) {
+        e--;
+    }
+    return s.substr(b, e - b);
+}
+
+static bool parse_imm(const std::string &s, int32_t &value) {
+    if (s.empty()) {
+        return false;
+    }
+    char *end;
+    long long v = strtoll(s.c_str(), &end, 0);
+    if (*end != '\0' || v < INT32_MIN || v > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<int32_t>(v);
+    return true;
+}
+
+bool
+RiscvSimulator::assemble(const std::string &text) {
+    insts.clear();
+    labels.clear();
+
+    size_t pos = 0;
+    int line_no = 1;
+    while (pos <= text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) {
+            eol = text.size();
+        }
+        if (!parse_line(text.substr(pos, eol - pos), line_no)) {
+            return false;
+        }
+        pos = eol + 1;
+        line_no++;
+    }
+
+    // resolve branch targets
+    std::unordered_map<std::string, int> label_index(labels.begin(), labels.end());
+    for (sim_inst_t &inst : insts) {
+        if (inst.label.empty()) {
+            continue;
+        }
+        auto it = label_index.find(inst.label);
+        if (it == label_index.end()) {
+            return fail("line " + std::to_string(inst.line) + ": unknown label " + inst.label);
+        }
+        inst.target = it->second;
+    }
+    if (label_index.find("main") == label_index.end()) {
+        return fail("no main");
+    }
+    return true;
+}
+
+bool
+RiscvSimulator::parse_line(const std::string &raw_line, int line_no) {
+    static const std::unordered_map<std::string, sim_mnemonic_t> mnemonics = {
+        { "li", { OP_LI, FMT_LI } }, { "mv", { OP_MV, FMT_U } },
+        { "lw", { OP_LW, FMT_LOAD } }, { "sw", { OP_SW, FMT_STORE } },
+        { "add", { OP_ADD, FMT_R } }, { "sub", { OP_SUB, FMT_R } }, { "mul", { OP_MUL, FMT_R } },
+        { "mulh", { OP_MULH, FMT_R } }, { "div", { OP_DIV, FMT_R } }, { "rem", { OP_REM, FMT_R } },
+        { "and", { OP_AND, FMT_R } }, { "or", { OP_OR, FMT_R } }, { "xor", { OP_XOR, FMT_R } },
+        { "sll", { OP_SLL, FMT_R } }, { "srl", { OP_SRL, FMT_R } }, { "sra", { OP_SRA, FMT_R } },
+        { "slt", { OP_SLT, FMT_R } }, { "sltu", { OP_SLTU, FMT_R } }, { "sgt", { OP_SGT, FMT_R } },
+        { "addi", { OP_ADDI, FMT_I } }, { "andi", { OP_ANDI, FMT_I } }, { "ori", { OP_ORI, FMT_I } },
+        { "xori", { OP_XORI, FMT_I } }, { "slti", { OP_SLTI, FMT_I } }, { "sltiu", { OP_SLTIU, FMT_I } },
+        { "slli", { OP_SLLI, FMT_I } }, { "srli", { OP_SRLI, FMT_I } }, { "srai", { OP_SRAI, FMT_I } },
+        { "seqz", { OP_SEQZ, FMT_U } }, { "snez", { OP_SNEZ, FMT_U } },
+        { "neg", { OP_NEG, FMT_U } }, { "not", { OP_NOT, FMT_U } },
+        { "beq", { OP_BEQ, FMT_B } }, { "bne", { OP_BNE, FMT_B } }, { "blt", { OP_BLT, FMT_B } },
+        { "bge", { OP_BGE, FMT_B } }, { "bltu", { OP_BLTU, FMT_B } }, { "bgeu", { OP_BGEU, FMT_B } },
+        { "beqz", { OP_BEQZ, FMT_BZ } }, { "bnez", { OP_BNEZ, FMT_BZ } },
+        { "j", { OP_J, FMT_J } }, { "ret", { OP_RET, FMT_NONE } },
+    };
+
+    std::string where = "line " + std::to_string(line_no) + ": ";
+    std::string line = raw_line.substr(0, raw_line.find('#'));
+    line = trim(line);
+
+    // labels (possibly followed by an instruction)
+    size_t colon;
+    while ((colon = line.find(':')) != std::string::npos) {
+        std::string label = trim(line.substr(0, colon));
+        if (label.empty() || label.find_first_of(" \t,") != std::string::npos) {
+            return fail(where + "bad label");
+        }
+        labels.emplace_back(label, insts.size());
+        line = trim(line.substr(colon + 1));
+    }
+    if (line.empty() || line[0] == '.') {
+        // directives (.text, .globl, ...) do not matter here
+        return true;
+    }
+
+    // mnemonic and comma separated operands
+    size_t sp = line.find_first_of(" \t");
+    std::string name = line.substr(0, sp);
+    std::vector<std::string> opds;
+    if (sp != std::string::npos) {
+        std::string rest = line.substr(sp + 1);
+        size_t start = 0;
+        for (;;) {
+            size_t comma = rest.find(',', start);
+            opds.push_back(trim(rest.substr(start, comma - start)));
+            if (comma == std::string::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+    }
+
+    auto it = mnemonics.find(name);
+    if (it == mnemonics.end()) {
+        return fail(where + "unsupported instruction " + name);
+    }
+    sim_inst_t inst;
+    inst.op = static_cast<sim_op_t>(it->second.op);
+    inst.rd = inst.rs1 = inst.rs2 = -1;
+    inst.imm = 0;
+    inst.target = -1;
+    inst.line = line_no;
+
+    static const int opd_num[] = { 3, 3, 2, 2, 2, 2, 3, 2, 1, 0 };
+    sim_format_t format = it->second.format;
+    if (static_cast<int>(opds.size()) != opd_num[format]) {
+        return fail(where + "wrong operand count for " + name);
+    }
+
+    bool ok = true;
+    auto reg = [&](const std::string &s) {
+        int r = riscv_reg_index(s);
+        ok = ok && r >= 0;
+        return r;
+    };
+    auto imm = [&](const std::string &s) {
+        int32_t v = 0;
+        ok = ok && parse_imm(s, v);
+        return v;
+    };
+    auto mem = [&](const std::string &s) {
+        // imm(reg)
+        size_t lp = s.find('('), rp = s.find(')');
+        if (lp == std::string::npos || rp != s.size() - 1) {
+            ok = false;
+            return;
+        }
+        inst.imm = lp == 0 ? 0 : imm(trim(s.substr(0, lp)));
+        inst.rs1 = reg(trim(s.substr(lp + 1, rp - lp - 1)));
+    };
+
+    switch (format) {
+        case FMT_R:
+            inst.rd = reg(opds[0]);
+            inst.rs1 = reg(opds[1]);
+            inst.rs2 = reg(opds[2]);
+            break;
+        case FMT_I:
+            inst.rd = reg(opds[0]);
+            inst.rs1 = reg(opds[1]);
+            inst.imm = imm(opds[2]);
+            break;
+        case FMT_U:
+            inst.rd = reg(opds[0]);
+            inst.rs1 = reg(opds[1]);
+            break;
+        case FMT_LI:
+            inst.rd = reg(opds[0]);
+            inst.imm = imm(opds[1]);
+            break;
+        case FMT_LOAD:
+            inst.rd = reg(opds[0]);
+            mem(opds[1]);
+            break;
+        case FMT_STORE:
+            inst.rs2 = reg(opds[0]);
+            mem(opds[1]);
+            break;
+        case FMT_B:
+            inst.rs1 = reg(opds[0]);
+            inst.rs2 = reg(opds[1]);
+            inst.label = opds[2];
+            break;
+        case FMT_BZ:
+            inst.rs1 = reg(opds[0]);
+            inst.label = opds[1];
+            break;
+        case FMT_J:
+            inst.label = opds[0];
+            break;
+        case FMT_NONE:
+            break;
+    }
+    if (!ok) {
+        return fail(where + "bad operand in: " + line);
+    }
+
+    // immediates the instruction encoding cannot hold, as an assembler would
+    bool shift = inst.op == OP_SLLI || inst.op == OP_SRLI || inst.op == OP_SRAI;
+    if (shift && (inst.imm < 0 || inst.imm > 31)) {
+        return fail(where + "shift amount out of range in: " + line);
+    }
+    if ((format == FMT_I || format == FMT_LOAD || format == FMT_STORE) && !fits_imm12(inst.imm)) {
+        return fail(where + "immediate out of range [-2048, 2047] in: " + line);
+    }
+    insts.push_back(inst);
+    return true;
+}
+
+bool
+RiscvSimulator::run(sim_result_t &result) {
+    int pc = -1;
+    for (const auto &label : labels) {
+        if (label.first == "main") {
+            pc = label.second;
+        }
+    }
+    if (pc < 0) {
+        return fail("no main");
+    }
+
+    int32_t x[32] = { 0 };
+    std::vector<uint8_t> stack(stack_size);
+    const uint32_t stack_base = SIM_STACK_TOP - stack_size;
+    x[2] = static_cast<int32_t>(SIM_STACK_TOP);
+    x[1] = SIM_EXIT_RA;
+
+    uint64_t n = 0, loads = 0, stores = 0;
+    uint64_t cycles = config.depth - 1;
+    int last_load_rd = -1;
+
+    for (;;) {
+        if (pc < 0 || pc >= static_cast<int>(insts.size())) {
+            return fail("pc out of range");
+        }
+        if (n >= max_insts) {
+            return fail("instruction limit reached");
+        }
+        const sim_inst_t &inst = insts[pc];
+        n++;
+        cycles++;
+        if (last_load_rd > 0 && (inst.rs1 == last_load_rd || inst.rs2 == last_load_rd)) {
+            cycles += config.load_use;
+        }
+        last_load_rd = -1;
+
+        int32_t a = inst.rs1 >= 0 ? x[inst.rs1] : 0;
+        int32_t b = inst.rs2 >= 0 ? x[inst.rs2] : 0;
+        uint32_t ua = static_cast<uint32_t>(a), ub = static_cast<uint32_t>(b);
+        int32_t d = 0;
+        bool write = true, taken = false;
+        int next = pc + 1;
+
+        switch (inst.op) {
+            case OP_LI: d = inst.imm; break;
+            case OP_MV: d = a; break;
+            case OP_ADD: d = static_cast<int32_t>(ua + ub); break;
+            case OP_SUB: d = static_cast<int32_t>(ua - ub); break;
+            case OP_MUL:
+                d = static_cast<int32_t>(ua * ub);
+                cycles += config.mul - 1;
+                break;
+            case OP_MULH:
+                d = static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 32);
+                cycles += config.mul - 1;
+                break;
+            case OP_DIV:
+                // RISC-V: x / 0 = -1, INT_MIN / -1 = INT_MIN
+                d = b == 0 ? -1 : (a == INT32_MIN && b == -1) ? a : a / b;
+                cycles += config.div - 1;
+                break;
+            case OP_REM:
+                d = b == 0 ? a : (a == INT32_MIN && b == -1) ? 0 : a % b;
+                cycles += config.div - 1;
+                break;
+            case OP_AND: d = a & b; break;
+            case OP_OR: d = a | b; break;
+            case OP_XOR: d = a ^ b; break;
+            case OP_SLL: d = static_cast<int32_t>(ua << (ub & 31)); break;
+            case OP_SRL: d = static_cast<int32_t>(ua >> (ub & 31)); break;
+            case OP_SRA: d = a >> (ub & 31); break;
+            case OP_SLT: d = a < b; break;
+            case OP_SLTU: d = ua < ub; break;
+            case OP_SGT: d = a > b; break;
+            case OP_ADDI: d = static_cast<int32_t>(ua + static_cast<uint32_t>(inst.imm)); break;
+            case OP_ANDI: d = a & inst.imm; break;
+            case OP_ORI: d = a | inst.imm; break;
+            case OP_XORI: d = a ^ inst.imm; break;
+            case OP_SLTI: d = a < inst.imm; break;
+            case OP_SLTIU: d = ua < static_cast<uint32_t>(inst.imm); break;
+            case OP_SLLI: d = static_cast<int32_t>(ua << (inst.imm & 31)); break;
+            case OP_SRLI: d = static_cast<int32_t>(ua >> (inst.imm & 31)); break;
+            case OP_SRAI: d = a >> (inst.imm & 31); break;
+            case OP_SEQZ: d = a == 0; break;
+            case OP_SNEZ: d = a != 0; break;
+            case OP_NEG: d = static_cast<int32_t>(0u - ua); break;
+            case OP_NOT: d = ~a; break;
+            case OP_LW:
+            case OP_SW: {
+                uint32_t addr = ua + static_cast<uint32_t>(inst.imm);
+                if (addr % 4 != 0 || addr < stack_base || addr > SIM_STACK_TOP - 4) {
+                    return fail("line " + std::to_string(inst.line) + ": bad address " + std::to_string(addr));
+                }
+                uint8_t *p = &stack[addr - stack_base];
+                if (inst.op == OP_LW) {
+                    memcpy(&d, p, 4);
+                    loads++;
+                    last_load_rd = inst.rd;
+                }
+                else {
+                    memcpy(p, &b, 4);
+                    stores++;
+                    write = false;
+                }
+                cycles += config.mem;
+                break;
+            }
+            case OP_BEQ: taken = a == b; write = false; break;
+            case OP_BNE: taken = a != b; write = false; break;
+            case OP_BLT: taken = a < b; write = false; break;
+            case OP_BGE: taken = a >= b; write = false; break;
+            case OP_BLTU: taken = ua < ub; write = false; break;
+            case OP_BGEU: taken = ua >= ub; write = false; break;
+            case OP_BEQZ: taken = a == 0; write = false; break;
+            case OP_BNEZ: taken = a != 0; write = false; break;
+            case OP_J: taken = true; write = false; break;
+            case OP_RET:
+                if (x[1] != SIM_EXIT_RA) {
+                    return fail("ret to unknown address");
+                }
+                cycles += config.branch;
+                result.ret = x[10];
+                result.insts = n;
+                result.loads = loads;
+                result.stores = stores;
+                result.cycles = cycles;
+                return true;
+        }
+
+        if (write && inst.rd > 0) {
+            x[inst.rd] = d;
+        }
+        if (taken) {
+            next = inst.target;
+            cycles += config.branch;
+        }
+        pc = next;
+    }
+}
+
+// helper functions
+int riscv_reg_index(const std::string &name) {
+    static const std::unordered_map<std::string, int> abi_names = {
+        { "zero", 0 }, { "ra", 1 }, { "sp", 2 }, { "gp", 3 }, { "tp", 4 },
+        { "t0", 5 }, { "t1", 6 }, { "t2", 7 }, { "s0", 8 }, { "fp", 8 }, { "s1", 9 },
+        { "a0", 10 }, { "a1", 11 }, { "a2", 12 }, { "a3", 13 }, { "a4", 14 }, { "a5", 15 },
+        { "a6", 16 }, { "a7", 17 }, { "s2", 18 }, { "s3", 19 }, { "s4", 20 }, { "s5", 21 },
+        { "s6", 22 }, { "s7", 23 }, { "s8", 24 }, { "s9", 25 }, { "s10", 26 }, { "s11", 27 },
+        { "t3", 28 }, { "t4", 29 }, { "t5", 30 }, { "t6", 31 },
+    };
+    auto it = abi_names.find(name);
+    if (it != abi_names.end()) {
+        return it->second;
+    }
+    if (name.size() >= 2 && name[0] == 'x') {
+        char *end;
+        long r = strtol(name.c_str() + 1, &end, 10);
+        if (*end == '\0' && r >= 0 && r < 32) {
+            return r;
+        }
+    }
+    return -1;
+}
+
+bool parse_pipeline_config(const char *spec, pipeline_config_t &config) {
+    // key=value[,key=value...]
+    std::string s(spec);
+    size_t start = 0;
+    while (start < s.size()) {
+        size_t comma = s.find(',', start);
+        std::string item = s.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        char *end;
+        long value = strtol(item.c_str() + eq + 1, &end, 10);
+        if (*end != '\0' || value < 0) {
+            return false;
+        }
+        if (key == "depth") {
+            config.depth = value < 1 ? 1 : value;
+        }
+        else if (key == "load_use") {
+            config.load_use = value;
+        }
+        else if (key == "mul") {
+            config.mul = value < 1 ? 1 : value;
+        }
+        else if (key == "div") {
+            config.div = value < 1 ? 1 : value;
+        }
+        else if (key == "branch") {
+            config.branch = value;
+        }
+        else if (key == "mem") {
+            config.mem = value;
+        }
+        else {
+            return false;
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return true;
+}
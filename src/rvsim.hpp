@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// timing parameters of the in-order pipeline model (cycles)
+struct pipeline_config_t {
+    int depth = 5; // pipeline stages, paid once to fill the pipeline
+    int load_use = 1; // stall when an instruction uses the result of the load right before it
+    int mul = 3; // occupancy of mul (non-pipelined multiplier)
+    int div = 34; // occupancy of div/rem
+    int branch = 2; // penalty of a taken branch or jump (predict not taken)
+    int mem = 0; // extra cycles of every load/store
+};
+
+// result of one simulated run
+struct sim_result_t {
+    int32_t ret; // a0 at the final ret of main
+    uint64_t insts; // dynamic instruction count
+    uint64_t loads;
+    uint64_t stores;
+    uint64_t cycles; // estimated by the pipeline model
+};
+
+// RV32IM simulator for the assembly produced by Visit.
+// The text is assembled into a decoded instruction list once; execution
+// starts at `main` and stops when main returns. Only the stack is backed by
+// memory. Unknown instructions, bad addresses and runaway programs are
+// reported through error().
+class RiscvSimulator {
+    public:
+        RiscvSimulator(const pipeline_config_t &config, uint32_t stack_size = 1 << 20, uint64_t max_insts = 4000000000ull);
+
+        bool assemble(const std::string &text);
+        bool run(sim_result_t &result);
+        const std::string &error() const;
+
+    private:
+        enum sim_op_t {
+            OP_LI, OP_MV, OP_LW, OP_SW,
+            OP_ADD, OP_SUB, OP_MUL, OP_MULH, OP_DIV, OP_REM, OP_AND, OP_OR, OP_XOR,
+            OP_SLL, OP_SRL, OP_SRA, OP_SLT, OP_SLTU, OP_SGT,
+            OP_ADDI, OP_ANDI, OP_ORI, OP_XORI, OP_SLTI, OP_SLTIU, OP_SLLI, OP_SRLI, OP_SRAI,
+            OP_SEQZ, OP_SNEZ, OP_NEG, OP_NOT,
+            OP_BEQ, OP_BNE, OP_BLT, OP_BGE, OP_BLTU, OP_BGEU, OP_BEQZ, OP_BNEZ,
+            OP_J, OP_RET,
+        };
+
+        struct sim_inst_t {
+            sim_op_t op;
+            int rd, rs1, rs2; // -1 if unused
+            int32_t imm;
+            std::string label; // branch/jump target before resolution
+            int target; // instruction index of the target
+            int line; // source line for diagnostics
+        };
+
+        bool parse_line(const std::string &line, int line_no);
+        bool fail(const std::string &msg);
+
+        pipeline_config_t config;
+        uint32_t stack_size;
+        uint64_t max_insts;
+        std::vector<sim_inst_t> insts;
+        std::vector<std::pair<std::string, int>> labels; // label -> instruction index
+        std::string err;
+};
+
+// helper functions
+int riscv_reg_index(const std::string &name);
+bool parse_pipeline_config(const char *spec, pipeline_config_t &config);
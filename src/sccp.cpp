@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "opt.hpp"
+#include "cfg.hpp"
+#include "interp.hpp"
+#include "stats.hpp"
+
+// lattice of a value: not known yet, one constant, or not constant
+enum sccp_state_t {
+  SCCP_TOP,
+  SCCP_CONST,
+  SCCP_BOTTOM,
+};
+
+typedef struct {
+  sccp_state_t state;
+  int32_t value;
+} sccp_lattice_t;
+
+// Sparse conditional constant propagation (Wegman and Zadeck).
+// Blocks become executable only through edges found executable, block
+// params meet the args of their executable incoming edges, and a value is
+// re-evaluated when an operand is lowered in the lattice. Afterwards
+// constant values are replaced by integers, branches with one executable
+// edge become jumps, and blocks that were never executable are deleted.
+void SCCP(KoopaBuilder &builder, const koopa_raw_function_t &func) {
+  koopa_cfg_t cfg;
+  BuildCFG(func, cfg);
+  size_t bb_num = cfg.bbs.size();
+  if (bb_num == 0) {
+    return;
+  }
+
+  // users of every value and the block of every instruction and param
+  std::unordered_map<koopa_raw_value_t, std::vector<koopa_raw_value_t>> users;
+  std::unordered_map<koopa_raw_value_t, int> bb_of;
+  for (size_t b = 0; b < bb_num; ++b) {
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    for (size_t i = 0; i < bb->params.len; ++i) {
+      bb_of[reinterpret_cast<koopa_raw_value_t>(bb->params.buffer[i])] = b;
+    }
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      bb_of[inst] = b;
+      for_each_operand(builder, inst, [&](koopa_raw_value_t &opd) {
+        if (opd->kind.tag != KOOPA_RVT_INTEGER) {
+          users[opd].push_back(inst);
+        }
+      });
+    }
+  }
+
+  std::unordered_map<koopa_raw_value_t, sccp_lattice_t> lattice;
+  auto get = [&](koopa_raw_value_t v) -> sccp_lattice_t {
+    if (v->kind.tag == KOOPA_RVT_INTEGER) {
+      return { SCCP_CONST, v->kind.data.integer.value };
+    }
+    auto it = lattice.find(v);
+    return it == lattice.end() ? sccp_lattice_t{ SCCP_TOP, 0 } : it->second;
+  };
+  auto meet = [](sccp_lattice_t a, sccp_lattice_t b) -> sccp_lattice_t {
+    if (a.state == SCCP_TOP) {
+      return b;
+    }
+    if (b.state == SCCP_TOP) {
+      return a;
+    }
+    if (a.state == SCCP_CONST && b.state == SCCP_CONST && a.value == b.value) {
+      return a;
+    }
+    return { SCCP_BOTTOM, 0 };
+  };
+
+  std::vector<bool> bb_exec(bb_num, false);
+  std::vector<std::vector<bool>> edge_exec(bb_num); // parallel to cfg.succs
+  for (size_t b = 0; b < bb_num; ++b) {
+    edge_exec[b].assign(cfg.succs[b].size(), false);
+  }
+  std::vector<std::pair<int, int>> flow_worklist; // (block, successor slot)
+  std::vector<koopa_raw_value_t> ssa_worklist;
+
+  // lower v to l, queue its users
+  auto update = [&](koopa_raw_value_t v, sccp_lattice_t l) {
+    sccp_lattice_t old = get(v);
+    if (old.state == l.state && (l.state != SCCP_CONST || old.value == l.value)) {
+      return;
+    }
+    lattice[v] = l;
+    auto it = users.find(v);
+    if (it != users.end()) {
+      ssa_worklist.insert(ssa_worklist.end(), it->second.begin(), it->second.end());
+    }
+  };
+  auto mark_edge = [&](int b, koopa_raw_basic_block_t target) {
+    int t = cfg.bb_id.at(target);
+    for (size_t k = 0; k < cfg.succs[b].size(); ++k) {
+      if (cfg.succs[b][k] == t && !edge_exec[b][k]) {
+        flow_worklist.emplace_back(b, k);
+      }
+    }
+  };
+  // args passed from block p to param k of block b
+  auto arg_from = [&](int p, int b, size_t k) {
+    const auto &kind = block_terminator(cfg.bbs[p])->kind;
+    const koopa_raw_slice_t *args = &kind.data.jump.args;
+    if (kind.tag == KOOPA_RVT_BRANCH) {
+      args = kind.data.branch.true_bb == cfg.bbs[b] ? &kind.data.branch.true_args : &kind.data.branch.false_args;
+    }
+    return reinterpret_cast<koopa_raw_value_t>(args->buffer[k]);
+  };
+  auto visit_params = [&](int b) {
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    for (size_t k = 0; k < bb->params.len; ++k) {
+      sccp_lattice_t l = { SCCP_TOP, 0 };
+      for (int p : cfg.preds[b]) {
+        const std::vector<int> &succs = cfg.succs[p];
+        size_t slot = std::find(succs.begin(), succs.end(), b) - succs.begin();
+        if (edge_exec[p][slot]) {
+          l = meet(l, get(arg_from(p, b, k)));
+        }
+      }
+      update(reinterpret_cast<koopa_raw_value_t>(bb->params.buffer[k]), l);
+    }
+  };
+  auto visit_inst = [&](koopa_raw_value_t inst) {
+    int b = bb_of.at(inst);
+    const auto &kind = inst->kind;
+    switch (kind.tag) {
+      case KOOPA_RVT_BINARY: {
+        sccp_lattice_t lhs = get(kind.data.binary.lhs);
+        sccp_lattice_t rhs = get(kind.data.binary.rhs);
+        sccp_lattice_t l = { SCCP_BOTTOM, 0 };
+        if (lhs.state == SCCP_CONST && rhs.state == SCCP_CONST) {
+          // division by zero stays a runtime operation
+          if (interp_binary(kind.data.binary.op, lhs.value, rhs.value, l.value)) {
+            l.state = SCCP_CONST;
+          }
+        }
+        else if (lhs.state == SCCP_TOP || rhs.state == SCCP_TOP) {
+          l.state = SCCP_TOP;
+        }
+        update(inst, l);
+        break;
+      }
+      case KOOPA_RVT_LOAD:
+        update(inst, { SCCP_BOTTOM, 0 });
+        break;
+      case KOOPA_RVT_BRANCH: {
+        sccp_lattice_t cond = get(kind.data.branch.cond);
+        if (cond.state == SCCP_BOTTOM || (cond.state == SCCP_CONST && cond.value != 0)) {
+          mark_edge(b, kind.data.branch.true_bb);
+        }
+        if (cond.state == SCCP_BOTTOM || (cond.state == SCCP_CONST && cond.value == 0)) {
+          mark_edge(b, kind.data.branch.false_bb);
+        }
+        // args may have changed on edges that are already executable
+        for (size_t k = 0; k < cfg.succs[b].size(); ++k) {
+          if (edge_exec[b][k]) {
+            visit_params(cfg.succs[b][k]);
+          }
+        }
+        break;
+      }
+      case KOOPA_RVT_JUMP:
+        mark_edge(b, kind.data.jump.target);
+        if (edge_exec[b][0]) {
+          visit_params(cfg.succs[b][0]);
+        }
+        break;
+      default:
+        break;
+    }
+  };
+
+  // entry block is executable from the start
+  bb_exec[0] = true;
+  for (size_t i = 0; i < cfg.bbs[0]->insts.len; ++i) {
+    visit_inst(reinterpret_cast<koopa_raw_value_t>(cfg.bbs[0]->insts.buffer[i]));
+  }
+  while (!flow_worklist.empty() || !ssa_worklist.empty()) {
+    while (!flow_worklist.empty()) {
+      auto edge = flow_worklist.back();
+      flow_worklist.pop_back();
+      if (edge_exec[edge.first][edge.second]) {
+        continue;
+      }
+      edge_exec[edge.first][edge.second] = true;
+      int b = cfg.succs[edge.first][edge.second];
+      visit_params(b);
+      if (!bb_exec[b]) {
+        // first visit of the block: evaluate everything in it
+        bb_exec[b] = true;
+        for (size_t i = 0; i < cfg.bbs[b]->insts.len; ++i) {
+          visit_inst(reinterpret_cast<koopa_raw_value_t>(cfg.bbs[b]->insts.buffer[i]));
+        }
+      }
+    }
+    while (!ssa_worklist.empty()) {
+      koopa_raw_value_t inst = ssa_worklist.back();
+      ssa_worklist.pop_back();
+      if (bb_exec[bb_of.at(inst)]) {
+        visit_inst(inst);
+      }
+    }
+  }
+
+  // rewrite: constants become integers, dead edges and blocks go away
+  int const_num = 0;
+  int branch_num = 0;
+  auto is_const = [&](koopa_raw_value_t v) {
+    return v->kind.tag != KOOPA_RVT_INTEGER && get(v).state == SCCP_CONST;
+  };
+  std::vector<const void *> kept_bbs;
+  for (size_t b = 0; b < bb_num; ++b) {
+    if (!bb_exec[b]) {
+      continue;
+    }
+    kept_bbs.push_back(cfg.bbs[b]);
+    koopa_raw_basic_block_t bb = cfg.bbs[b];
+    std::vector<const void *> insts;
+    for (size_t i = 0; i < bb->insts.len; ++i) {
+      auto inst = reinterpret_cast<koopa_raw_value_t>(bb->insts.buffer[i]);
+      if (is_const(inst)) {
+        const_num = const_num + 1;
+        continue;
+      }
+      for_each_operand(builder, inst, [&](koopa_raw_value_t &opd) {
+        if (is_const(opd)) {
+          opd = builder.new_integer(get(opd).value);
+        }
+      });
+
+      // branch with one executable edge -> jump
+      auto &kind = builder.mutable_value(inst)->kind;
+      if (kind.tag == KOOPA_RVT_BRANCH) {
+        bool true_exec = bb_exec[cfg.bb_id.at(kind.data.branch.true_bb)];
+        bool false_exec = bb_exec[cfg.bb_id.at(kind.data.branch.false_bb)];
+        sccp_lattice_t cond = get(kind.data.branch.cond);
+        if (cond.state == SCCP_CONST || !true_exec || !false_exec) {
+          bool taken = cond.state == SCCP_CONST ? cond.value != 0 : true_exec;
+          koopa_raw_basic_block_t target = taken ? kind.data.branch.true_bb : kind.data.branch.false_bb;
+          koopa_raw_slice_t args = taken ? kind.data.branch.true_args : kind.data.branch.false_args;
+          kind.tag = KOOPA_RVT_JUMP;
+          kind.data.jump.target = target;
+          kind.data.jump.args = args;
+          branch_num = branch_num + 1;
+        }
+      }
+      insts.push_back(inst);
+    }
+    builder.mutable_block(bb)->insts = builder.new_slice(insts, KOOPA_RSIK_VALUE);
+  }
+  builder.mutable_function(func)->bbs = builder.new_slice(kept_bbs, KOOPA_RSIK_BASIC_BLOCK);
+  remove_block_params(builder, func, [&](koopa_raw_value_t param) {
+    if (is_const(param)) {
+      const_num = const_num + 1;
+      return false;
+    }
+    return true;
+  });
+
+  if (CompileStats::active) {
+    CompileStats::active->count_opt("sccp.constants", const_num);
+    CompileStats::active->count_opt("sccp.branches_folded", branch_num);
+    CompileStats::active->count_opt("sccp.blocks_removed", bb_num - kept_bbs.size());
+  }
+}
@@ -0,0 +1,129 @@
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "driver.hpp"
+#include "emitter.hpp"
+#include "server.hpp"
+
+// requests larger than this are refused (connection is dropped)
+#define MAX_REQUEST_LEN (64u << 20)
+
+int Serve(const char *socket_path, const compile_options_t &opts) {
+  // a client going away must not kill the server
+  signal(SIGPIPE, SIG_IGN);
+
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+    std::cerr << "error: socket path too long" << std::endl;
+    return 1;
+  }
+  strcpy(addr.sun_path, socket_path);
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    std::cerr << "error: socket: " << strerror(errno) << std::endl;
+    return 1;
+  }
+  unlink(socket_path);
+  if (bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+    std::cerr << "error: cannot listen on " << socket_path << ": " << strerror(errno) << std::endl;
+    close(listen_fd);
+    return 1;
+  }
+
+  for (;;) {
+    int conn_fd = accept(listen_fd, nullptr, nullptr);
+    if (conn_fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      std::cerr << "error: accept: " << strerror(errno) << std::endl;
+      break;
+    }
+    std::thread(serve_connection, conn_fd, &opts).detach();
+  }
+
+  close(listen_fd);
+  unlink(socket_path);
+  return 1;
+}
+
+void serve_connection(int conn_fd, const compile_options_t *opts) {
+  std::string mode, source, err_msg;
+  for (;;) {
+    // request
+    uint32_t mode_len, source_len;
+    if (!read_u32(conn_fd, mode_len) || mode_len > MAX_REQUEST_LEN) {
+      break;
+    }
+    mode.resize(mode_len);
+    if (!read_full(conn_fd, &mode[0], mode_len)) {
+      break;
+    }
+    if (!read_u32(conn_fd, source_len) || source_len > MAX_REQUEST_LEN) {
+      break;
+    }
+    source.resize(source_len);
+    if (!read_full(conn_fd, &source[0], source_len)) {
+      break;
+    }
+
+    // compile into memory (or take the output from the cache)
+    Emitter out;
+    err_msg.clear();
+    std::string key, cached;
+    bool hit = false, ok = true;
+    if (!is_server_mode(mode)) {
+      err_msg = "error: unknown mode " + mode;
+      ok = false;
+    }
+    else if (opts->cache) {
+      key = opts->cache->key(mode.c_str(), opts->opt_flags, source);
+      hit = opts->cache->lookup(key, cached);
+    }
+    if (ok && !hit) {
+      ok = CompileSource(mode.c_str(), source, opts->opt_flags, out, err_msg);
+      if (ok && opts->cache) {
+        opts->cache->store(key, out.data(), out.size());
+      }
+    }
+
+    // reply
+    const char *data = hit ? cached.data() : ok ? out.data() : err_msg.data();
+    size_t len = hit ? cached.size() : ok ? out.size() : err_msg.size();
+    if (!write_u32(conn_fd, ok ? 0 : 1) || !write_u32(conn_fd, len) || !write_full(conn_fd, data, len)) {
+      break;
+    }
+  }
+  close(conn_fd);
+}
+
+// helper functions
+bool read_u32(int fd, uint32_t &value) {
+  unsigned char b[4];
+  if (!read_full(fd, b, 4)) {
+    return false;
+  }
+  value = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+  return true;
+}
+
+bool write_u32(int fd, uint32_t value) {
+  unsigned char b[4] = { (unsigned char)value, (unsigned char)(value >> 8),
+    (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+  return write_full(fd, b, 4);
+}
+
+// modes a request may ask for (CompileSource takes any other one as -riscv)
+bool is_server_mode(const std::string &mode) {
+  return mode == "-koopa" || mode == "-riscv" || mode == "-interp";
+}
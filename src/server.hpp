@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "driver.hpp"
+
+// Resident compile server on a Unix domain socket (compiler --serve <socket>).
+//
+// A client connects and sends any number of requests on the connection:
+//   u32 mode_len, mode bytes ("-koopa" / "-riscv" / "-interp"), u32 source_len, source bytes
+// and gets one reply per request:
+//   u32 status (0: ok, 1: unknown mode or compile error), u32 len, output bytes (or error message)
+// All integers are little-endian. Connections are served on their own threads;
+// compilations are reentrant (see driver.hpp), and no files are touched.
+// With a cache in opts, replies for known sources come straight from it.
+int Serve(const char *socket_path, const compile_options_t &opts);
+
+// helper functions
+bool read_u32(int fd, uint32_t &value);
+bool write_u32(int fd, uint32_t value);
+bool is_server_mode(const std::string &mode);
+void serve_connection(int conn_fd, const compile_options_t *opts);
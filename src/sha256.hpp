@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// SHA-256 (FIPS 180-4), used for content-addressed cache keys.
+class Sha256 {
+    public:
+        Sha256();
+
+        void update(const void *data, size_t len);
+        void update(const std::string &s);
+
+        // finish and return the digest as 64 lowercase hex digits
+        std::string hex_digest();
+
+    private:
+        void compress(const unsigned char *block);
+
+        uint32_t state[8];
+        unsigned char block[64];
+        size_t block_len;
+        uint64_t total_len;
+};
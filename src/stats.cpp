@@ -0,0 +1,128 @@
+#include <algorithm>
+#include "stats.hpp"
+
+thread_local CompileStats *CompileStats::active = nullptr;
+
+static void write_json_string(std::ostream &os, const std::string &s) {
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            const char *hex = "0123456789abcdef";
+            os << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        }
+        else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+template <typename T>
+static void write_json_map(std::ostream &os, const std::map<std::string, T> &m) {
+    os << "{";
+    bool first = true;
+    for (const auto &kv : m) {
+        os << (first ? "" : ", ");
+        first = false;
+        write_json_string(os, kv.first);
+        os << ": " << kv.second;
+    }
+    os << "}";
+}
+
+CompileStats::CompileStats() {
+    symtab_lookups = 0;
+    symtab_lookup_depth_sum = 0;
+    symtab_max_scope_depth = 0;
+    stack_loads = 0;
+    stack_stores = 0;
+    spilled_values = 0;
+    peak_live_regs = 0;
+}
+
+void
+CompileStats::count_ast_node(const char *cls) {
+    ast_nodes[cls]++;
+}
+
+void
+CompileStats::count_symtab_lookup(int scope_depth) {
+    symtab_lookups++;
+    symtab_lookup_depth_sum += scope_depth;
+    symtab_max_scope_depth = std::max(symtab_max_scope_depth, scope_depth);
+}
+
+void
+CompileStats::count_koopa_value(const char *kind) {
+    koopa_values[kind]++;
+}
+
+void
+CompileStats::count_koopa_binary(const char *op) {
+    koopa_binary_ops[op]++;
+}
+
+void
+CompileStats::count_block(const char *kind) {
+    blocks[kind]++;
+}
+
+void
+CompileStats::count_opt(const char *counter, long n) {
+    opt_counters[counter] += n;
+}
+
+void
+CompileStats::count_riscv_inst(const char *mnemonic) {
+    riscv_insts[mnemonic]++;
+}
+
+void
+CompileStats::count_stack_access(bool store) {
+    if (store) {
+        stack_stores++;
+    }
+    else {
+        stack_loads++;
+    }
+}
+
+void
+CompileStats::count_function(const char *name, int stack_s) {
+    stack_sizes[name] = stack_s;
+}
+
+void
+CompileStats::count_regalloc(int spilled, int peak_live) {
+    spilled_values = spilled_values + spilled;
+    peak_live_regs = std::max(peak_live_regs, peak_live);
+}
+
+void
+CompileStats::write_json(std::ostream &os, const std::string &file) const {
+    os << "{\"file\": ";
+    write_json_string(os, file);
+    os << ", \"ast_nodes\": ";
+    write_json_map(os, ast_nodes);
+    os << ", \"symtab\": {\"lookups\": " << symtab_lookups
+       << ", \"lookup_scope_depth_sum\": " << symtab_lookup_depth_sum
+       << ", \"max_lookup_scope_depth\": " << symtab_max_scope_depth << "}";
+    os << ", \"koopa_values\": ";
+    write_json_map(os, koopa_values);
+    os << ", \"koopa_binary_ops\": ";
+    write_json_map(os, koopa_binary_ops);
+    os << ", \"blocks\": ";
+    write_json_map(os, blocks);
+    os << ", \"opt\": ";
+    write_json_map(os, opt_counters);
+    os << ", \"riscv_insts\": ";
+    write_json_map(os, riscv_insts);
+    os << ", \"stack_loads\": " << stack_loads << ", \"stack_stores\": " << stack_stores;
+    os << ", \"stack_size\": ";
+    write_json_map(os, stack_sizes);
+    os << ", \"spilled_values\": " << spilled_values;
+    os << ", \"peak_live_regs\": " << peak_live_regs << "}";
+}
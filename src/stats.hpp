@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+
+// Per-compilation counters (--stats=json).
+// Like TimeReport, the phases count into the CompileStats that is active on
+// the current thread, and do nothing when there is none.
+class CompileStats {
+    public:
+        CompileStats();
+
+        void count_ast_node(const char *cls);
+        void count_symtab_lookup(int scope_depth);
+        void count_koopa_value(const char *kind);
+        void count_koopa_binary(const char *op);
+        void count_block(const char *kind);
+        void count_opt(const char *counter, long n); // "pass.what"
+        void count_riscv_inst(const char *mnemonic);
+        void count_stack_access(bool store);
+        void count_function(const char *name, int stack_s);
+        void count_regalloc(int spilled, int peak_live);
+
+        // one JSON object (keys in a fixed order, maps sorted by key)
+        void write_json(std::ostream &os, const std::string &file) const;
+
+        // stats of the compilation running on this thread, may be null
+        static thread_local CompileStats *active;
+
+    private:
+        std::map<std::string, long> ast_nodes;
+        long symtab_lookups;
+        long symtab_lookup_depth_sum;
+        int symtab_max_scope_depth;
+        std::map<std::string, long> koopa_values;
+        std::map<std::string, long> koopa_binary_ops;
+        std::map<std::string, long> blocks;
+        std::map<std::string, long> opt_counters;
+        std::map<std::string, long> riscv_insts;
+        long stack_loads;
+        long stack_stores;
+        std::map<std::string, int> stack_sizes; // function -> stack_s
+        long spilled_values;
+        int peak_live_regs;
+};
@@ -1,29 +1,59 @@
+#include "stats.hpp"
 #include "symtab.hpp"
 
-int SymTable::symtab_count = 0;
-
 SymTable::SymTable() {
-    symtab = { };
-    parent_symtab = nullptr;
-    index = ++symtab_count;
+    scope_count = 0;
 }
 
-sym_info_t 
-SymTable::get_sym_value(sym_name_t sym) {
-    symtab_t::iterator it = symtab.find(sym);
-    if (it != symtab.end()) {
-        // symbol is in the current symtab
-        return it->second;
+void
+SymTable::enter_scope() {
+    scopes.push_back({ entries.size(), ++scope_count });
+}
+
+void
+SymTable::exit_scope() {
+    assert(!scopes.empty());
+    size_t begin = scopes.back().entry_begin;
+    while (entries.size() > begin) {
+        const entry_t &entry = entries.back();
+        binding[entry.sym] = entry.prev;
+        entries.pop_back();
     }
-    else {
-        // symbol not in the current symtab
-        if (!parent_symtab) {
-            // no parent block, which should not occur
-            assert(false);
-        }
-        else {
-            // search in parent block
-            return parent_symtab->get_sym_value(sym);
-        }
+    scopes.pop_back();
+}
+
+int
+SymTable::scope_index() const {
+    assert(!scopes.empty());
+    return scopes.back().index;
+}
+
+int
+SymTable::scope_depth() const {
+    return scopes.size();
+}
+
+void
+SymTable::insert(sym_name_t sym, sym_info_t info) {
+    assert(!scopes.empty());
+    if (sym >= static_cast<sym_name_t>(binding.size())) {
+        binding.resize(sym + 1, -1);
+    }
+    entries.push_back({ sym, info, binding[sym] });
+    binding[sym] = entries.size() - 1;
+}
+
+bool
+SymTable::has_sym(sym_name_t sym) const {
+    return sym < static_cast<sym_name_t>(binding.size()) && binding[sym] >= 0;
+}
+
+sym_info_t 
+SymTable::get_sym_value(sym_name_t sym) const {
+    // symbol must be visible in the current scope or one of its parents
+    assert(has_sym(sym));
+    if (CompileStats::active) {
+        CompileStats::active->count_symtab_lookup(scope_depth());
     }
-}
\ No newline at end of file
+    return entries[binding[sym]].info;
+}
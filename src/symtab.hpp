@@ -1,23 +1,45 @@
 #pragma once
 
-#include <map>
-#include <string>
 #include <cassert>
 #include <variant>
 #include <vector>
-#include <memory>
+#include "koopa.h"
+#include "intern.hpp"
 
-typedef std::string sym_name_t;
-typedef std::variant<int, std::string> sym_info_t;
-typedef std::map<sym_name_t, sym_info_t> symtab_t;
+typedef sym_id_t sym_name_t;
+typedef std::variant<int, koopa_raw_value_t> sym_info_t; // const value or alloc of var
 
+// Flat scoped symbol table.
+// Every visible binding lives in one entry stack; `binding` maps an interned
+// identifier straight to its innermost entry, so lookups are O(1) regardless
+// of nesting depth. Leaving a scope pops its entries and restores shadowed
+// bindings (scope-undo), and entering a scope does not allocate.
 class SymTable {
     public:
-        symtab_t symtab;
-        std::shared_ptr<SymTable> parent_symtab;
-        int index;
-        static int symtab_count;
-
         SymTable();
-        sym_info_t get_sym_value(sym_name_t sym);
-};
\ No newline at end of file
+
+        void enter_scope();
+        void exit_scope();
+        int scope_index() const; // unique index of the current scope
+        int scope_depth() const;
+
+        void insert(sym_name_t sym, sym_info_t info);
+        bool has_sym(sym_name_t sym) const; // visible in the current scope or a parent
+        sym_info_t get_sym_value(sym_name_t sym) const;
+
+    private:
+        struct entry_t {
+            sym_name_t sym;
+            sym_info_t info;
+            int prev; // entry shadowed by this one, -1 if none
+        };
+        struct scope_t {
+            size_t entry_begin;
+            int index;
+        };
+
+        std::vector<int> binding; // sym id -> innermost entry, -1 if unbound
+        std::vector<entry_t> entries;
+        std::vector<scope_t> scopes;
+        int scope_count;
+};
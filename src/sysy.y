@@ -1,7 +1,11 @@
 %code requires {
   #include <memory>
   #include <string>
+  #include "arena.hpp"
   #include "ast.hpp"
+
+  // opaque state of the reentrant lexer
+  typedef void *yyscan_t;
 }
 
 %{
@@ -10,19 +14,36 @@
 #include <memory>
 #include <string>
 #include "ast.hpp"
-
-// 声明 lexer 函数和错误处理函数
-int yylex();
-void yyerror(std::unique_ptr<BaseAST> &ast, const char *s);
+#include "stats.hpp"
 
 using namespace std;
 
 %}
 
+%code {
+// 声明 lexer 函数和错误处理函数
+int yylex(YYSTYPE *yylval_param, yyscan_t scanner);
+void yyerror(yyscan_t scanner, BaseAST *&ast, Arena &arena, string &err_msg, const char *s);
+
+// AST nodes are allocated from the arena (and counted for --stats)
+template <typename T>
+static T *new_ast(Arena &arena, const char *cls) {
+  if (CompileStats::active) {
+    CompileStats::active->count_ast_node(cls);
+  }
+  return arena.make<T>();
+}
+}
+
 // 定义 parser 函数和错误处理函数的附加参数
 // 我们需要返回一个字符串作为 AST, 所以我们把附加参数定义成字符串的智能指针
 // 解析完成后, 我们要手动修改这个参数, 把它设置成解析得到的字符串
-%parse-param { std::unique_ptr<BaseAST> &ast }
+// AST nodes are allocated from the arena and released together with it
+// the parser is pure and the lexer reentrant, so each compilation owns its own
+// scanner state and several files can be parsed at the same time
+%define api.pure full
+%lex-param { yyscan_t scanner }
+%parse-param { yyscan_t scanner } { BaseAST *&ast } { Arena &arena } { std::string &err_msg }
 
 // yylval 的定义, 我们把它定义成了一个联合体 (union)
 // 因为 token 的值有的是字符串指针, 有的是整数
@@ -30,15 +51,15 @@ using namespace std;
 // 至于为什么要用字符串指针而不直接用 string 或者 unique_ptr<string>?
 // 请自行 STFW 在 union 里写一个带析构函数的类会出现什么情况
 %union {
-  std::string *str_val;
+  sym_id_t ident_val;
   int int_val;
   BaseAST *ast_val;
 }
 
 // lexer 返回的所有 token 种类的声明
-// 注意 IDENT 和 INT_CONST 会返回 token 的值, 分别对应 str_val 和 int_val
+// 注意 IDENT 和 INT_CONST 会返回 token 的值, 分别对应 ident_val (interned id) 和 int_val
 %token INT RETURN LEQ GEQ EQ NEQ LAND LOR CONST IF ELSE WHILE BREAK CONTINUE
-%token <str_val> IDENT
+%token <ident_val> IDENT
 %token <int_val> INT_CONST
 
 // 非终结符的类型定义
@@ -67,19 +88,19 @@ using namespace std;
 // start symbols
 CompUnit
   : FuncDef {
-    auto comp_unit = make_unique<CompUnitAST>();
-    comp_unit->func_def = unique_ptr<BaseAST>($1);
-    ast = move(comp_unit);
+    auto comp_unit = new_ast<CompUnitAST>(arena, "CompUnitAST");
+    comp_unit->func_def = $1;
+    ast = comp_unit;
   }
   ;
 
 // basic symbols
 FuncDef
   : FuncType IDENT '(' ')' Block {
-    auto ast = new FuncDefAST();
-    ast->func_type = unique_ptr<BaseAST>($1);
-    ast->ident = *unique_ptr<string>($2);
-    ast->block = unique_ptr<BaseAST>($5);
+    auto ast = new_ast<FuncDefAST>(arena, "FuncDefAST");
+    ast->func_type = $1;
+    ast->ident = $2;
+    ast->block = $5;
     $$ = ast;
   }
   ;
@@ -87,160 +108,144 @@ FuncDef
 FuncType
   : INT {
     // $$ = new string("int");
-    auto ast = new FuncTypeAST();
+    auto ast = new_ast<FuncTypeAST>(arena, "FuncTypeAST");
     $$ = ast;
   }
   ;
 
 Block
   : '{' BlockItemList '}' {
-    auto ast = new BlockAST();
-    ast->block_item_lst = unique_ptr<BaseAST>($2);
+    auto ast = new_ast<BlockAST>(arena, "BlockAST");
+    ast->block_item_lst = $2;
     $$ = ast;
   }
   ;
 
 BlockItemList
   : /* empty */ {
-    auto ast = new BlockItemListAST_emp();
+    auto ast = new_ast<BlockItemListAST>(arena, "BlockItemListAST");
     $$ = ast;
   }
   | BlockItemList BlockItem {
-    auto ast = new BlockItemListAST_lst();
-    ast->block_item_lst = unique_ptr<BaseAST>($1);
-    ast->block_item = unique_ptr<BaseAST>($2);
+    auto ast = static_cast<BlockItemListAST *>($1);
+    ast->block_items.push_back($2);
     $$ = ast;
   }
   ;
 
 BlockItem
   : Decl {
-    auto ast = new BlockItemAST();
-    ast->some_block = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | Stmt {
-    auto ast = new BlockItemAST();
-    ast->some_block = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 
 MatchedStmt
   : RETURN ExpList ';' {
-    auto ast = new MatchedStmtAST_ret();
-    ast->exp_list = unique_ptr<BaseAST>($2);
+    auto ast = new_ast<MatchedStmtAST_ret>(arena, "MatchedStmtAST_ret");
+    ast->exp_list = $2;
     $$ = ast;
   }
   | LVal '=' Exp ';' {
-    auto ast = new MatchedStmtAST_var();
-    ast->l_val = unique_ptr<BaseAST>($1);
-    ast->exp = unique_ptr<BaseAST>($3);
+    auto ast = new_ast<MatchedStmtAST_var>(arena, "MatchedStmtAST_var");
+    ast->l_val = $1;
+    ast->exp = $3;
     $$ = ast;
   }
   | Block {
-    auto ast = new MatchedStmtAST_blk();
-    ast->block = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<MatchedStmtAST_blk>(arena, "MatchedStmtAST_blk");
+    ast->block = $1;
     $$ = ast;
   }
   | ExpList ';' {
-    auto ast = new MatchedStmtAST_lst();
-    ast->exp_list = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<MatchedStmtAST_lst>(arena, "MatchedStmtAST_lst");
+    ast->exp_list = $1;
     $$ = ast;
   }
   | IF '(' Exp ')' MatchedStmt ELSE MatchedStmt {
-    auto ast = new MatchedStmtAST_ifelse();
-    ast->exp = unique_ptr<BaseAST>($3);
-    ast->matched_stmt_if = unique_ptr<BaseAST>($5);
-    ast->matched_stmt_else = unique_ptr<BaseAST>($7);
+    auto ast = new_ast<MatchedStmtAST_ifelse>(arena, "MatchedStmtAST_ifelse");
+    ast->exp = $3;
+    ast->matched_stmt_if = $5;
+    ast->matched_stmt_else = $7;
     $$ = ast;
   }
   | WHILE '(' Exp ')' MatchedStmt {
-    auto ast = new MatchedStmtAST_while();
-    ast->exp = unique_ptr<BaseAST>($3);
-    ast->matched_stmt = unique_ptr<BaseAST>($5);
+    auto ast = new_ast<MatchedStmtAST_while>(arena, "MatchedStmtAST_while");
+    ast->exp = $3;
+    ast->matched_stmt = $5;
     $$ = ast;
   }
   | BREAK ';' {
-    auto ast = new MatchedStmtAST_break();
+    auto ast = new_ast<MatchedStmtAST_break>(arena, "MatchedStmtAST_break");
     $$ = ast;
   }
   | CONTINUE ';' {
-    auto ast = new MatchedStmtAST_continue();
+    auto ast = new_ast<MatchedStmtAST_continue>(arena, "MatchedStmtAST_continue");
     $$ = ast;
   }
   ;
 UnmatchedStmt
   : IF '(' Exp ')' Stmt {
-    auto ast = new UnmatchedStmtAST_if();
-    ast->exp = unique_ptr<BaseAST>($3);
-    ast->stmt = unique_ptr<BaseAST>($5);
+    auto ast = new_ast<UnmatchedStmtAST_if>(arena, "UnmatchedStmtAST_if");
+    ast->exp = $3;
+    ast->stmt = $5;
     $$ = ast;
   }
   | IF '(' Exp ')' MatchedStmt ELSE UnmatchedStmt {
-    auto ast = new UnmatchedStmtAST_ifelse();
-    ast->exp = unique_ptr<BaseAST>($3);
-    ast->matched_stmt = unique_ptr<BaseAST>($5);
-    ast->unmatched_stmt = unique_ptr<BaseAST>($7);
+    auto ast = new_ast<UnmatchedStmtAST_ifelse>(arena, "UnmatchedStmtAST_ifelse");
+    ast->exp = $3;
+    ast->matched_stmt = $5;
+    ast->unmatched_stmt = $7;
     $$ = ast;
   }
   ;
 Stmt
   : MatchedStmt {
-    auto ast = new StmtAST();
-    ast->some_stmt = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | UnmatchedStmt {
-    auto ast = new StmtAST();
-    ast->some_stmt = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 
 // expression symbols
 ConstExp
   : Exp {
-    auto ast = new ConstExpAST();
-    ast->exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 
 ExpList
   : /* empty */ {
-    auto ast = new ExpListAST_emp();
+    auto ast = new_ast<ExpListAST>(arena, "ExpListAST");
     $$ = ast;
   }
   | ExpList Exp {
-    auto ast = new ExpListAST_lst();
-    ast->exp_list = unique_ptr<BaseAST>($1);
-    ast->exp = unique_ptr<BaseAST>($2);
+    auto ast = static_cast<ExpListAST *>($1);
+    ast->exps.push_back($2);
     $$ = ast;
   }
   ;
 
 Exp
   : LOrExp {
-    auto ast = new ExpAST();
-    ast->some_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 
 PrimaryExp
   : '(' Exp ')' {
-    auto ast = new PrimaryExpAST_exp();
-    ast->exp = unique_ptr<BaseAST>($2);
-    $$ = ast;
+    $$ = $2;
   }
   | LVal {
-    auto ast = new PrimaryExpAST_val();
-    ast->l_val = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<PrimaryExpAST_val>(arena, "PrimaryExpAST_val");
+    ast->l_val = $1;
     $$ = ast;
   }
   | Number {
-    auto ast = new PrimaryExpAST_num();
+    auto ast = new_ast<PrimaryExpAST_num>(arena, "PrimaryExpAST_num");
     ast->number = $1;
     $$ = ast;
   }
@@ -248,31 +253,29 @@ PrimaryExp
 
 UnaryExp
   : PrimaryExp {
-    auto ast = new UnaryExpAST_pri();
-    ast->primary_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | UnaryOp UnaryExp {
-    auto ast = new UnaryExpAST_uop();
-    ast->unary_op = unique_ptr<BaseAST>($1);
-    ast->unary_exp = unique_ptr<BaseAST>($2);
+    auto ast = new_ast<UnaryExpAST_uop>(arena, "UnaryExpAST_uop");
+    ast->unary_op = $1;
+    ast->unary_exp = $2;
     $$ = ast;
   }
   ;
 
 UnaryOp
   : '+' { 
-    auto ast = new UnaryOpAST();
+    auto ast = new_ast<UnaryOpAST>(arena, "UnaryOpAST");
     ast->op = "+";
     $$ = ast;
   }
   | '-' { 
-    auto ast = new UnaryOpAST();
+    auto ast = new_ast<UnaryOpAST>(arena, "UnaryOpAST");
     ast->op = "-";
     $$ = ast;
   }
   | '!' { 
-    auto ast = new UnaryOpAST();
+    auto ast = new_ast<UnaryOpAST>(arena, "UnaryOpAST");
     ast->op = "!";
     $$ = ast;
   }
@@ -280,137 +283,125 @@ UnaryOp
 
 MulExp
   : UnaryExp {
-    auto ast = new MulExpAST_una();
-    ast->unary_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | MulExp '*' UnaryExp {
-    auto ast = new MulExpAST_mul();
-    ast->mul_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<MulExpAST_mul>(arena, "MulExpAST_mul");
+    ast->mul_exp = $1;
     ast->op = "*";
-    ast->unary_exp = unique_ptr<BaseAST>($3);
+    ast->unary_exp = $3;
     $$ = ast;
   }
   | MulExp '/' UnaryExp {
-    auto ast = new MulExpAST_mul();
-    ast->mul_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<MulExpAST_mul>(arena, "MulExpAST_mul");
+    ast->mul_exp = $1;
     ast->op = "/";
-    ast->unary_exp = unique_ptr<BaseAST>($3);
+    ast->unary_exp = $3;
     $$ = ast;
   }
   | MulExp '%' UnaryExp {
-    auto ast = new MulExpAST_mul();
-    ast->mul_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<MulExpAST_mul>(arena, "MulExpAST_mul");
+    ast->mul_exp = $1;
     ast->op = "%";
-    ast->unary_exp = unique_ptr<BaseAST>($3);
+    ast->unary_exp = $3;
     $$ = ast;
   }
   ;
 
 AddExp
   : MulExp {
-    auto ast = new AddExpAST_mul();
-    ast->mul_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | AddExp '+' MulExp {
-    auto ast = new AddExpAST_add();
-    ast->add_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<AddExpAST_add>(arena, "AddExpAST_add");
+    ast->add_exp = $1;
     ast->op = "+";
-    ast->mul_exp = unique_ptr<BaseAST>($3);
+    ast->mul_exp = $3;
     $$ = ast;
   }
   | AddExp '-' MulExp {
-    auto ast = new AddExpAST_add();
-    ast->add_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<AddExpAST_add>(arena, "AddExpAST_add");
+    ast->add_exp = $1;
     ast->op = "-";
-    ast->mul_exp = unique_ptr<BaseAST>($3);
+    ast->mul_exp = $3;
     $$ = ast;
   }
   ;
 
 RelExp
   : AddExp {
-    auto ast = new RelExpAST_add();
-    ast->add_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | RelExp '<' AddExp {
-    auto ast = new RelExpAST_rel();
-    ast->rel_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<RelExpAST_rel>(arena, "RelExpAST_rel");
+    ast->rel_exp = $1;
     ast->op = "<";
-    ast->add_exp = unique_ptr<BaseAST>($3);
+    ast->add_exp = $3;
     $$ = ast;
   }
   | RelExp '>' AddExp {
-    auto ast = new RelExpAST_rel();
-    ast->rel_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<RelExpAST_rel>(arena, "RelExpAST_rel");
+    ast->rel_exp = $1;
     ast->op = ">";
-    ast->add_exp = unique_ptr<BaseAST>($3);
+    ast->add_exp = $3;
     $$ = ast;
   }
   | RelExp LEQ AddExp {
-    auto ast = new RelExpAST_rel();
-    ast->rel_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<RelExpAST_rel>(arena, "RelExpAST_rel");
+    ast->rel_exp = $1;
     ast->op = "<=";
-    ast->add_exp = unique_ptr<BaseAST>($3);
+    ast->add_exp = $3;
     $$ = ast;
   }
   | RelExp GEQ AddExp {
-    auto ast = new RelExpAST_rel();
-    ast->rel_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<RelExpAST_rel>(arena, "RelExpAST_rel");
+    ast->rel_exp = $1;
     ast->op = ">=";
-    ast->add_exp = unique_ptr<BaseAST>($3);
+    ast->add_exp = $3;
     $$ = ast;
   }
   ;
 
 EqExp
   : RelExp {
-    auto ast = new EqExpAST_rel();
-    ast->rel_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | EqExp EQ RelExp {
-    auto ast = new EqExpAST_eq();
-    ast->eq_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<EqExpAST_eq>(arena, "EqExpAST_eq");
+    ast->eq_exp = $1;
     ast->op = "==";
-    ast->rel_exp = unique_ptr<BaseAST>($3);
+    ast->rel_exp = $3;
     $$ = ast;
   }
   | EqExp NEQ RelExp {
-    auto ast = new EqExpAST_eq();
-    ast->eq_exp = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<EqExpAST_eq>(arena, "EqExpAST_eq");
+    ast->eq_exp = $1;
     ast->op = "!=";
-    ast->rel_exp = unique_ptr<BaseAST>($3);
+    ast->rel_exp = $3;
     $$ = ast;
   }
   ;
 
 LAndExp
   : EqExp {
-    auto ast = new LAndExpAST_eq();
-    ast->eq_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | LAndExp LAND EqExp {
-    auto ast = new LAndExpAST_and();
-    ast->land_exp = unique_ptr<BaseAST>($1);
-    ast->eq_exp = unique_ptr<BaseAST>($3);
+    auto ast = new_ast<LAndExpAST_and>(arena, "LAndExpAST_and");
+    ast->land_exp = $1;
+    ast->eq_exp = $3;
     $$ = ast;
   }
   ;
 
 LOrExp
   : LAndExp {
-    auto ast = new LOrExpAST_and();
-    ast->land_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | LOrExp LOR LAndExp {
-    auto ast = new LOrExpAST_or();
-    ast->lor_exp = unique_ptr<BaseAST>($1);
-    ast->land_exp = unique_ptr<BaseAST>($3);
+    auto ast = new_ast<LOrExpAST_or>(arena, "LOrExpAST_or");
+    ast->lor_exp = $1;
+    ast->land_exp = $3;
     $$ = ast;
   }
   ;
@@ -418,110 +409,100 @@ LOrExp
 // variable symbols
 Decl
   : ConstDecl {
-    auto ast = new DeclAST();
-    ast->some_decl = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   | VarDecl {
-    auto ast = new DeclAST();
-    ast->some_decl = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 
 ConstDecl
   : CONST BType ConstDefList ';' {
-    auto ast = new ConstDeclAST();
-    ast->b_type = unique_ptr<BaseAST>($2);
-    ast->const_def_list = unique_ptr<BaseAST>($3);
+    auto ast = new_ast<ConstDeclAST>(arena, "ConstDeclAST");
+    ast->b_type = $2;
+    ast->const_def_list = $3;
     $$ = ast;
   }
   ;
 
 ConstDefList
   : ConstDef {
-    auto ast = new ConstDefListAST_def();
-    ast->const_def = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<ConstDefListAST>(arena, "ConstDefListAST");
+    ast->const_defs.push_back($1);
     $$ = ast;
   }
   | ConstDefList ',' ConstDef {
-    auto ast = new ConstDefListAST_lst();
-    ast->const_def_list = unique_ptr<BaseAST>($1);
-    ast->const_def = unique_ptr<BaseAST>($3);
+    auto ast = static_cast<ConstDefListAST *>($1);
+    ast->const_defs.push_back($3);
     $$ = ast;
   }
   ;
 
 BType
   : INT {
-    auto ast = new BTypeAST();
+    auto ast = new_ast<BTypeAST>(arena, "BTypeAST");
     $$ = ast;
   }
   ;
 
 ConstDef
   : IDENT '=' ConstInitVal {
-    auto ast = new ConstDefAST();
-    ast->ident = *unique_ptr<string>($1);;
-    ast->const_init_val = unique_ptr<BaseAST>($3);
+    auto ast = new_ast<ConstDefAST>(arena, "ConstDefAST");
+    ast->ident = $1;
+    ast->const_init_val = $3;
     $$ = ast;
   }
   ;
 
 ConstInitVal
   : ConstExp {
-    auto ast = new ConstInitValAST();
-    ast->const_exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 
 LVal
   : IDENT {
-    auto ast = new LValAST();
-    ast->ident = *unique_ptr<string>($1);;
+    auto ast = new_ast<LValAST>(arena, "LValAST");
+    ast->ident = $1;
     $$ = ast;
   }
   ;
 VarDecl
   : BType VarDefList ';' {
-    auto ast = new VarDeclAST();
-    ast->b_type = unique_ptr<BaseAST>($1);
-    ast->var_def_list = unique_ptr<BaseAST>($2);
+    auto ast = new_ast<VarDeclAST>(arena, "VarDeclAST");
+    ast->b_type = $1;
+    ast->var_def_list = $2;
     $$ = ast;
   }
   ;
 VarDefList
   : VarDef {
-    auto ast = new VarDefListAST_def();
-    ast->var_def = unique_ptr<BaseAST>($1);
+    auto ast = new_ast<VarDefListAST>(arena, "VarDefListAST");
+    ast->var_defs.push_back($1);
     $$ = ast;
   }
   | VarDefList ',' VarDef {
-    auto ast = new VarDefListAST_lst();
-    ast->var_def_list = unique_ptr<BaseAST>($1);
-    ast->var_def = unique_ptr<BaseAST>($3);
+    auto ast = static_cast<VarDefListAST *>($1);
+    ast->var_defs.push_back($3);
     $$ = ast;
   }
   ;
 VarDef
   : IDENT {
-    auto ast = new VarDefAST_dec();
-    ast->ident = *unique_ptr<std::string>($1);
+    auto ast = new_ast<VarDefAST_dec>(arena, "VarDefAST_dec");
+    ast->ident = $1;
     $$ = ast;
   }
   | IDENT '=' InitVal {
-    auto ast = new VarDefAST_def();
-    ast->ident = *unique_ptr<std::string>($1);
-    ast->init_val = unique_ptr<BaseAST>($3);
+    auto ast = new_ast<VarDefAST_def>(arena, "VarDefAST_def");
+    ast->ident = $1;
+    ast->init_val = $3;
     $$ = ast;
   }
   ;
 InitVal
   : Exp {
-    auto ast = new InitValAST();
-    ast->exp = unique_ptr<BaseAST>($1);
-    $$ = ast;
+    $$ = $1;
   }
   ;
 // const symbol
@@ -535,6 +516,7 @@ Number
 
 // 定义错误处理函数, 其中第二个参数是错误信息
 // parser 如果发生错误 (例如输入的程序出现了语法错误), 就会调用这个函数
-void yyerror(unique_ptr<BaseAST> &ast, const char *s) {
-  cerr << "error: " << s << endl;
+// 错误信息不直接打印, 而是交给调用者 (batch 模式下需要按输入顺序输出)
+void yyerror(yyscan_t scanner, BaseAST *&ast, Arena &arena, string &err_msg, const char *s) {
+  err_msg = string("error: ") + s;
 }
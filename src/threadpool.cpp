@@ -0,0 +1,69 @@
+#include <cassert>
+#include <thread>
+#include "threadpool.hpp"
+
+ThreadPool::ThreadPool(int num_threads) : num_threads(num_threads) {
+    assert(num_threads >= 1);
+}
+
+int
+ThreadPool::size() const {
+    return num_threads;
+}
+
+void
+ThreadPool::run(size_t num_jobs, const std::function<void(size_t)> &job) {
+    int workers = num_threads;
+    if (num_jobs < (size_t)workers) {
+        workers = num_jobs == 0 ? 1 : (int)num_jobs;
+    }
+
+    std::vector<worker_queue_t> queues(workers);
+    for (size_t i = 0; i < num_jobs; ++i) {
+        queues[i % workers].jobs.push_back(i);
+    }
+
+    auto work = [&](int self) {
+        size_t job_id;
+        while (next_job(queues, self, job_id)) {
+            job(job_id);
+        }
+    };
+
+    // the calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; ++i) {
+        threads.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+
+bool
+ThreadPool::next_job(std::vector<worker_queue_t> &queues, int self, size_t &job_id) {
+    // own deque first (LIFO end)
+    {
+        worker_queue_t &own = queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.jobs.empty()) {
+            job_id = own.jobs.back();
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // steal from the other end of the next non-empty deque
+    int n = queues.size();
+    for (int i = 1; i < n; ++i) {
+        worker_queue_t &victim = queues[(self + i) % n];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.jobs.empty()) {
+            job_id = victim.jobs.front();
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
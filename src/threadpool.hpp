@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Work-stealing pool for a fixed batch of independent jobs.
+// Jobs are dealt round-robin into one deque per worker; a worker pops from
+// the back of its own deque and, once that is empty, steals from the front
+// of the others. No job creates new jobs, so a worker is done as soon as
+// every deque is empty.
+class ThreadPool {
+    public:
+        explicit ThreadPool(int num_threads);
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        int size() const;
+
+        // run job(0) ... job(num_jobs - 1), return when all of them are done
+        void run(size_t num_jobs, const std::function<void(size_t)> &job);
+
+    private:
+        struct worker_queue_t {
+            std::mutex lock;
+            std::deque<size_t> jobs;
+        };
+
+        bool next_job(std::vector<worker_queue_t> &queues, int self, size_t &job_id);
+
+        int num_threads;
+};
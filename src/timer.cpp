@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <ctime>
+#include <sys/resource.h>
+#include "timer.hpp"
+
+thread_local TimeReport *TimeReport::active = nullptr;
+
+static double wall_now_us() {
+    // all reports share one origin so batch traces line up
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+}
+
+static double cpu_now_us() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static long peak_rss_kb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+TimeReport::TimeReport() {
+    wall_now_us();
+}
+
+void
+TimeReport::begin(const char *name) {
+    time_span_t span;
+    span.name = name;
+    span.depth = open.size();
+    span.start_us = wall_now_us();
+    span.wall_us = 0;
+    span.cpu_us = cpu_now_us(); // start value until end()
+    span.peak_rss_kb = 0;
+    open.push_back(span);
+}
+
+void
+TimeReport::end() {
+    assert(!open.empty());
+    time_span_t span = open.back();
+    open.pop_back();
+    span.wall_us = wall_now_us() - span.start_us;
+    span.cpu_us = cpu_now_us() - span.cpu_us;
+    span.peak_rss_kb = peak_rss_kb();
+    done.push_back(span);
+}
+
+void
+TimeReport::print(std::ostream &os, const char *title) const {
+    // merge spans with the same name and depth, keep first-start order
+    std::vector<time_span_t> rows;
+    std::vector<int> counts;
+    std::vector<time_span_t> sorted = done;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const time_span_t &a, const time_span_t &b) {
+        return a.start_us < b.start_us;
+    });
+    for (const time_span_t &span : sorted) {
+        size_t i = 0;
+        while (i < rows.size() && !(rows[i].depth == span.depth && strcmp(rows[i].name, span.name) == 0)) {
+            i++;
+        }
+        if (i == rows.size()) {
+            rows.push_back(span);
+            counts.push_back(1);
+            continue;
+        }
+        rows[i].wall_us += span.wall_us;
+        rows[i].cpu_us += span.cpu_us;
+        rows[i].peak_rss_kb = std::max(rows[i].peak_rss_kb, span.peak_rss_kb);
+        counts[i]++;
+    }
+
+    os << "===== time report: " << title << " =====\n";
+    os << std::left << std::setw(20) << "phase" << std::right << std::setw(8) << "count"
+       << std::setw(12) << "wall(ms)" << std::setw(12) << "cpu(ms)" << std::setw(14) << "peak RSS(KB)" << "\n";
+    os << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < rows.size(); i++) {
+        std::string name = std::string(2 * rows[i].depth, ' ') + rows[i].name;
+        os << std::left << std::setw(20) << name << std::right << std::setw(8) << counts[i]
+           << std::setw(12) << rows[i].wall_us / 1e3 << std::setw(12) << rows[i].cpu_us / 1e3
+           << std::setw(14) << rows[i].peak_rss_kb << "\n";
+    }
+    os.unsetf(std::ios::floatfield);
+}
+
+void
+TimeReport::write_trace_events(std::ostream &os, int tid, bool &first) const {
+    os << std::fixed << std::setprecision(3);
+    for (const time_span_t &span : done) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":\"" << span.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+           << ",\"ts\":" << span.start_us << ",\"dur\":" << span.wall_us
+           << ",\"args\":{\"cpu_us\":" << span.cpu_us << ",\"peak_rss_kb\":" << span.peak_rss_kb << "}}";
+    }
+    os.unsetf(std::ios::floatfield);
+}
+
+const std::vector<time_span_t> &
+TimeReport::spans() const {
+    return done;
+}
+
+TimeScope::TimeScope(const char *name) : report(TimeReport::active) {
+    if (report) {
+        report->begin(name);
+    }
+}
+
+TimeScope::~TimeScope() {
+    if (report) {
+        report->end();
+    }
+}
+
+bool write_chrome_trace(const char *path, const std::vector<const TimeReport *> &reports) {
+    std::ofstream os(path);
+    if (!os) {
+        return false;
+    }
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < reports.size(); i++) {
+        reports[i]->write_trace_events(os, i, first);
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return bool(os);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// one measured phase of a compilation
+struct time_span_t {
+    const char *name;
+    int depth; // nesting level (0: top level)
+    double start_us; // wall clock start, relative to process start
+    double wall_us;
+    double cpu_us; // CPU time of the compiling thread
+    long peak_rss_kb; // process peak RSS when the phase ended
+};
+
+// Per-compilation phase timer (-ftime-report / -ftime-trace).
+// Phases are opened with TimeScope on the report that is active on the
+// current thread, so the compiler phases need no extra parameters; without
+// an active report a TimeScope costs one thread-local load.
+class TimeReport {
+    public:
+        TimeReport();
+
+        void begin(const char *name);
+        void end();
+
+        // table with one row per phase name (repeated phases are summed)
+        void print(std::ostream &os, const char *title) const;
+        // Chrome trace-event records (without the enclosing array), tid tags the compilation
+        void write_trace_events(std::ostream &os, int tid, bool &first) const;
+
+        const std::vector<time_span_t> &spans() const;
+
+        // report of the compilation running on this thread, may be null
+        static thread_local TimeReport *active;
+
+    private:
+        std::vector<time_span_t> done;
+        std::vector<time_span_t> open; // stack of unfinished spans
+};
+
+// RAII phase on the active report
+class TimeScope {
+    public:
+        explicit TimeScope(const char *name);
+        ~TimeScope();
+        TimeScope(const TimeScope &) = delete;
+        TimeScope &operator=(const TimeScope &) = delete;
+
+    private:
+        TimeReport *report;
+};
+
+// write a complete Chrome trace JSON file for the given reports (tid = index)
+bool write_chrome_trace(const char *path, const std::vector<const TimeReport *> &reports);
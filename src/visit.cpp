@@ -1,47 +1,42 @@
 #include <cassert>
-#include <fstream>
+#include <cstring>
 #include <vector>
-#include <map>
 #include "visit.hpp"
 #include "koopa.h"
-#include "iostream"
-
-// TODO: figure out logic for releasing tempregs
+#include "stats.hpp"
+#include "timer.hpp"
 
 // constant
-#define TEMPREG_NUM 15
 #define S_ALIGNMENT 16
 
-// temp register list
-std::vector<std::string>
-tempreg_lst = {"t0", "t1", "t2", "t3", "t4", "t5", "t6",
-  "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7"};
-int used_tempreg_count = 0;
-
-// map: koopa value -> risv temp reg name
-std::map<koopa_raw_value_t, std::string>
-koopa_tempreg_map = { };
-
-// map: koopa value -> stack offset
-std::map<koopa_raw_value_t, int>
-koopa_offset_map = { };
-
-// stack space needed to alloc for current funtion
-int stack_s = 0;
+// scratch registers, never handed out by the register allocator:
+// immediates and spilled operands are loaded to them, and a spilled
+// result is computed in the first one before being stored
+const char *
+scratch_reg_lst[2] = {"t5", "t6"};
 
-// visit mode: 
-//  1. "riscv" (visit koopa to generate riscv code); 
-//  2. "stack" (visit koopa to calculate stack space allocated)
-std::string visit_mode = "none";
+// context of the program being visited on this thread
+static thread_local riscv_context_t *ctx = nullptr;
 
 // visit raw program
-void Visit(const koopa_raw_program_t &program) {
-  std::cout << "\t.text\n";
+void Visit(const koopa_raw_program_t &program, Emitter &emitter) {
+  riscv_context_t program_ctx;
+  program_ctx.out = &emitter;
+  riscv_context_t *outer_ctx = set_riscv_context(&program_ctx);
+
+  *ctx->out << "\t.text\n";
 
-  std::string old_mode = set_visit_mode("riscv");
   Visit(program.values);
   Visit(program.funcs);
-  reset_visit_mode(old_mode);
+
+  set_riscv_context(outer_ctx);
+}
+
+// make ctx the context of this thread, return the previous one
+riscv_context_t *set_riscv_context(riscv_context_t *new_ctx) {
+  riscv_context_t *old_ctx = ctx;
+  ctx = new_ctx;
+  return old_ctx;
 }
 
 // visit raw slice
@@ -52,12 +47,6 @@ void Visit(const koopa_raw_slice_t &slice) {
       case KOOPA_RSIK_FUNCTION:
         Visit(reinterpret_cast<koopa_raw_function_t>(ptr));
         break;
-      case KOOPA_RSIK_BASIC_BLOCK:
-        Visit(reinterpret_cast<koopa_raw_basic_block_t>(ptr));
-        break;
-      case KOOPA_RSIK_VALUE:
-        Visit(reinterpret_cast<koopa_raw_value_t>(ptr));
-        break;
       default:
         assert(false);
     }
@@ -66,424 +55,979 @@ void Visit(const koopa_raw_slice_t &slice) {
 
 // visit function
 void Visit(const koopa_raw_function_t &func) {
+  // lower to flat form, values get dense ids
+  {
+    TimeScope scope("lower");
+    LowerFunction(func, ctx->cur_func);
+  }
+
   // entry point
-  std::cout << "\t.globl " << (func->name)+1 << "\n";
-  std::cout << (func->name)+1 << ":\n";
+  *ctx->out << "\t.globl " << ctx->cur_func.name << "\n";
+  *ctx->out << ctx->cur_func.name << ":\n";
 
-  // calculate stack space for prologue
-  stack_s = 0;
-  std::string old_mode;
-  old_mode = set_visit_mode("stack");
-  Visit(func->bbs);
-  reset_visit_mode(old_mode);
+  // assign registers, then calculate stack space for prologue
+  {
+    TimeScope scope("regalloc");
+    AllocateRegisters(ctx->cur_func, ctx->regs);
+  }
+  {
+    TimeScope scope("stack");
+    allocate_stack();
+  }
+  if (CompileStats::active) {
+    CompileStats::active->count_function(ctx->cur_func.name, ctx->stack_s);
+    CompileStats::active->count_regalloc(ctx->regs.spill_count, ctx->regs.peak_live);
+  }
+
+  TimeScope scope("riscv");
 
-  // 16 bytes alignment (round up)
-  stack_s = (stack_s + S_ALIGNMENT - 1) & ~(S_ALIGNMENT - 1);
-  
   // generate prologue
-  // TODO: handle outside of [-2048, 2047]
-  std::cout << "\taddi sp, sp, -" << stack_s << "\n";
+  if (ctx->stack_s > 0) {
+    generate_sp_adjust(-ctx->stack_s);
+  }
+  for (const auto &saved : ctx->saved_regs) {
+    emit_sw(riscv_reg_lst[saved.first], saved.second);
+  }
 
   // generate riscv code for basic blocks
-  old_mode = set_visit_mode("riscv");
-  Visit(func->bbs);
-  reset_visit_mode(old_mode);
+  for (const flat_block_t &bb : ctx->cur_func.blocks) {
+    Visit(bb);
+  }
+
+  // clean up the instruction list, then print it
+  {
+    TimeScope peephole_scope("peephole");
+    Peephole(ctx->code, std::vector<const char *>(scratch_reg_lst, scratch_reg_lst + 2));
+  }
+  EmitMachineCode(ctx->code, *ctx->out);
+  ctx->code.clear();
 }
 
 // visit basic blocks
-void Visit(const koopa_raw_basic_block_t &bb) {
-  if (visit_mode == "riscv") {
-    std::string bbname = ((bb->name)+1);
-    if (bbname != "entry") {
-      std::cout << "\n" << (bb->name)+1 << ":\n";
-    }
+void Visit(const flat_block_t &bb) {
+  if (strcmp(bb.name, "entry") != 0) {
+    emit_label(bb.name);
+  }
+  for (int id = bb.inst_begin; id < bb.inst_end; ++id) {
+    Visit(ctx->cur_func.insts[id]);
   }
-  Visit(bb->insts);
 }
 
-// visit values
-void Visit(const koopa_raw_value_t &value) {
-  if (visit_mode == "riscv") {
-    const auto &kind = value->kind;
-    int load_offset = -1;
-    switch (kind.tag) {
-      case KOOPA_RVT_RETURN:
-        Visit(kind.data.ret);
-        break;
-      case KOOPA_RVT_INTEGER:
-        Visit(kind.data.integer);
-        break;
-      case KOOPA_RVT_BINARY:
-        Visit(kind.data.binary);
-        // directly save calculated value to stack
-        load_offset = offset_by_koopa(value);
-        std::cout << "\tsw " << current_tempreg() << ", " << load_offset << "(sp)\n";
-        // release tempreg
-        used_tempreg_count = used_tempreg_count - 1;
-        break;
-      case KOOPA_RVT_STORE:
-        Visit(kind.data.store);
-        break;
-      case KOOPA_RVT_LOAD:
-        Visit(kind.data.load);
-        // directly save loaded value to stack
-        load_offset = offset_by_koopa(value);
-        std::cout << "\tsw " << current_tempreg() << ", " << load_offset << "(sp)\n";
-        // release tempreg
-        used_tempreg_count = used_tempreg_count - 1;
-        break;
-      case KOOPA_RVT_ALLOC:
-        break;
-      case KOOPA_RVT_BRANCH:
-        Visit(kind.data.branch);
-        break;
-      case KOOPA_RVT_JUMP:
-        Visit(kind.data.jump);
-        break;
-      default:
-        std::cout << "[unexpected value kind: " << kind.tag << " at visit mode: " << visit_mode << "]\n";
-        // assert(false);
+// visit instructions
+void Visit(const flat_inst_t &inst) {
+  switch (inst.tag) {
+    case KOOPA_RVT_RETURN:
+      generate_ret(inst);
+      break;
+    case KOOPA_RVT_BINARY:
+      generate_binary(inst);
+      break;
+    case KOOPA_RVT_STORE:
+      generate_store(inst);
+      break;
+    case KOOPA_RVT_LOAD:
+      generate_load(inst);
+      break;
+    case KOOPA_RVT_ALLOC:
+    case KOOPA_RVT_BLOCK_ARG_REF:
+      break;
+    case KOOPA_RVT_BRANCH:
+      generate_branch(inst);
+      break;
+    case KOOPA_RVT_JUMP:
+      generate_jump(inst);
+      break;
+    default:
+      *ctx->out << "[unexpected value kind: " << inst.tag << "]\n";
+      // assert(false);
+  }
+}
+
+// stack pre-pass: give every alloc a slot, place the spill slots of the
+// allocator after them, and save the callee-saved registers it used at the top
+void allocate_stack() {
+  int alloc_num = 0;
+  int saved_num = 0;
+  for (const flat_inst_t &inst : ctx->cur_func.insts) {
+    alloc_num = alloc_num + (inst.tag == KOOPA_RVT_ALLOC);
+  }
+  for (int reg = 0; reg < RISCV_REG_NUM; ++reg) {
+    saved_num = saved_num + (ctx->regs.reg_used[reg] && is_callee_saved(reg));
+  }
+
+  // a frame beyond 12-bit offsets gets a parking slot at the bottom
+  ctx->stack_s = 0;
+  ctx->park_offset = -1;
+  if (!fits_imm12(4 * (alloc_num + ctx->regs.slot_num + saved_num))) {
+    ctx->park_offset = 0;
+    ctx->stack_s = 4;
+  }
+
+  ctx->value_offset.assign(ctx->cur_func.insts.size(), -1);
+  for (size_t id = 0; id < ctx->cur_func.insts.size(); ++id) {
+    // allocate 4 for "alloc"
+    if (ctx->cur_func.insts[id].tag == KOOPA_RVT_ALLOC) {
+      ctx->value_offset[id] = ctx->stack_s;
+      ctx->stack_s = ctx->stack_s + 4;
     }
   }
-  else if (visit_mode == "stack") {
-    // allocate 4 for non-void value
-    if (value->ty->tag == KOOPA_RTT_INT32) {
-      koopa_offset_map[value] = stack_s;
-      stack_s = stack_s + 4;
+  int spill_base = ctx->stack_s;
+  for (size_t id = 0; id < ctx->cur_func.insts.size(); ++id) {
+    if (ctx->regs.value_slot[id] >= 0) {
+      ctx->value_offset[id] = spill_base + 4 * ctx->regs.value_slot[id];
     }
+  }
+  ctx->stack_s = spill_base + 4 * ctx->regs.slot_num;
 
-    // allocate 4 for "alloc"
-    if (value->kind.tag == KOOPA_RVT_ALLOC) {
-      koopa_offset_map[value] = stack_s;
-      stack_s = stack_s + 4;
+  ctx->saved_regs.clear();
+  for (int reg = 0; reg < RISCV_REG_NUM; ++reg) {
+    if (ctx->regs.reg_used[reg] && is_callee_saved(reg)) {
+      ctx->saved_regs.emplace_back(reg, ctx->stack_s);
+      ctx->stack_s = ctx->stack_s + 4;
     }
   }
+
+  // 16 bytes alignment (round up)
+  ctx->stack_s = (ctx->stack_s + S_ALIGNMENT - 1) & ~(S_ALIGNMENT - 1);
 }
 
 // return
-void Visit(const koopa_raw_return_t &ret) {
-  if (visit_mode == "riscv") {
-    // put return value to register a0, according to value type
-    if (ret.value->kind.tag == KOOPA_RVT_INTEGER)
-    {
-      std::cout << "\tli a0, " << ret.value->kind.data.integer.value;
-      std::cout << "\n";
+void generate_ret(const flat_inst_t &inst) {
+  // put return value to register a0, according to value type
+  if (inst.opd_num > 0) {
+    const flat_operand_t &value = flat_operand(ctx->cur_func, inst, 0);
+    if (value.kind == FLAT_OPD_IMM) {
+      emit_li("a0", value.value);
+    }
+    else if (ctx->regs.value_reg[value.value] < 0) {
+      emit_lw("a0", offset_by_koopa(value.value));
     }
     else {
-      std::cout << "\tlw a0, " << offset_by_koopa(ret.value) << "(sp)\n";
-      std::cout << "\n";
+      const char *reg = riscv_reg_lst[ctx->regs.value_reg[value.value]];
+      if (strcmp(reg, "a0") != 0) {
+        emit_u("mv", "a0", reg);
+      }
     }
-
-    // generate epilogue
-    // TODO: handle outside of [-2048, 2047]
-    std::cout << "\taddi sp, sp, " << stack_s << "\n";
-
-    // ret instruction
-    std::cout << "\tret\n";
   }
-}
 
-// integer
-void Visit(const koopa_raw_integer_t &integer) {
-  if (visit_mode == "riscv") {
-    if (integer.value == 0) {
-      std::cout << "x0";
-    }
-    else {
-      std::cout << integer.value;
-    }
+  // generate epilogue
+  for (const auto &saved : ctx->saved_regs) {
+    emit_lw(riscv_reg_lst[saved.first], saved.second);
   }
+  if (ctx->stack_s > 0) {
+    generate_sp_adjust(ctx->stack_s);
+  }
+
+  // ret instruction
+  emit_ret();
 }
 
 // binary
-void Visit(const koopa_raw_binary_t &binary) {
-  if (visit_mode == "riscv") {
-    const auto &lhs = binary.lhs;
-    const auto &rhs = binary.rhs;
-    switch (binary.op) {
-      case KOOPA_RBO_MUL:
-        generate_mul(lhs, rhs);
-        break;
-      case KOOPA_RBO_DIV:
-        generate_div(lhs, rhs);
-        break;
-      case KOOPA_RBO_MOD:
-        generate_mod(lhs, rhs);
-        break;
-      case KOOPA_RBO_ADD:
-        generate_add(lhs, rhs);
-        break;
-      case KOOPA_RBO_SUB:
-        generate_sub(lhs, rhs);
-        break;
-      case KOOPA_RBO_LT:
-        generate_lt(lhs, rhs);
-        break;
-      case KOOPA_RBO_GT:
-        generate_gt(lhs, rhs);
-        break;
-      case KOOPA_RBO_LE:
-        generate_le(lhs, rhs);
-        break;
-      case KOOPA_RBO_GE:
-        generate_ge(lhs, rhs);
-        break;
-      case KOOPA_RBO_EQ:
-        generate_eq(lhs, rhs);
-        break;
-      case KOOPA_RBO_NOT_EQ:
-        generate_neq(lhs, rhs);
-        break;
-      case KOOPA_RBO_AND:
-        generate_and(lhs, rhs);
-        break;
-      case KOOPA_RBO_OR:
-        generate_or(lhs, rhs);
-        break;
-      default:
-        assert(false);
-    }
+void generate_binary(const flat_inst_t &inst) {
+  int id = &inst - ctx->cur_func.insts.data();
+  const char *rd = result_reg(id);
+  const auto &lhs = flat_operand(ctx->cur_func, inst, 0);
+  const auto &rhs = flat_operand(ctx->cur_func, inst, 1);
+  if (fused_compare(id)) {
+    // computed by the branch
+    return;
   }
+  select_binary(rd, inst.op, lhs, rhs);
+  save_result(id, rd);
 }
 
 // store
-void Visit(const koopa_raw_store_t &store) {
-  if (visit_mode == "riscv") {
-    const auto &value = store.value;
-    const auto &dest = store.dest;
+void generate_store(const flat_inst_t &inst) {
+  const auto &value = flat_operand(ctx->cur_func, inst, 0);
+  const auto &dest = flat_operand(ctx->cur_func, inst, 1);
 
-    // load value to a new tempreg
-    load_value(value);
+  // register holding the value
+  const char *reg = load_value(value, scratch_reg_lst[0]);
 
-    // find stack offset of dest
-    int dest_offset = offset_by_koopa(dest);
+  // find stack offset of dest
+  int dest_offset = offset_by_koopa(dest.value);
 
-    // generate sw instruction, directly use current tempreg to save the result
-    std::cout << "\tsw " << current_tempreg() << ", " << dest_offset << "(sp)\n";
-
-    // release tempreg
-    used_tempreg_count = used_tempreg_count - 1;
-  }
+  // generate sw instruction
+  emit_sw(reg, dest_offset);
 }
 
 // load
-void Visit(const koopa_raw_load_t &load) {
-  if (visit_mode == "riscv") {
-    const auto &src = load.src;
-    
-    // load value to a new tempreg
-    load_value(src);
-  }
+void generate_load(const flat_inst_t &inst) {
+  int id = &inst - ctx->cur_func.insts.data();
+  const auto &src = flat_operand(ctx->cur_func, inst, 0);
+
+  // load from the stack slot of the alloc
+  const char *rd = result_reg(id);
+  emit_lw(rd, offset_by_koopa(src.value));
+  save_result(id, rd);
 }
 
 // branch
-void Visit(const koopa_raw_branch_t &branch) {
-  const auto &cond = branch.cond;
-  const auto &true_bb = branch.true_bb;
-  const auto &false_bb = branch.false_bb;
+void generate_branch(const flat_inst_t &inst) {
+  const auto &true_bb = ctx->cur_func.blocks[inst.targets[0]];
+  const auto &false_bb = ctx->cur_func.blocks[inst.targets[1]];
+
+  if (inst.arg_num[0] == 0) {
+    // branch = b(cond) + (false args) + j
+    generate_cond_branch(inst, false, true_bb.name);
+    generate_block_args(inst, 1);
+    emit_j(false_bb.name);
+    return;
+  }
 
-  if (visit_mode == "riscv") {
-    // load cond value from stack to tempreg and release the tempreg
-    load_value(cond);
-    used_tempreg_count = used_tempreg_count - 1;
+  // true args are copied on the fall-through path, false args after a local label
+  const char *bb_name = ctx->cur_func.blocks[inst.bb].name;
+  if (inst.arg_num[1] == 0) {
+    generate_cond_branch(inst, true, false_bb.name);
+  }
+  else {
+    generate_cond_branch(inst, true, std::string(bb_name) + "_false");
+  }
+  generate_block_args(inst, 0);
+  emit_j(true_bb.name);
+  if (inst.arg_num[1] > 0) {
+    emit_label(std::string(bb_name) + "_false");
+    generate_block_args(inst, 1);
+    emit_j(false_bb.name);
+  }
+}
 
-    // branch = bnez + j
-    std::cout << "\tbnez ";
-    riscv_by_koopa(cond);
-    std::cout << ", " << (true_bb->name)+1 << "\n";
-    std::cout << "\tj " << (false_bb->name)+1 << "\n";
+// branch to label if the condition of inst holds (fails if negate): a fused
+// comparison becomes blt/bge/beq/bne on its operands, otherwise bnez/beqz
+void generate_cond_branch(const flat_inst_t &inst, bool negate, const std::string &label) {
+  const auto &cond = flat_operand(ctx->cur_func, inst, 0);
+  if (cond.kind != FLAT_OPD_VALUE || !fused_compare(cond.value)) {
+    const char *reg = load_value(cond, scratch_reg_lst[0]);
+    emit_bz(negate ? "beqz" : "bnez", reg, label);
+    return;
   }
+
+  const flat_inst_t &cmp = ctx->cur_func.insts[cond.value];
+  const flat_operand_t *lhs = &flat_operand(ctx->cur_func, cmp, 0);
+  const flat_operand_t *rhs = &flat_operand(ctx->cur_func, cmp, 1);
+  koopa_raw_binary_op_t op = negate ? inverse_compare_op(cmp.op) : cmp.op;
+
+  // a > b is b < a, a <= b is b >= a
+  const char *riscv = nullptr;
+  switch (op) {
+    case KOOPA_RBO_EQ:
+      riscv = "beq";
+      break;
+    case KOOPA_RBO_NOT_EQ:
+      riscv = "bne";
+      break;
+    case KOOPA_RBO_LT:
+    case KOOPA_RBO_GT:
+      riscv = "blt";
+      break;
+    case KOOPA_RBO_GE:
+    case KOOPA_RBO_LE:
+      riscv = "bge";
+      break;
+    default:
+      assert(false);
+  }
+  if (op == KOOPA_RBO_GT || op == KOOPA_RBO_LE) {
+    std::swap(lhs, rhs);
+  }
+  const char *lreg = load_value(*lhs, scratch_reg_lst[0]);
+  const char *rreg = load_value(*rhs, scratch_reg_lst[1]);
+  emit_b(riscv, lreg, rreg, label);
 }
 
 // jump
-void Visit(const koopa_raw_jump_t &jump) {
-  const auto &target = jump.target;
+void generate_jump(const flat_inst_t &inst) {
+  const auto &target = ctx->cur_func.blocks[inst.targets[0]];
+
+  // jump = (args) + j
+  generate_block_args(inst, 0);
+  emit_j(target.name);
+}
+
+// copy the block args of target 0/1 of inst to the params of the target
+void generate_block_args(const flat_inst_t &inst, int target) {
+  const flat_block_t &bb = ctx->cur_func.blocks[inst.targets[target]];
+
+  // pending copies (dest, src), without the ones already in place
+  std::vector<std::pair<riscv_loc_t, riscv_loc_t>> moves;
+  for (int i = 0; i < inst.arg_num[target]; ++i) {
+    flat_operand_t param = { FLAT_OPD_VALUE, bb.inst_begin + i };
+    riscv_loc_t dest = loc_by_koopa(param);
+    riscv_loc_t src = loc_by_koopa(flat_arg(ctx->cur_func, inst, target, i));
+    if (!same_loc(dest, src)) {
+      moves.emplace_back(dest, src);
+    }
+  }
+
+  // all copies happen at once: a copy is emitted when no pending copy still
+  // reads its dest; if only cycles are left, one dest is parked in t6 or the parking slot
+  while (!moves.empty()) {
+    size_t ready = moves.size();
+    for (size_t i = 0; i < moves.size() && ready == moves.size(); ++i) {
+      bool read = false;
+      for (size_t j = 0; j < moves.size() && !read; ++j) {
+        read = j != i && same_loc(moves[j].second, moves[i].first);
+      }
+      if (!read) {
+        ready = i;
+      }
+    }
 
-  if (visit_mode == "riscv") {
-    // jump = j
-    std::cout << "\tj " << (target->name)+1 << "\n";
+    if (ready < moves.size()) {
+      generate_move(moves[ready].first, moves[ready].second);
+      moves.erase(moves.begin() + ready);
+    }
+    else {
+      riscv_loc_t blocked = moves[0].first;
+      riscv_loc_t parked = { RISCV_LOC_SCRATCH, 1 };
+      if (ctx->park_offset >= 0) {
+        parked = { RISCV_LOC_STACK, ctx->park_offset };
+      }
+      generate_move(parked, blocked);
+      for (auto &move : moves) {
+        if (same_loc(move.second, blocked)) {
+          move.second = parked;
+        }
+      }
+    }
   }
 }
 
-// generate riscv code for binary ops
-void generate_eq(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  if (rhs->kind.tag == KOOPA_RVT_INTEGER && rhs->kind.data.integer.value == 0) {
-      load_value(lhs);
+// instruction selection for binary ops
+// Every rule covers one binary node together with constraints on its
+// constant leaves, and costs the instructions it emits. The operands it takes
+// in registers add one instruction each when they are immediates (li) or
+// spilled (lw). The cheapest rule wins, the first one on a tie. Commutative
+// ops and mirrored comparisons (a < b is b > a) also try swapped operands.
+// Strength-reduced multiplication and division by constants always win over
+// li + mul/div/rem (cost 1), the emitters pick the sequence.
+static const riscv_rule_t riscv_rules[] = {
+  { KOOPA_RBO_ADD, SHAPE_ANY, SHAPE_IMM12, 1, "addi", nullptr, select_i },
+  { KOOPA_RBO_ADD, SHAPE_ANY, SHAPE_ANY, 1, "add", nullptr, select_r },
+  { KOOPA_RBO_SUB, SHAPE_ANY, SHAPE_NEG_IMM12, 1, "addi", nullptr, select_i_neg },
+  { KOOPA_RBO_SUB, SHAPE_ANY, SHAPE_ANY, 1, "sub", nullptr, select_r },
+  { KOOPA_RBO_MUL, SHAPE_ANY, SHAPE_IMM, 1, nullptr, nullptr, select_mul_imm },
+  { KOOPA_RBO_MUL, SHAPE_ANY, SHAPE_ANY, 1, "mul", nullptr, select_r },
+  { KOOPA_RBO_DIV, SHAPE_ANY, SHAPE_NONZERO, 1, nullptr, nullptr, select_div_imm },
+  { KOOPA_RBO_DIV, SHAPE_ANY, SHAPE_ANY, 1, "div", nullptr, select_r },
+  { KOOPA_RBO_MOD, SHAPE_ANY, SHAPE_NONZERO, 1, nullptr, nullptr, select_mod_imm },
+  { KOOPA_RBO_MOD, SHAPE_ANY, SHAPE_ANY, 1, "rem", nullptr, select_r },
+  { KOOPA_RBO_AND, SHAPE_ANY, SHAPE_IMM12, 1, "andi", nullptr, select_i },
+  { KOOPA_RBO_AND, SHAPE_ANY, SHAPE_ANY, 1, "and", nullptr, select_r },
+  { KOOPA_RBO_OR, SHAPE_ANY, SHAPE_IMM12, 1, "ori", nullptr, select_i },
+  { KOOPA_RBO_OR, SHAPE_ANY, SHAPE_ANY, 1, "or", nullptr, select_r },
+  { KOOPA_RBO_XOR, SHAPE_ANY, SHAPE_IMM12, 1, "xori", nullptr, select_i },
+  { KOOPA_RBO_XOR, SHAPE_ANY, SHAPE_ANY, 1, "xor", nullptr, select_r },
+  { KOOPA_RBO_SHL, SHAPE_ANY, SHAPE_IMM, 1, "slli", nullptr, select_shift_imm },
+  { KOOPA_RBO_SHL, SHAPE_ANY, SHAPE_ANY, 1, "sll", nullptr, select_r },
+  { KOOPA_RBO_SHR, SHAPE_ANY, SHAPE_IMM, 1, "srli", nullptr, select_shift_imm },
+  { KOOPA_RBO_SHR, SHAPE_ANY, SHAPE_ANY, 1, "srl", nullptr, select_r },
+  { KOOPA_RBO_SAR, SHAPE_ANY, SHAPE_IMM, 1, "srai", nullptr, select_shift_imm },
+  { KOOPA_RBO_SAR, SHAPE_ANY, SHAPE_ANY, 1, "sra", nullptr, select_r },
+  // comparisons: slt/slti and their negation, a > b is b < a, a <= c is a < c + 1
+  { KOOPA_RBO_LT, SHAPE_ANY, SHAPE_IMM12, 1, "slti", nullptr, select_i },
+  { KOOPA_RBO_LT, SHAPE_ANY, SHAPE_ANY, 1, "slt", nullptr, select_r },
+  { KOOPA_RBO_GT, SHAPE_ANY, SHAPE_INC_IMM12, 2, "slti", "seqz", select_i_inc },
+  { KOOPA_RBO_GT, SHAPE_ANY, SHAPE_ANY, 1, "slt", nullptr, select_r_swap },
+  { KOOPA_RBO_LE, SHAPE_ANY, SHAPE_INC_IMM12, 1, "slti", nullptr, select_i_inc },
+  { KOOPA_RBO_LE, SHAPE_ANY, SHAPE_ANY, 2, "slt", "seqz", select_r_swap },
+  { KOOPA_RBO_GE, SHAPE_ANY, SHAPE_IMM12, 2, "slti", "seqz", select_i },
+  { KOOPA_RBO_GE, SHAPE_ANY, SHAPE_ANY, 2, "slt", "seqz", select_r },
+  // compare to zero, then through xor
+  { KOOPA_RBO_EQ, SHAPE_ANY, SHAPE_ZERO, 1, "seqz", nullptr, select_u },
+  { KOOPA_RBO_EQ, SHAPE_ANY, SHAPE_IMM12, 2, "xori", "seqz", select_i },
+  { KOOPA_RBO_EQ, SHAPE_ANY, SHAPE_ANY, 2, "xor", "seqz", select_r },
+  { KOOPA_RBO_NOT_EQ, SHAPE_ANY, SHAPE_ZERO, 1, "snez", nullptr, select_u },
+  { KOOPA_RBO_NOT_EQ, SHAPE_ANY, SHAPE_IMM12, 2, "xori", "snez", select_i },
+  { KOOPA_RBO_NOT_EQ, SHAPE_ANY, SHAPE_ANY, 2, "xor", "snez", select_r },
+};
+
+#define RISCV_RULE_NUM (sizeof(riscv_rules) / sizeof(riscv_rules[0]))
+
+// rd = lhs op rhs with the cheapest matching rule
+void select_binary(const char *rd, koopa_raw_binary_op_t op, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  // candidate operand orders
+  struct { koopa_raw_binary_op_t op; const flat_operand_t *lhs, *rhs; } trees[2] = {
+    { op, &lhs, &rhs }, { op, &rhs, &lhs },
+  };
+  int tree_num = swapped_op(op, trees[1].op) ? 2 : 1;
+
+  const riscv_rule_t *best = nullptr;
+  int best_tree = 0;
+  int best_cost = 0;
+  for (int t = 0; t < tree_num; ++t) {
+    for (const riscv_rule_t &rule : riscv_rules) {
+      if (rule.op != trees[t].op || !match_shape(rule.lhs, *trees[t].lhs) || !match_shape(rule.rhs, *trees[t].rhs)) {
+        continue;
+      }
+      int cost = rule.cost + operand_cost(rule.lhs, *trees[t].lhs) + operand_cost(rule.rhs, *trees[t].rhs);
+      if (!best || cost < best_cost) {
+        best = &rule;
+        best_tree = t;
+        best_cost = cost;
+      }
+    }
+  }
+  assert(best);
+  best->emit(*best, rd, *trees[best_tree].lhs, *trees[best_tree].rhs);
+  if (best->then) {
+    emit_u(best->then, rd, rd);
+  }
+}
+
+// the op computing the same with swapped operands (lt <-> gt, le <-> ge),
+// false if there is none
+bool swapped_op(koopa_raw_binary_op_t op, koopa_raw_binary_op_t &swapped) {
+  switch (op) {
+    case KOOPA_RBO_ADD:
+    case KOOPA_RBO_MUL:
+    case KOOPA_RBO_AND:
+    case KOOPA_RBO_OR:
+    case KOOPA_RBO_XOR:
+    case KOOPA_RBO_EQ:
+    case KOOPA_RBO_NOT_EQ:
+      swapped = op;
+      return true;
+    case KOOPA_RBO_LT:
+      swapped = KOOPA_RBO_GT;
+      return true;
+    case KOOPA_RBO_GT:
+      swapped = KOOPA_RBO_LT;
+      return true;
+    case KOOPA_RBO_LE:
+      swapped = KOOPA_RBO_GE;
+      return true;
+    case KOOPA_RBO_GE:
+      swapped = KOOPA_RBO_LE;
+      return true;
+    default:
+      return false;
+  }
+}
 
-      // release tempreg
-      used_tempreg_count = used_tempreg_count - 1;
+bool match_shape(riscv_shape_t shape, const flat_operand_t &opd) {
+  if (shape == SHAPE_ANY) {
+    return true;
+  }
+  if (opd.kind != FLAT_OPD_IMM) {
+    return false;
+  }
+  switch (shape) {
+    case SHAPE_ZERO:
+      return opd.value == 0;
+    case SHAPE_NONZERO:
+      return opd.value != 0;
+    case SHAPE_IMM12:
+      return fits_imm12(opd.value);
+    case SHAPE_NEG_IMM12:
+      return opd.value != INT32_MIN && fits_imm12(-opd.value);
+    case SHAPE_INC_IMM12:
+      return opd.value != INT32_MAX && fits_imm12(opd.value + 1);
+    default:
+      return true;
+  }
+}
 
-      std::cout << "\txor ";
-      new_riscv_tempreg();
-      std::cout << ", ";
-      riscv_by_koopa(lhs);
-      std::cout << ", x0" << "\n";
-      std::cout << "\tseqz " << current_tempreg() << ", " << current_tempreg() << "\n";
+// instructions to get an operand taken in a register: li for nonzero
+// constants, lw for spilled values
+int operand_cost(riscv_shape_t shape, const flat_operand_t &opd) {
+  if (shape != SHAPE_ANY) {
+    return 0;
   }
-  else {
-    generate_bin_riscv("xor", lhs, rhs);
-    std::cout << "\tseqz " << current_tempreg() << ", " << current_tempreg() << "\n";
+  if (opd.kind == FLAT_OPD_IMM) {
+    return opd.value != 0;
   }
+  return ctx->regs.value_reg[opd.value] < 0;
+}
+
+// rule emitters
+void select_r(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  generate_bin_riscv(rule.riscv, rd, lhs, rhs);
+}
+
+void select_r_swap(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  generate_bin_riscv(rule.riscv, rd, rhs, lhs);
+}
+
+void select_i(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  emit_i(rule.riscv, rd, load_value(lhs, scratch_reg_lst[0]), rhs.value);
+}
+
+void select_i_neg(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  emit_i(rule.riscv, rd, load_value(lhs, scratch_reg_lst[0]), -rhs.value);
+}
+
+void select_i_inc(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  emit_i(rule.riscv, rd, load_value(lhs, scratch_reg_lst[0]), rhs.value + 1);
+}
+
+void select_u(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &) {
+  emit_u(rule.riscv, rd, load_value(lhs, scratch_reg_lst[0]));
+}
+
+void select_shift_imm(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  emit_i(rule.riscv, rd, load_value(lhs, scratch_reg_lst[0]), rhs.value & 31);
+}
+
+void select_mul_imm(const riscv_rule_t &, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  generate_mul_imm(rd, load_value(lhs, scratch_reg_lst[0]), rhs.value);
+}
+
+void select_div_imm(const riscv_rule_t &, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  generate_div_imm(rd, load_value(lhs, scratch_reg_lst[0]), rhs.value);
+}
+
+void select_mod_imm(const riscv_rule_t &, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  generate_mod_imm(rd, load_value(lhs, scratch_reg_lst[0]), rhs.value);
 }
 
-void generate_neq(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  if (rhs->kind.tag == KOOPA_RVT_INTEGER && rhs->kind.data.integer.value == 0) {
-      // '!' operator for constant
-      load_value(lhs);
+// helper functions
+// register holding the operand: x0 for constant 0, the allocated register,
+// or scratch after loading an immediate or a spilled value to it
+const char *load_value(const flat_operand_t &value, const char *scratch) {
+  if (value.kind == FLAT_OPD_IMM) {
+    if (value.value == 0) {
+      return "x0";
+    }
+    emit_li(scratch, value.value);
+    return scratch;
+  }
 
-      // release tempreg
-      used_tempreg_count = used_tempreg_count - 1;
+  int reg = ctx->regs.value_reg[value.value];
+  if (reg >= 0) {
+    return riscv_reg_lst[reg];
+  }
+  emit_lw(scratch, offset_by_koopa(value.value));
+  return scratch;
+}
 
-      std::cout << "\txor ";
-      new_riscv_tempreg();
-      std::cout << ", ";
-      riscv_by_koopa(lhs);
-      std::cout << ", x0" << "\n";
-      std::cout << "\tsnez " << current_tempreg() << ", " << current_tempreg() << "\n";
+// comparison whose only use is the branch right after it: the branch
+// compares its operands itself (they are still in place, the comparison is
+// their last use and writes nothing then)
+bool fused_compare(int value_id) {
+  const flat_function_t &func = ctx->cur_func;
+  const flat_inst_t &inst = func.insts[value_id];
+  if (inst.tag != KOOPA_RVT_BINARY || func.use_count[value_id] != 1 ||
+    value_id + 1 >= (int)func.insts.size()) {
+    return false;
   }
-  else {
-    generate_bin_riscv("xor", lhs, rhs);
-    std::cout << "\tsnez " << current_tempreg() << ", " << current_tempreg() << "\n";
+  switch (inst.op) {
+    case KOOPA_RBO_EQ:
+    case KOOPA_RBO_NOT_EQ:
+    case KOOPA_RBO_LT:
+    case KOOPA_RBO_GT:
+    case KOOPA_RBO_LE:
+    case KOOPA_RBO_GE:
+      break;
+    default:
+      return false;
+  }
+  const flat_inst_t &next = func.insts[value_id + 1];
+  if (next.tag != KOOPA_RVT_BRANCH || next.bb != inst.bb) {
+    return false;
   }
+  const flat_operand_t &cond = flat_operand(func, next, 0);
+  return cond.kind == FLAT_OPD_VALUE && cond.value == value_id;
 }
 
-void generate_mul(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("mul", lhs, rhs);
+// comparison with the opposite result
+koopa_raw_binary_op_t inverse_compare_op(koopa_raw_binary_op_t op) {
+  switch (op) {
+    case KOOPA_RBO_EQ:
+      return KOOPA_RBO_NOT_EQ;
+    case KOOPA_RBO_NOT_EQ:
+      return KOOPA_RBO_EQ;
+    case KOOPA_RBO_LT:
+      return KOOPA_RBO_GE;
+    case KOOPA_RBO_GE:
+      return KOOPA_RBO_LT;
+    case KOOPA_RBO_GT:
+      return KOOPA_RBO_LE;
+    case KOOPA_RBO_LE:
+      return KOOPA_RBO_GT;
+    default:
+      assert(false);
+      return op;
+  }
 }
 
-void generate_div(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("div", lhs, rhs);
+// register to compute a value to: its own, or a scratch register if spilled
+const char *result_reg(int value_id) {
+  int reg = ctx->regs.value_reg[value_id];
+  return reg >= 0 ? riscv_reg_lst[reg] : scratch_reg_lst[0];
 }
 
-void generate_mod(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("rem", lhs, rhs);
+// store a spilled value computed to reg to its stack slot
+void save_result(int value_id, const char *reg) {
+  if (ctx->regs.value_reg[value_id] < 0) {
+    emit_sw(reg, offset_by_koopa(value_id));
+  }
 }
 
-void generate_add(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs){
-  generate_bin_riscv("add", lhs, rhs);
+// append an instruction of the given format to the current function
+riscv_inst_t &emit_inst(riscv_fmt_t fmt, const char *op) {
+  ctx->code.emplace_back();
+  riscv_inst_t &inst = ctx->code.back();
+  inst.fmt = fmt;
+  inst.op = op;
+  inst.rd = inst.rs1 = inst.rs2 = nullptr;
+  inst.imm = 0;
+  return inst;
 }
 
-void generate_sub(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("sub", lhs, rhs);
+void emit_r(const char *op, const char *rd, const char *rs1, const char *rs2) {
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_R, op);
+  inst.rd = rd;
+  inst.rs1 = rs1;
+  inst.rs2 = rs2;
 }
 
-void generate_lt(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("slt", lhs, rhs);
+void emit_i(const char *op, const char *rd, const char *rs1, int32_t imm) {
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_I, op);
+  inst.rd = rd;
+  inst.rs1 = rs1;
+  inst.imm = imm;
 }
 
-void generate_gt(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("sgt", lhs, rhs);
+void emit_u(const char *op, const char *rd, const char *rs) {
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_U, op);
+  inst.rd = rd;
+  inst.rs1 = rs;
 }
 
-void generate_le(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("sgt", lhs, rhs);
-  std::cout << "\tseqz " << current_tempreg() << ", " << current_tempreg() << "\n";
+void emit_li(const char *rd, int32_t imm) {
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_LI, "li");
+  inst.rd = rd;
+  inst.imm = imm;
 }
 
-void generate_ge(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("slt", lhs, rhs);
-  std::cout << "\tseqz " << current_tempreg() << ", " << current_tempreg() << "\n";
+// loads and stores address the stack frame; offsets beyond 12 bits go
+// through an address register: rd for loads, the scratch register that is
+// not rs for stores (nothing is parked in t6 in such frames)
+void emit_lw(const char *rd, int32_t offset) {
+  const char *base = "sp";
+  if (!fits_imm12(offset)) {
+    generate_frame_address(rd, offset);
+    base = rd;
+    offset = 0;
+  }
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_LOAD, "lw");
+  inst.rd = rd;
+  inst.rs1 = base;
+  inst.imm = offset;
 }
 
-void generate_and(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("and", lhs, rhs);
+void emit_sw(const char *rs, int32_t offset) {
+  const char *base = "sp";
+  if (!fits_imm12(offset)) {
+    base = same_reg(rs, scratch_reg_lst[1]) ? scratch_reg_lst[0] : scratch_reg_lst[1];
+    generate_frame_address(base, offset);
+    offset = 0;
+  }
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_STORE, "sw");
+  inst.rs1 = base;
+  inst.rs2 = rs;
+  inst.imm = offset;
 }
 
-void generate_or(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  generate_bin_riscv("or", lhs, rhs);
+// rd = sp + offset
+void generate_frame_address(const char *rd, int32_t offset) {
+  emit_li(rd, offset);
+  emit_r("add", rd, rd, "sp");
 }
 
-// helper functions
-void load_value(const koopa_raw_value_t &value) {
-  if (value->kind.tag == KOOPA_RVT_INTEGER) {
-    int constant = value->kind.data.integer.value;
-    std::cout << "\tli ";
-    new_riscv_tempreg();
-    std::cout << ", " << constant << "\n";
-    koopa_tempreg_map[value] = current_tempreg();
+// sp = sp + delta, through the second scratch register if delta needs more than 12 bits
+void generate_sp_adjust(int32_t delta) {
+  if (fits_imm12(delta)) {
+    emit_i("addi", "sp", "sp", delta);
   }
   else {
-    int offset = offset_by_koopa(value);
-    std::cout << "\tlw ";
-    new_riscv_tempreg();
-    std::cout << ", " << offset << "(sp)\n";
-    koopa_tempreg_map[value] = current_tempreg();
+    emit_li(scratch_reg_lst[1], delta);
+    emit_r("add", "sp", "sp", scratch_reg_lst[1]);
+  }
+}
+
+void emit_bz(const char *op, const char *rs, const std::string &label) {
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_BZ, op);
+  inst.rs1 = rs;
+  inst.label = label;
+}
+
+void emit_b(const char *op, const char *rs1, const char *rs2, const std::string &label) {
+  riscv_inst_t &inst = emit_inst(RISCV_FMT_B, op);
+  inst.rs1 = rs1;
+  inst.rs2 = rs2;
+  inst.label = label;
+}
+
+void emit_j(const std::string &label) {
+  emit_inst(RISCV_FMT_J, "j").label = label;
+}
+
+void emit_ret() {
+  emit_inst(RISCV_FMT_RET, "ret");
+}
+
+void emit_label(const std::string &label) {
+  emit_inst(RISCV_FMT_LABEL, nullptr).label = label;
+}
+
+// location of an operand: immediate, allocated register or stack slot
+riscv_loc_t loc_by_koopa(const flat_operand_t &value) {
+  if (value.kind == FLAT_OPD_IMM) {
+    return { RISCV_LOC_IMM, value.value };
+  }
+  int reg = ctx->regs.value_reg[value.value];
+  if (reg >= 0) {
+    return { RISCV_LOC_REG, reg };
   }
+  return { RISCV_LOC_STACK, offset_by_koopa(value.value) };
 }
 
-void new_riscv_tempreg() {
-  assert(used_tempreg_count < TEMPREG_NUM);
-  std::cout << tempreg_lst.at(used_tempreg_count);
-  used_tempreg_count = used_tempreg_count + 1;
+bool same_loc(const riscv_loc_t &a, const riscv_loc_t &b) {
+  return a.kind != RISCV_LOC_IMM && a.kind == b.kind && a.value == b.value;
 }
 
-std::string current_tempreg() {
-  assert(used_tempreg_count >= 1);
-  return tempreg_lst.at(used_tempreg_count - 1);
+// register name of a register location
+const char *loc_reg(const riscv_loc_t &loc) {
+  assert(loc.kind == RISCV_LOC_REG || loc.kind == RISCV_LOC_SCRATCH);
+  return loc.kind == RISCV_LOC_REG ? riscv_reg_lst[loc.value] : scratch_reg_lst[loc.value];
 }
 
-void riscv_by_koopa(const koopa_raw_value_t &value) {
-  if (value->kind.tag == KOOPA_RVT_INTEGER) {
-    if (value->kind.data.integer.value == 0) {
-      std::cout << "x0";
+// dest = src; stack to stack copies go through the first scratch register
+void generate_move(const riscv_loc_t &dest, const riscv_loc_t &src) {
+  if (dest.kind != RISCV_LOC_STACK) {
+    const char *rd = loc_reg(dest);
+    if (src.kind == RISCV_LOC_IMM) {
+      emit_li(rd, src.value);
+    }
+    else if (src.kind == RISCV_LOC_STACK) {
+      emit_lw(rd, src.value);
     }
     else {
-      std::map<koopa_raw_value_t, std::string>::iterator it;
-      it = koopa_tempreg_map.find(value);
-      if (it == koopa_tempreg_map.end()) {
-        assert(false);
-      }
+      emit_u("mv", rd, loc_reg(src));
+    }
+    return;
+  }
+
+  const char *rs = scratch_reg_lst[0];
+  if (src.kind == RISCV_LOC_IMM && src.value == 0) {
+    rs = "x0";
+  }
+  else if (src.kind == RISCV_LOC_IMM) {
+    emit_li(rs, src.value);
+  }
+  else if (src.kind == RISCV_LOC_STACK) {
+    emit_lw(rs, src.value);
+  }
+  else {
+    rs = loc_reg(src);
+  }
+  emit_sw(rs, dest.value);
+}
 
-      std::cout << it->second;
+// rd = rs * imm: shifts and adds for 0, +-1, +-2^k, 2^a + 2^b and 2^a - 2^b,
+// otherwise li + mul (rd may be rs, the second scratch register is free)
+void generate_mul_imm(const char *rd, const char *rs, int32_t imm) {
+  const char *tmp = scratch_reg_lst[1];
+  uint32_t u = static_cast<uint32_t>(imm);
+  uint32_t neg_u = 0u - u;
+  uint32_t low = u & neg_u; // lowest set bit
+  if (imm == 0) {
+    emit_li(rd, 0);
+  }
+  else if (imm == 1) {
+    if (strcmp(rd, rs) != 0) {
+      emit_u("mv", rd, rs);
+    }
+  }
+  else if (imm == -1) {
+    emit_u("neg", rd, rs);
+  }
+  else if ((u & (u - 1)) == 0) {
+    emit_i("slli", rd, rs, log2_u32(u));
+  }
+  else if ((neg_u & (neg_u - 1)) == 0) {
+    emit_i("slli", rd, rs, log2_u32(neg_u));
+    emit_u("neg", rd, rd);
+  }
+  else if (__builtin_popcount(u) == 2) {
+    // 2^a + 2^b, a > b
+    int a = log2_u32(u - low);
+    int b = log2_u32(low);
+    emit_i("slli", tmp, rs, a);
+    if (b > 0) {
+      emit_i("slli", rd, rs, b);
+      emit_r("add", rd, rd, tmp);
+    }
+    else {
+      emit_r("add", rd, rs, tmp);
+    }
+  }
+  else if (imm > 0 && ((u + low) & (u + low - 1)) == 0) {
+    // 2^a - 2^b, a run of ones
+    int a = log2_u32(u + low);
+    int b = log2_u32(low);
+    emit_i("slli", tmp, rs, a);
+    if (b > 0) {
+      emit_i("slli", rd, rs, b);
+      emit_r("sub", rd, tmp, rd);
+    }
+    else {
+      emit_r("sub", rd, tmp, rs);
     }
   }
   else {
-    std::map<koopa_raw_value_t, std::string>::iterator it;
-    it = koopa_tempreg_map.find(value);
-    if (it == koopa_tempreg_map.end()) {
-      assert(false);
+    emit_li(tmp, imm);
+    emit_r("mul", rd, rs, tmp);
+  }
+}
+
+// q = rs / imm (|imm| >= 2), truncating like div: power-of-two shifts or a
+// multiply-high; the second scratch register is clobbered and rs is not
+// read once q is written, so q may be rs
+void generate_quotient(const char *q, const char *rs, int32_t imm) {
+  const char *tmp = scratch_reg_lst[1];
+  uint32_t abs_imm = imm < 0 ? 0u - static_cast<uint32_t>(imm) : static_cast<uint32_t>(imm);
+  if ((abs_imm & (abs_imm - 1)) == 0) {
+    // add 2^k - 1 to negative dividends, then shift
+    int k = log2_u32(abs_imm);
+    generate_round_bias(tmp, rs, k);
+    emit_i("srai", q, tmp, k);
+    if (imm < 0) {
+      emit_u("neg", q, q);
     }
+    return;
+  }
 
-    std::cout << it->second;
+  // high half of rs * magic, corrected and shifted, plus one if negative
+  int32_t magic;
+  int shift;
+  divide_magic(imm, magic, shift);
+  emit_li(tmp, magic);
+  emit_r("mulh", tmp, rs, tmp);
+  if (imm > 0 && magic < 0) {
+    emit_r("add", tmp, tmp, rs);
+  }
+  else if (imm < 0 && magic > 0) {
+    emit_r("sub", tmp, tmp, rs);
+  }
+  if (shift > 0) {
+    emit_i("srai", tmp, tmp, shift);
   }
+  emit_i("srli", q, tmp, 31);
+  emit_r("add", q, tmp, q);
 }
 
-int offset_by_koopa(const koopa_raw_value_t &value) {
-  std::map<koopa_raw_value_t, int>::iterator it;
-  it = koopa_offset_map.find(value);
-  if (it == koopa_offset_map.end()) {
-    assert(false);
-    return 0;
+// rd = rs + (rs < 0 ? 2^k - 1 : 0), 0 < k < 32
+void generate_round_bias(const char *rd, const char *rs, int k) {
+  if (k == 1) {
+    emit_i("srli", rd, rs, 31);
+  }
+  else {
+    emit_i("srai", rd, rs, 31);
+    emit_i("srli", rd, rd, 32 - k);
   }
-  return it->second;
+  emit_r("add", rd, rs, rd);
 }
 
-void generate_bin_riscv(std::string riscv, const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs) {
-  // constant/variables needs to be loaded to tempreg
-  load_value(lhs);
-  load_value(rhs);
+// rd = rs / imm (imm != 0)
+void generate_div_imm(const char *rd, const char *rs, int32_t imm) {
+  if (imm == 1 || imm == -1) {
+    generate_mul_imm(rd, rs, imm);
+  }
+  else {
+    generate_quotient(rd, rs, imm);
+  }
+}
+
+// rd = rs % imm (imm != 0), rs - rs / imm * imm
+void generate_mod_imm(const char *rd, const char *rs, int32_t imm) {
+  const char *tmp = scratch_reg_lst[1];
+  uint32_t abs_imm = imm < 0 ? 0u - static_cast<uint32_t>(imm) : static_cast<uint32_t>(imm);
+  if (abs_imm == 1) {
+    emit_li(rd, 0);
+    return;
+  }
+  if ((abs_imm & (abs_imm - 1)) == 0) {
+    // clear the low k bits of the biased dividend
+    int k = log2_u32(abs_imm);
+    generate_round_bias(tmp, rs, k);
+    if (k <= 11) {
+      emit_i("andi", tmp, tmp, -(1 << k));
+    }
+    else {
+      emit_i("srai", tmp, tmp, k);
+      emit_i("slli", tmp, tmp, k);
+    }
+    emit_r("sub", rd, rs, tmp);
+    return;
+  }
+
+  // rs stays live until the final sub, so the quotient needs a register of
+  // its own: rd if it is not rs, else the first scratch register if rs is
+  // not in it (a spilled result of a spilled operand falls back to rem)
+  const char *q = strcmp(rd, rs) != 0 ? rd : strcmp(rs, scratch_reg_lst[0]) != 0 ? scratch_reg_lst[0] : nullptr;
+  if (!q) {
+    emit_li(tmp, imm);
+    emit_r("rem", rd, rs, tmp);
+    return;
+  }
+  generate_quotient(q, rs, imm);
+  generate_mul_imm(q, q, imm);
+  emit_r("sub", rd, rs, q);
+}
 
-  // release all tempregs
-  used_tempreg_count = used_tempreg_count - 2;
+// magic number and shift of signed division by d (|d| >= 2, not a power of two),
+// Hacker's Delight 10-1
+void divide_magic(int32_t d, int32_t &magic, int &shift) {
+  const uint32_t two31 = 0x80000000u;
+  uint32_t ad = d < 0 ? 0u - static_cast<uint32_t>(d) : static_cast<uint32_t>(d);
+  uint32_t t = two31 + (static_cast<uint32_t>(d) >> 31);
+  uint32_t anc = t - 1 - t % ad;
+  int p = 31;
+  uint32_t q1 = two31 / anc, r1 = two31 - q1 * anc;
+  uint32_t q2 = two31 / ad, r2 = two31 - q2 * ad;
+  uint32_t delta;
+  do {
+    p = p + 1;
+    q1 = 2 * q1;
+    r1 = 2 * r1;
+    if (r1 >= anc) {
+      q1 = q1 + 1;
+      r1 = r1 - anc;
+    }
+    q2 = 2 * q2;
+    r2 = 2 * r2;
+    if (r2 >= ad) {
+      q2 = q2 + 1;
+      r2 = r2 - ad;
+    }
+    delta = ad - r2;
+  } while (q1 < delta || (q1 == delta && r1 == 0));
+  uint32_t m = q2 + 1;
+  magic = static_cast<int32_t>(d < 0 ? 0u - m : m);
+  shift = p - 32;
+}
 
-  // riscv code for binary op
-  std::cout << "\t" << riscv << " ";
-  new_riscv_tempreg();
-  std::cout << ", ";
-  riscv_by_koopa(lhs);
-  std::cout << ", ";
-  riscv_by_koopa(rhs);
-  std::cout << "\n";
+// floor(log2(u)), u > 0
+int log2_u32(uint32_t u) {
+  return 31 - __builtin_clz(u);
 }
 
-std::string set_visit_mode (std::string new_mode) {
-  std::string old_mode = visit_mode;
-  visit_mode = new_mode;
-  return old_mode;
+int offset_by_koopa(int value_id) {
+  int offset = ctx->value_offset[value_id];
+  assert(offset >= 0);
+  return offset;
 }
 
-void reset_visit_mode (std::string old_mode) {
-  visit_mode = old_mode;
+void generate_bin_riscv(const char *riscv, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs) {
+  // constants and spilled values go through the scratch registers
+  const char *lreg = load_value(lhs, scratch_reg_lst[0]);
+  const char *rreg = load_value(rhs, scratch_reg_lst[1]);
+
+  // riscv code for binary op
+  emit_r(riscv, rd, lreg, rreg);
 }
 
 // [example]
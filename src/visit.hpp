@@ -1,45 +1,146 @@
 #pragma once
 
 #include "koopa.h"
+#include "flatir.hpp"
+#include "emitter.hpp"
+#include "regalloc.hpp"
+#include "machine.hpp"
+#include <utility>
 #include <vector>
 
+// where a value is during block args copies
+enum riscv_loc_kind_t {
+  RISCV_LOC_IMM,     // integer constant
+  RISCV_LOC_REG,     // allocated register (index into riscv_reg_lst)
+  RISCV_LOC_SCRATCH, // scratch register (index into scratch_reg_lst)
+  RISCV_LOC_STACK,   // stack slot (offset from sp)
+};
+
+typedef struct {
+  riscv_loc_kind_t kind;
+  int32_t value;
+} riscv_loc_t;
+
+// backend state of one Visit(program) call
+struct riscv_context_t {
+  // output of the current program
+  Emitter *out = nullptr;
+
+  // current function in flat (dense index) form
+  flat_function_t cur_func;
+
+  // register of every value of the current function
+  reg_assignment_t regs;
+
+  // side table: value id -> stack offset (-1 if the value has no stack slot)
+  std::vector<int> value_offset;
+
+  // callee-saved registers used by the current function: (register, stack offset)
+  std::vector<std::pair<int, int>> saved_regs;
+
+  // stack space needed to alloc for current funtion
+  int stack_s = 0;
+
+  // slot that breaks block argument cycles when the frame needs offsets beyond
+  // 12 bits and stores need the scratch registers as addresses (-1: park in t6)
+  int park_offset = -1;
+
+  // machine code of the current function, printed after the peephole pass
+  std::vector<riscv_inst_t> code;
+};
+
+// operand constraints of an instruction selection rule
+enum riscv_shape_t {
+  SHAPE_ANY,       // any operand, taken in a register
+  SHAPE_IMM,       // constant
+  SHAPE_ZERO,      // constant 0
+  SHAPE_NONZERO,   // constant other than 0
+  SHAPE_IMM12,     // constant fitting a 12-bit immediate
+  SHAPE_NEG_IMM12, // constant whose negation fits
+  SHAPE_INC_IMM12, // constant whose successor fits
+};
+
+// instruction selection rule: a binary node with operand shapes
+struct riscv_rule_t {
+  koopa_raw_binary_op_t op;
+  riscv_shape_t lhs;
+  riscv_shape_t rhs;
+  int cost;          // instructions, without operand loads
+  const char *riscv; // mnemonic passed to emit
+  const char *then;  // unary op applied to the result afterwards (nullptr if none)
+  void (*emit)(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+};
+
 // basic visit
-void Visit(const koopa_raw_program_t &program);
+void Visit(const koopa_raw_program_t &program, Emitter &emitter);
 void Visit(const koopa_raw_slice_t &slice);
 void Visit(const koopa_raw_function_t &func);
-void Visit(const koopa_raw_basic_block_t &bb);
-void Visit(const koopa_raw_value_t &value);
-
-// value visit
-void Visit(const koopa_raw_return_t &ret);
-void Visit(const koopa_raw_integer_t &integer);
-void Visit(const koopa_raw_binary_t &binary);
-void Visit(const koopa_raw_store_t &store);
-void Visit(const koopa_raw_load_t &load);
-void Visit(const koopa_raw_branch_t &branch);
-void Visit(const koopa_raw_jump_t &jump);
-
-// generate riscv code for binary ops
-void generate_eq(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_neq(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_mul(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_div(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_mod(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_add(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_sub(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_lt(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_gt(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_le(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_ge(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_and(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-void generate_or(const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
+void Visit(const flat_block_t &bb);
+void Visit(const flat_inst_t &inst);
+
+// backend context of this thread (Visit(program) installs its own;
+// needed to drive the per-function/instruction entry points directly)
+riscv_context_t *set_riscv_context(riscv_context_t *new_ctx);
+
+// stack pre-pass (after register allocation)
+void allocate_stack();
+
+// instruction visit
+void generate_ret(const flat_inst_t &inst);
+void generate_binary(const flat_inst_t &inst);
+void generate_store(const flat_inst_t &inst);
+void generate_load(const flat_inst_t &inst);
+void generate_branch(const flat_inst_t &inst);
+void generate_jump(const flat_inst_t &inst);
+void generate_cond_branch(const flat_inst_t &inst, bool negate, const std::string &label);
+void generate_block_args(const flat_inst_t &inst, int target);
+
+// instruction selection for binary ops
+void select_binary(const char *rd, koopa_raw_binary_op_t op, const flat_operand_t &lhs, const flat_operand_t &rhs);
+bool swapped_op(koopa_raw_binary_op_t op, koopa_raw_binary_op_t &swapped);
+bool match_shape(riscv_shape_t shape, const flat_operand_t &opd);
+int operand_cost(riscv_shape_t shape, const flat_operand_t &opd);
+void select_r(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_r_swap(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_i(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_i_neg(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_i_inc(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_u(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_shift_imm(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_mul_imm(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_div_imm(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void select_mod_imm(const riscv_rule_t &rule, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
 
 // helper functions
-void load_value(const koopa_raw_value_t &value);
-void new_riscv_tempreg();
-std::string current_tempreg();
-void riscv_by_koopa(const koopa_raw_value_t &value);
-int offset_by_koopa(const koopa_raw_value_t &value);
-void generate_bin_riscv(std::string riscv, const koopa_raw_value_t &lhs, const koopa_raw_value_t &rhs);
-std::string set_visit_mode (std::string new_mode);
-void reset_visit_mode (std::string old_mode);
\ No newline at end of file
+riscv_inst_t &emit_inst(riscv_fmt_t fmt, const char *op);
+void emit_r(const char *op, const char *rd, const char *rs1, const char *rs2);
+void emit_i(const char *op, const char *rd, const char *rs1, int32_t imm);
+void emit_u(const char *op, const char *rd, const char *rs);
+void emit_li(const char *rd, int32_t imm);
+void emit_lw(const char *rd, int32_t offset);
+void emit_sw(const char *rs, int32_t offset);
+void generate_frame_address(const char *rd, int32_t offset);
+void generate_sp_adjust(int32_t delta);
+void emit_bz(const char *op, const char *rs, const std::string &label);
+void emit_b(const char *op, const char *rs1, const char *rs2, const std::string &label);
+void emit_j(const std::string &label);
+void emit_ret();
+void emit_label(const std::string &label);
+const char *load_value(const flat_operand_t &value, const char *scratch);
+bool fused_compare(int value_id);
+koopa_raw_binary_op_t inverse_compare_op(koopa_raw_binary_op_t op);
+const char *result_reg(int value_id);
+void save_result(int value_id, const char *reg);
+int offset_by_koopa(int value_id);
+riscv_loc_t loc_by_koopa(const flat_operand_t &value);
+bool same_loc(const riscv_loc_t &a, const riscv_loc_t &b);
+const char *loc_reg(const riscv_loc_t &loc);
+void generate_move(const riscv_loc_t &dest, const riscv_loc_t &src);
+void generate_bin_riscv(const char *riscv, const char *rd, const flat_operand_t &lhs, const flat_operand_t &rhs);
+void generate_mul_imm(const char *rd, const char *rs, int32_t imm);
+void generate_div_imm(const char *rd, const char *rs, int32_t imm);
+void generate_mod_imm(const char *rd, const char *rs, int32_t imm);
+void generate_quotient(const char *q, const char *rs, int32_t imm);
+void generate_round_bias(const char *rd, const char *rs, int k);
+void divide_magic(int32_t d, int32_t &magic, int &shift);
+int log2_u32(uint32_t u);
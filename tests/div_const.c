@@ -0,0 +1,178 @@
+// return: 160
+// division and remainder by constants (strength-reduced): powers of two,
+// other constants, negative divisors and dividends, INT_MIN / -1
+int main() {
+  int n = 0;
+  while (n < 3) n = n + 1;
+  int z = n - 3;
+  int x = z;
+  x = z + 7;
+  if (x / 8 != 0) return 1;
+  if (x % 8 != 7) return 2;
+  if (x / (-8) != 0) return 3;
+  if (x % (-8) != 7) return 4;
+  if (x / 2 != 3) return 5;
+  if (x % 2 != 1) return 6;
+  if (x / 1024 != 0) return 7;
+  if (x % 1024 != 7) return 8;
+  if (x / 1073741824 != 0) return 9;
+  if (x % 1073741824 != 7) return 10;
+  if (x / 7 != 1) return 11;
+  if (x % 7 != 0) return 12;
+  if (x / (-7) != (-1)) return 13;
+  if (x % (-7) != 0) return 14;
+  if (x / 3 != 2) return 15;
+  if (x % 3 != 1) return 16;
+  if (x / 10 != 0) return 17;
+  if (x % 10 != 7) return 18;
+  if (x / (-1) != (-7)) return 19;
+  if (x % (-1) != 0) return 20;
+  x = z + (-7);
+  if (x / 8 != 0) return 21;
+  if (x % 8 != (-7)) return 22;
+  if (x / (-8) != 0) return 23;
+  if (x % (-8) != (-7)) return 24;
+  if (x / 2 != (-3)) return 25;
+  if (x % 2 != (-1)) return 26;
+  if (x / 1024 != 0) return 27;
+  if (x % 1024 != (-7)) return 28;
+  if (x / 1073741824 != 0) return 29;
+  if (x % 1073741824 != (-7)) return 30;
+  if (x / 7 != (-1)) return 31;
+  if (x % 7 != 0) return 32;
+  if (x / (-7) != 1) return 33;
+  if (x % (-7) != 0) return 34;
+  if (x / 3 != (-2)) return 35;
+  if (x % 3 != (-1)) return 36;
+  if (x / 10 != 0) return 37;
+  if (x % 10 != (-7)) return 38;
+  if (x / (-1) != 7) return 39;
+  if (x % (-1) != 0) return 40;
+  x = z + 9;
+  if (x / 8 != 1) return 41;
+  if (x % 8 != 1) return 42;
+  if (x / (-8) != (-1)) return 43;
+  if (x % (-8) != 1) return 44;
+  if (x / 2 != 4) return 45;
+  if (x % 2 != 1) return 46;
+  if (x / 1024 != 0) return 47;
+  if (x % 1024 != 9) return 48;
+  if (x / 1073741824 != 0) return 49;
+  if (x % 1073741824 != 9) return 50;
+  if (x / 7 != 1) return 51;
+  if (x % 7 != 2) return 52;
+  if (x / (-7) != (-1)) return 53;
+  if (x % (-7) != 2) return 54;
+  if (x / 3 != 3) return 55;
+  if (x % 3 != 0) return 56;
+  if (x / 10 != 0) return 57;
+  if (x % 10 != 9) return 58;
+  if (x / (-1) != (-9)) return 59;
+  if (x % (-1) != 0) return 60;
+  x = z + (-9);
+  if (x / 8 != (-1)) return 61;
+  if (x % 8 != (-1)) return 62;
+  if (x / (-8) != 1) return 63;
+  if (x % (-8) != (-1)) return 64;
+  if (x / 2 != (-4)) return 65;
+  if (x % 2 != (-1)) return 66;
+  if (x / 1024 != 0) return 67;
+  if (x % 1024 != (-9)) return 68;
+  if (x / 1073741824 != 0) return 69;
+  if (x % 1073741824 != (-9)) return 70;
+  if (x / 7 != (-1)) return 71;
+  if (x % 7 != (-2)) return 72;
+  if (x / (-7) != 1) return 73;
+  if (x % (-7) != (-2)) return 74;
+  if (x / 3 != (-3)) return 75;
+  if (x % 3 != 0) return 76;
+  if (x / 10 != 0) return 77;
+  if (x % 10 != (-9)) return 78;
+  if (x / (-1) != 9) return 79;
+  if (x % (-1) != 0) return 80;
+  x = z + 1000;
+  if (x / 8 != 125) return 81;
+  if (x % 8 != 0) return 82;
+  if (x / (-8) != (-125)) return 83;
+  if (x % (-8) != 0) return 84;
+  if (x / 2 != 500) return 85;
+  if (x % 2 != 0) return 86;
+  if (x / 1024 != 0) return 87;
+  if (x % 1024 != 1000) return 88;
+  if (x / 1073741824 != 0) return 89;
+  if (x % 1073741824 != 1000) return 90;
+  if (x / 7 != 142) return 91;
+  if (x % 7 != 6) return 92;
+  if (x / (-7) != (-142)) return 93;
+  if (x % (-7) != 6) return 94;
+  if (x / 3 != 333) return 95;
+  if (x % 3 != 1) return 96;
+  if (x / 10 != 100) return 97;
+  if (x % 10 != 0) return 98;
+  if (x / (-1) != (-1000)) return 99;
+  if (x % (-1) != 0) return 100;
+  x = z + (-1000);
+  if (x / 8 != (-125)) return 101;
+  if (x % 8 != 0) return 102;
+  if (x / (-8) != 125) return 103;
+  if (x % (-8) != 0) return 104;
+  if (x / 2 != (-500)) return 105;
+  if (x % 2 != 0) return 106;
+  if (x / 1024 != 0) return 107;
+  if (x % 1024 != (-1000)) return 108;
+  if (x / 1073741824 != 0) return 109;
+  if (x % 1073741824 != (-1000)) return 110;
+  if (x / 7 != (-142)) return 111;
+  if (x % 7 != (-6)) return 112;
+  if (x / (-7) != 142) return 113;
+  if (x % (-7) != (-6)) return 114;
+  if (x / 3 != (-333)) return 115;
+  if (x % 3 != (-1)) return 116;
+  if (x / 10 != (-100)) return 117;
+  if (x % 10 != 0) return 118;
+  if (x / (-1) != 1000) return 119;
+  if (x % (-1) != 0) return 120;
+  x = z + 2147483647;
+  if (x / 8 != 268435455) return 121;
+  if (x % 8 != 7) return 122;
+  if (x / (-8) != (-268435455)) return 123;
+  if (x % (-8) != 7) return 124;
+  if (x / 2 != 1073741823) return 125;
+  if (x % 2 != 1) return 126;
+  if (x / 1024 != 2097151) return 127;
+  if (x % 1024 != 1023) return 128;
+  if (x / 1073741824 != 1) return 129;
+  if (x % 1073741824 != 1073741823) return 130;
+  if (x / 7 != 306783378) return 131;
+  if (x % 7 != 1) return 132;
+  if (x / (-7) != (-306783378)) return 133;
+  if (x % (-7) != 1) return 134;
+  if (x / 3 != 715827882) return 135;
+  if (x % 3 != 1) return 136;
+  if (x / 10 != 214748364) return 137;
+  if (x % 10 != 7) return 138;
+  if (x / (-1) != (-2147483647)) return 139;
+  if (x % (-1) != 0) return 140;
+  x = z + (-2147483647 - 1);
+  if (x / 8 != (-268435456)) return 141;
+  if (x % 8 != 0) return 142;
+  if (x / (-8) != 268435456) return 143;
+  if (x % (-8) != 0) return 144;
+  if (x / 2 != (-1073741824)) return 145;
+  if (x % 2 != 0) return 146;
+  if (x / 1024 != (-2097152)) return 147;
+  if (x % 1024 != 0) return 148;
+  if (x / 1073741824 != (-2)) return 149;
+  if (x % 1073741824 != 0) return 150;
+  if (x / 7 != (-306783378)) return 151;
+  if (x % 7 != (-2)) return 152;
+  if (x / (-7) != 306783378) return 153;
+  if (x % (-7) != (-2)) return 154;
+  if (x / 3 != (-715827882)) return 155;
+  if (x % 3 != (-2)) return 156;
+  if (x / 10 != (-214748364)) return 157;
+  if (x % 10 != (-8)) return 158;
+  if (x / (-1) != (-2147483647 - 1)) return 159;
+  if (x % (-1) != 0) return 160;
+  return 160;
+}
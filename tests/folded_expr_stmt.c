@@ -0,0 +1,9 @@
+// return: 7
+// expression statements folded to a constant must not leak their value
+int main() {
+  int a = 3, b = 4;
+  (1 + 1);
+  a = a;
+  (a * 0);
+  return a + b;
+}
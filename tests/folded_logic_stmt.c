@@ -0,0 +1,11 @@
+// return: 5
+// && and || folded by their constant left operand in expression statements
+int main() {
+  int a = 2, b = 3;
+  (1 && 1);
+  a = a;
+  (0 || 1);
+  b = b;
+  (0 && a);
+  return a + b;
+}
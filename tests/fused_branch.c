@@ -0,0 +1,254 @@
+// return: 126
+// comparisons used only by the branch after them are fused into it: every
+// compare op on registers, against 0 and against constants, in if and while
+int main() {
+  int n = 0;
+  while (n < 3) n = n + 1;
+  int z = n - 3;
+  int x = z;
+  int y = z;
+  int i = z;
+  x = z + 1;
+  y = z + 2;
+  if (!(x < y)) return 1;
+  if (x < 2) i = 1; else i = 2;
+  if (i != 1) return 2;
+  if (x > y) return 3;
+  if (x > 2) i = 1; else i = 2;
+  if (i != 2) return 4;
+  if (!(x <= y)) return 5;
+  if (x <= 2) i = 1; else i = 2;
+  if (i != 1) return 6;
+  if (x >= y) return 7;
+  if (x >= 2) i = 1; else i = 2;
+  if (i != 2) return 8;
+  if (x == y) return 9;
+  if (x == 2) i = 1; else i = 2;
+  if (i != 2) return 10;
+  if (!(x != y)) return 11;
+  if (x != 2) i = 1; else i = 2;
+  if (i != 1) return 12;
+  x = z + 2;
+  y = z + 1;
+  if (x < y) return 13;
+  if (x < 1) i = 1; else i = 2;
+  if (i != 2) return 14;
+  if (!(x > y)) return 15;
+  if (x > 1) i = 1; else i = 2;
+  if (i != 1) return 16;
+  if (x <= y) return 17;
+  if (x <= 1) i = 1; else i = 2;
+  if (i != 2) return 18;
+  if (!(x >= y)) return 19;
+  if (x >= 1) i = 1; else i = 2;
+  if (i != 1) return 20;
+  if (x == y) return 21;
+  if (x == 1) i = 1; else i = 2;
+  if (i != 2) return 22;
+  if (!(x != y)) return 23;
+  if (x != 1) i = 1; else i = 2;
+  if (i != 1) return 24;
+  x = z + 3;
+  y = z + 3;
+  if (x < y) return 25;
+  if (x < 3) i = 1; else i = 2;
+  if (i != 2) return 26;
+  if (x > y) return 27;
+  if (x > 3) i = 1; else i = 2;
+  if (i != 2) return 28;
+  if (!(x <= y)) return 29;
+  if (x <= 3) i = 1; else i = 2;
+  if (i != 1) return 30;
+  if (!(x >= y)) return 31;
+  if (x >= 3) i = 1; else i = 2;
+  if (i != 1) return 32;
+  if (!(x == y)) return 33;
+  if (x == 3) i = 1; else i = 2;
+  if (i != 1) return 34;
+  if (x != y) return 35;
+  if (x != 3) i = 1; else i = 2;
+  if (i != 2) return 36;
+  x = z + (-5);
+  y = z + 4;
+  if (!(x < y)) return 37;
+  if (x < 4) i = 1; else i = 2;
+  if (i != 1) return 38;
+  if (x > y) return 39;
+  if (x > 4) i = 1; else i = 2;
+  if (i != 2) return 40;
+  if (!(x <= y)) return 41;
+  if (x <= 4) i = 1; else i = 2;
+  if (i != 1) return 42;
+  if (x >= y) return 43;
+  if (x >= 4) i = 1; else i = 2;
+  if (i != 2) return 44;
+  if (x == y) return 45;
+  if (x == 4) i = 1; else i = 2;
+  if (i != 2) return 46;
+  if (!(x != y)) return 47;
+  if (x != 4) i = 1; else i = 2;
+  if (i != 1) return 48;
+  x = z + 4;
+  y = z + (-5);
+  if (x < y) return 49;
+  if (x < (-5)) i = 1; else i = 2;
+  if (i != 2) return 50;
+  if (!(x > y)) return 51;
+  if (x > (-5)) i = 1; else i = 2;
+  if (i != 1) return 52;
+  if (x <= y) return 53;
+  if (x <= (-5)) i = 1; else i = 2;
+  if (i != 2) return 54;
+  if (!(x >= y)) return 55;
+  if (x >= (-5)) i = 1; else i = 2;
+  if (i != 1) return 56;
+  if (x == y) return 57;
+  if (x == (-5)) i = 1; else i = 2;
+  if (i != 2) return 58;
+  if (!(x != y)) return 59;
+  if (x != (-5)) i = 1; else i = 2;
+  if (i != 1) return 60;
+  x = z + (-6);
+  y = z + (-6);
+  if (x < y) return 61;
+  if (x < (-6)) i = 1; else i = 2;
+  if (i != 2) return 62;
+  if (x > y) return 63;
+  if (x > (-6)) i = 1; else i = 2;
+  if (i != 2) return 64;
+  if (!(x <= y)) return 65;
+  if (x <= (-6)) i = 1; else i = 2;
+  if (i != 1) return 66;
+  if (!(x >= y)) return 67;
+  if (x >= (-6)) i = 1; else i = 2;
+  if (i != 1) return 68;
+  if (!(x == y)) return 69;
+  if (x == (-6)) i = 1; else i = 2;
+  if (i != 1) return 70;
+  if (x != y) return 71;
+  if (x != (-6)) i = 1; else i = 2;
+  if (i != 2) return 72;
+  x = z + (-2147483647 - 1);
+  y = z + 2147483647;
+  if (!(x < y)) return 73;
+  if (x < 2147483647) i = 1; else i = 2;
+  if (i != 1) return 74;
+  if (x > y) return 75;
+  if (x > 2147483647) i = 1; else i = 2;
+  if (i != 2) return 76;
+  if (!(x <= y)) return 77;
+  if (x <= 2147483647) i = 1; else i = 2;
+  if (i != 1) return 78;
+  if (x >= y) return 79;
+  if (x >= 2147483647) i = 1; else i = 2;
+  if (i != 2) return 80;
+  if (x == y) return 81;
+  if (x == 2147483647) i = 1; else i = 2;
+  if (i != 2) return 82;
+  if (!(x != y)) return 83;
+  if (x != 2147483647) i = 1; else i = 2;
+  if (i != 1) return 84;
+  x = z + 0;
+  y = z + 0;
+  if (x < y) return 85;
+  if (x < 0) i = 1; else i = 2;
+  if (i != 2) return 86;
+  if (x > y) return 87;
+  if (x > 0) i = 1; else i = 2;
+  if (i != 2) return 88;
+  if (!(x <= y)) return 89;
+  if (x <= 0) i = 1; else i = 2;
+  if (i != 1) return 90;
+  if (!(x >= y)) return 91;
+  if (x >= 0) i = 1; else i = 2;
+  if (i != 1) return 92;
+  if (!(x == y)) return 93;
+  if (x == 0) i = 1; else i = 2;
+  if (i != 1) return 94;
+  if (x != y) return 95;
+  if (x != 0) i = 1; else i = 2;
+  if (i != 2) return 96;
+  x = z + 0;
+  y = z + (-1);
+  if (x < y) return 97;
+  if (x < (-1)) i = 1; else i = 2;
+  if (i != 2) return 98;
+  if (!(x > y)) return 99;
+  if (x > (-1)) i = 1; else i = 2;
+  if (i != 1) return 100;
+  if (x <= y) return 101;
+  if (x <= (-1)) i = 1; else i = 2;
+  if (i != 2) return 102;
+  if (!(x >= y)) return 103;
+  if (x >= (-1)) i = 1; else i = 2;
+  if (i != 1) return 104;
+  if (x == y) return 105;
+  if (x == (-1)) i = 1; else i = 2;
+  if (i != 2) return 106;
+  if (!(x != y)) return 107;
+  if (x != (-1)) i = 1; else i = 2;
+  if (i != 1) return 108;
+  x = z + (-1);
+  y = z + 0;
+  if (!(x < y)) return 109;
+  if (x < 0) i = 1; else i = 2;
+  if (i != 1) return 110;
+  if (x > y) return 111;
+  if (x > 0) i = 1; else i = 2;
+  if (i != 2) return 112;
+  if (!(x <= y)) return 113;
+  if (x <= 0) i = 1; else i = 2;
+  if (i != 1) return 114;
+  if (x >= y) return 115;
+  if (x >= 0) i = 1; else i = 2;
+  if (i != 2) return 116;
+  if (x == y) return 117;
+  if (x == 0) i = 1; else i = 2;
+  if (i != 2) return 118;
+  if (!(x != y)) return 119;
+  if (x != 0) i = 1; else i = 2;
+  if (i != 1) return 120;
+  i = z + 0;
+  x = z;
+  while (i < 5) {
+    i = i + 1;
+    x = x + 1;
+  }
+  if (x != 5) return 121;
+  i = z + 0;
+  x = z;
+  while (i <= 5) {
+    i = i + 1;
+    x = x + 1;
+  }
+  if (x != 6) return 122;
+  i = z + 5;
+  x = z;
+  while (i > 0) {
+    i = i + (-1);
+    x = x + 1;
+  }
+  if (x != 5) return 123;
+  i = z + 5;
+  x = z;
+  while (i >= 0) {
+    i = i + (-1);
+    x = x + 1;
+  }
+  if (x != 6) return 124;
+  i = z + 0;
+  x = z;
+  while (i != 5) {
+    i = i + 1;
+    x = x + 1;
+  }
+  if (x != 5) return 125;
+  i = z + 0;
+  x = z;
+  while (i == 0) {
+    i = i + 1;
+    x = x + 1;
+  }
+  if (x != 1) return 126;
+  return 126;
+}
@@ -0,0 +1,723 @@
+// return: 96
+// immediates at the 12-bit boundaries (2047/2048, -2048/-2049), comparisons
+// whose constant is adjusted by one (x <= 2047, x > 2147483647), results kept in variables
+int main() {
+  int n = 0;
+  while (n < 3) n = n + 1;
+  int z = n - 3;
+  int x = z;
+  int r = z;
+  x = z + 0;
+  r = x + 2047;
+  if (r != 2047) return 1;
+  r = x - 2047;
+  if (r != (-2047)) return 2;
+  r = x < 2047;
+  if (r != 1) return 3;
+  r = x > 2047;
+  if (r != 0) return 4;
+  r = x <= 2047;
+  if (r != 1) return 5;
+  r = x >= 2047;
+  if (r != 0) return 6;
+  r = x == 2047;
+  if (r != 0) return 7;
+  r = x != 2047;
+  if (r != 1) return 8;
+  r = x + 2048;
+  if (r != 2048) return 9;
+  r = x - 2048;
+  if (r != (-2048)) return 10;
+  r = x < 2048;
+  if (r != 1) return 11;
+  r = x > 2048;
+  if (r != 0) return 12;
+  r = x <= 2048;
+  if (r != 1) return 13;
+  r = x >= 2048;
+  if (r != 0) return 14;
+  r = x == 2048;
+  if (r != 0) return 15;
+  r = x != 2048;
+  if (r != 1) return 16;
+  r = x + (-2048);
+  if (r != (-2048)) return 17;
+  r = x - (-2048);
+  if (r != 2048) return 18;
+  r = x < (-2048);
+  if (r != 0) return 19;
+  r = x > (-2048);
+  if (r != 1) return 20;
+  r = x <= (-2048);
+  if (r != 0) return 21;
+  r = x >= (-2048);
+  if (r != 1) return 22;
+  r = x == (-2048);
+  if (r != 0) return 23;
+  r = x != (-2048);
+  if (r != 1) return 24;
+  r = x + (-2049);
+  if (r != (-2049)) return 25;
+  r = x - (-2049);
+  if (r != 2049) return 26;
+  r = x < (-2049);
+  if (r != 0) return 27;
+  r = x > (-2049);
+  if (r != 1) return 28;
+  r = x <= (-2049);
+  if (r != 0) return 29;
+  r = x >= (-2049);
+  if (r != 1) return 30;
+  r = x == (-2049);
+  if (r != 0) return 31;
+  r = x != (-2049);
+  if (r != 1) return 32;
+  r = x < 2147483647;
+  if (r != 1) return 33;
+  r = x > 2147483647;
+  if (r != 0) return 34;
+  r = x <= 2147483647;
+  if (r != 1) return 35;
+  r = x >= 2147483647;
+  if (r != 0) return 36;
+  r = x == 2147483647;
+  if (r != 0) return 37;
+  r = x != 2147483647;
+  if (r != 1) return 38;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 39;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 40;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 41;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 42;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 43;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 44;
+  x = z + 2046;
+  r = x + 2047;
+  if (r != 4093) return 45;
+  r = x - 2047;
+  if (r != (-1)) return 46;
+  r = x < 2047;
+  if (r != 1) return 47;
+  r = x > 2047;
+  if (r != 0) return 48;
+  r = x <= 2047;
+  if (r != 1) return 49;
+  r = x >= 2047;
+  if (r != 0) return 50;
+  r = x == 2047;
+  if (r != 0) return 51;
+  r = x != 2047;
+  if (r != 1) return 52;
+  r = x + 2048;
+  if (r != 4094) return 53;
+  r = x - 2048;
+  if (r != (-2)) return 54;
+  r = x < 2048;
+  if (r != 1) return 55;
+  r = x > 2048;
+  if (r != 0) return 56;
+  r = x <= 2048;
+  if (r != 1) return 57;
+  r = x >= 2048;
+  if (r != 0) return 58;
+  r = x == 2048;
+  if (r != 0) return 59;
+  r = x != 2048;
+  if (r != 1) return 60;
+  r = x + (-2048);
+  if (r != (-2)) return 61;
+  r = x - (-2048);
+  if (r != 4094) return 62;
+  r = x < (-2048);
+  if (r != 0) return 63;
+  r = x > (-2048);
+  if (r != 1) return 64;
+  r = x <= (-2048);
+  if (r != 0) return 65;
+  r = x >= (-2048);
+  if (r != 1) return 66;
+  r = x == (-2048);
+  if (r != 0) return 67;
+  r = x != (-2048);
+  if (r != 1) return 68;
+  r = x + (-2049);
+  if (r != (-3)) return 69;
+  r = x - (-2049);
+  if (r != 4095) return 70;
+  r = x < (-2049);
+  if (r != 0) return 71;
+  r = x > (-2049);
+  if (r != 1) return 72;
+  r = x <= (-2049);
+  if (r != 0) return 73;
+  r = x >= (-2049);
+  if (r != 1) return 74;
+  r = x == (-2049);
+  if (r != 0) return 75;
+  r = x != (-2049);
+  if (r != 1) return 76;
+  r = x < 2147483647;
+  if (r != 1) return 77;
+  r = x > 2147483647;
+  if (r != 0) return 78;
+  r = x <= 2147483647;
+  if (r != 1) return 79;
+  r = x >= 2147483647;
+  if (r != 0) return 80;
+  r = x == 2147483647;
+  if (r != 0) return 81;
+  r = x != 2147483647;
+  if (r != 1) return 82;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 83;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 84;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 85;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 86;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 87;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 88;
+  x = z + 2047;
+  r = x + 2047;
+  if (r != 4094) return 89;
+  r = x - 2047;
+  if (r != 0) return 90;
+  r = x < 2047;
+  if (r != 0) return 91;
+  r = x > 2047;
+  if (r != 0) return 92;
+  r = x <= 2047;
+  if (r != 1) return 93;
+  r = x >= 2047;
+  if (r != 1) return 94;
+  r = x == 2047;
+  if (r != 1) return 95;
+  r = x != 2047;
+  if (r != 0) return 96;
+  r = x + 2048;
+  if (r != 4095) return 97;
+  r = x - 2048;
+  if (r != (-1)) return 98;
+  r = x < 2048;
+  if (r != 1) return 99;
+  r = x > 2048;
+  if (r != 0) return 100;
+  r = x <= 2048;
+  if (r != 1) return 101;
+  r = x >= 2048;
+  if (r != 0) return 102;
+  r = x == 2048;
+  if (r != 0) return 103;
+  r = x != 2048;
+  if (r != 1) return 104;
+  r = x + (-2048);
+  if (r != (-1)) return 105;
+  r = x - (-2048);
+  if (r != 4095) return 106;
+  r = x < (-2048);
+  if (r != 0) return 107;
+  r = x > (-2048);
+  if (r != 1) return 108;
+  r = x <= (-2048);
+  if (r != 0) return 109;
+  r = x >= (-2048);
+  if (r != 1) return 110;
+  r = x == (-2048);
+  if (r != 0) return 111;
+  r = x != (-2048);
+  if (r != 1) return 112;
+  r = x + (-2049);
+  if (r != (-2)) return 113;
+  r = x - (-2049);
+  if (r != 4096) return 114;
+  r = x < (-2049);
+  if (r != 0) return 115;
+  r = x > (-2049);
+  if (r != 1) return 116;
+  r = x <= (-2049);
+  if (r != 0) return 117;
+  r = x >= (-2049);
+  if (r != 1) return 118;
+  r = x == (-2049);
+  if (r != 0) return 119;
+  r = x != (-2049);
+  if (r != 1) return 120;
+  r = x < 2147483647;
+  if (r != 1) return 121;
+  r = x > 2147483647;
+  if (r != 0) return 122;
+  r = x <= 2147483647;
+  if (r != 1) return 123;
+  r = x >= 2147483647;
+  if (r != 0) return 124;
+  r = x == 2147483647;
+  if (r != 0) return 125;
+  r = x != 2147483647;
+  if (r != 1) return 126;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 127;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 128;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 129;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 130;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 131;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 132;
+  x = z + 2048;
+  r = x + 2047;
+  if (r != 4095) return 133;
+  r = x - 2047;
+  if (r != 1) return 134;
+  r = x < 2047;
+  if (r != 0) return 135;
+  r = x > 2047;
+  if (r != 1) return 136;
+  r = x <= 2047;
+  if (r != 0) return 137;
+  r = x >= 2047;
+  if (r != 1) return 138;
+  r = x == 2047;
+  if (r != 0) return 139;
+  r = x != 2047;
+  if (r != 1) return 140;
+  r = x + 2048;
+  if (r != 4096) return 141;
+  r = x - 2048;
+  if (r != 0) return 142;
+  r = x < 2048;
+  if (r != 0) return 143;
+  r = x > 2048;
+  if (r != 0) return 144;
+  r = x <= 2048;
+  if (r != 1) return 145;
+  r = x >= 2048;
+  if (r != 1) return 146;
+  r = x == 2048;
+  if (r != 1) return 147;
+  r = x != 2048;
+  if (r != 0) return 148;
+  r = x + (-2048);
+  if (r != 0) return 149;
+  r = x - (-2048);
+  if (r != 4096) return 150;
+  r = x < (-2048);
+  if (r != 0) return 151;
+  r = x > (-2048);
+  if (r != 1) return 152;
+  r = x <= (-2048);
+  if (r != 0) return 153;
+  r = x >= (-2048);
+  if (r != 1) return 154;
+  r = x == (-2048);
+  if (r != 0) return 155;
+  r = x != (-2048);
+  if (r != 1) return 156;
+  r = x + (-2049);
+  if (r != (-1)) return 157;
+  r = x - (-2049);
+  if (r != 4097) return 158;
+  r = x < (-2049);
+  if (r != 0) return 159;
+  r = x > (-2049);
+  if (r != 1) return 160;
+  r = x <= (-2049);
+  if (r != 0) return 161;
+  r = x >= (-2049);
+  if (r != 1) return 162;
+  r = x == (-2049);
+  if (r != 0) return 163;
+  r = x != (-2049);
+  if (r != 1) return 164;
+  r = x < 2147483647;
+  if (r != 1) return 165;
+  r = x > 2147483647;
+  if (r != 0) return 166;
+  r = x <= 2147483647;
+  if (r != 1) return 167;
+  r = x >= 2147483647;
+  if (r != 0) return 168;
+  r = x == 2147483647;
+  if (r != 0) return 169;
+  r = x != 2147483647;
+  if (r != 1) return 170;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 171;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 172;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 173;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 174;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 175;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 176;
+  x = z + (-2048);
+  r = x + 2047;
+  if (r != (-1)) return 177;
+  r = x - 2047;
+  if (r != (-4095)) return 178;
+  r = x < 2047;
+  if (r != 1) return 179;
+  r = x > 2047;
+  if (r != 0) return 180;
+  r = x <= 2047;
+  if (r != 1) return 181;
+  r = x >= 2047;
+  if (r != 0) return 182;
+  r = x == 2047;
+  if (r != 0) return 183;
+  r = x != 2047;
+  if (r != 1) return 184;
+  r = x + 2048;
+  if (r != 0) return 185;
+  r = x - 2048;
+  if (r != (-4096)) return 186;
+  r = x < 2048;
+  if (r != 1) return 187;
+  r = x > 2048;
+  if (r != 0) return 188;
+  r = x <= 2048;
+  if (r != 1) return 189;
+  r = x >= 2048;
+  if (r != 0) return 190;
+  r = x == 2048;
+  if (r != 0) return 191;
+  r = x != 2048;
+  if (r != 1) return 192;
+  r = x + (-2048);
+  if (r != (-4096)) return 193;
+  r = x - (-2048);
+  if (r != 0) return 194;
+  r = x < (-2048);
+  if (r != 0) return 195;
+  r = x > (-2048);
+  if (r != 0) return 196;
+  r = x <= (-2048);
+  if (r != 1) return 197;
+  r = x >= (-2048);
+  if (r != 1) return 198;
+  r = x == (-2048);
+  if (r != 1) return 199;
+  r = x != (-2048);
+  if (r != 0) return 200;
+  r = x + (-2049);
+  if (r != (-4097)) return 201;
+  r = x - (-2049);
+  if (r != 1) return 202;
+  r = x < (-2049);
+  if (r != 0) return 203;
+  r = x > (-2049);
+  if (r != 1) return 204;
+  r = x <= (-2049);
+  if (r != 0) return 205;
+  r = x >= (-2049);
+  if (r != 1) return 206;
+  r = x == (-2049);
+  if (r != 0) return 207;
+  r = x != (-2049);
+  if (r != 1) return 208;
+  r = x < 2147483647;
+  if (r != 1) return 209;
+  r = x > 2147483647;
+  if (r != 0) return 210;
+  r = x <= 2147483647;
+  if (r != 1) return 211;
+  r = x >= 2147483647;
+  if (r != 0) return 212;
+  r = x == 2147483647;
+  if (r != 0) return 213;
+  r = x != 2147483647;
+  if (r != 1) return 214;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 215;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 216;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 217;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 218;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 219;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 220;
+  x = z + (-2049);
+  r = x + 2047;
+  if (r != (-2)) return 221;
+  r = x - 2047;
+  if (r != (-4096)) return 222;
+  r = x < 2047;
+  if (r != 1) return 223;
+  r = x > 2047;
+  if (r != 0) return 224;
+  r = x <= 2047;
+  if (r != 1) return 225;
+  r = x >= 2047;
+  if (r != 0) return 226;
+  r = x == 2047;
+  if (r != 0) return 227;
+  r = x != 2047;
+  if (r != 1) return 228;
+  r = x + 2048;
+  if (r != (-1)) return 229;
+  r = x - 2048;
+  if (r != (-4097)) return 230;
+  r = x < 2048;
+  if (r != 1) return 231;
+  r = x > 2048;
+  if (r != 0) return 232;
+  r = x <= 2048;
+  if (r != 1) return 233;
+  r = x >= 2048;
+  if (r != 0) return 234;
+  r = x == 2048;
+  if (r != 0) return 235;
+  r = x != 2048;
+  if (r != 1) return 236;
+  r = x + (-2048);
+  if (r != (-4097)) return 237;
+  r = x - (-2048);
+  if (r != (-1)) return 238;
+  r = x < (-2048);
+  if (r != 1) return 239;
+  r = x > (-2048);
+  if (r != 0) return 240;
+  r = x <= (-2048);
+  if (r != 1) return 241;
+  r = x >= (-2048);
+  if (r != 0) return 242;
+  r = x == (-2048);
+  if (r != 0) return 243;
+  r = x != (-2048);
+  if (r != 1) return 244;
+  r = x + (-2049);
+  if (r != (-4098)) return 245;
+  r = x - (-2049);
+  if (r != 0) return 246;
+  r = x < (-2049);
+  if (r != 0) return 247;
+  r = x > (-2049);
+  if (r != 0) return 248;
+  r = x <= (-2049);
+  if (r != 1) return 249;
+  r = x >= (-2049);
+  if (r != 1) return 250;
+  r = x == (-2049);
+  if (r != 1) return 251;
+  r = x != (-2049);
+  if (r != 0) return 252;
+  r = x < 2147483647;
+  if (r != 1) return 253;
+  r = x > 2147483647;
+  if (r != 0) return 254;
+  r = x <= 2147483647;
+  if (r != 1) return 255;
+  r = x >= 2147483647;
+  if (r != 0) return 256;
+  r = x == 2147483647;
+  if (r != 0) return 257;
+  r = x != 2147483647;
+  if (r != 1) return 258;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 259;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 260;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 261;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 262;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 263;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 264;
+  x = z + 2147483647;
+  r = x + 2047;
+  if (r != (-2147481602)) return 265;
+  r = x - 2047;
+  if (r != 2147481600) return 266;
+  r = x < 2047;
+  if (r != 0) return 267;
+  r = x > 2047;
+  if (r != 1) return 268;
+  r = x <= 2047;
+  if (r != 0) return 269;
+  r = x >= 2047;
+  if (r != 1) return 270;
+  r = x == 2047;
+  if (r != 0) return 271;
+  r = x != 2047;
+  if (r != 1) return 272;
+  r = x + 2048;
+  if (r != (-2147481601)) return 273;
+  r = x - 2048;
+  if (r != 2147481599) return 274;
+  r = x < 2048;
+  if (r != 0) return 275;
+  r = x > 2048;
+  if (r != 1) return 276;
+  r = x <= 2048;
+  if (r != 0) return 277;
+  r = x >= 2048;
+  if (r != 1) return 278;
+  r = x == 2048;
+  if (r != 0) return 279;
+  r = x != 2048;
+  if (r != 1) return 280;
+  r = x + (-2048);
+  if (r != 2147481599) return 281;
+  r = x - (-2048);
+  if (r != (-2147481601)) return 282;
+  r = x < (-2048);
+  if (r != 0) return 283;
+  r = x > (-2048);
+  if (r != 1) return 284;
+  r = x <= (-2048);
+  if (r != 0) return 285;
+  r = x >= (-2048);
+  if (r != 1) return 286;
+  r = x == (-2048);
+  if (r != 0) return 287;
+  r = x != (-2048);
+  if (r != 1) return 288;
+  r = x + (-2049);
+  if (r != 2147481598) return 289;
+  r = x - (-2049);
+  if (r != (-2147481600)) return 290;
+  r = x < (-2049);
+  if (r != 0) return 291;
+  r = x > (-2049);
+  if (r != 1) return 292;
+  r = x <= (-2049);
+  if (r != 0) return 293;
+  r = x >= (-2049);
+  if (r != 1) return 294;
+  r = x == (-2049);
+  if (r != 0) return 295;
+  r = x != (-2049);
+  if (r != 1) return 296;
+  r = x < 2147483647;
+  if (r != 0) return 297;
+  r = x > 2147483647;
+  if (r != 0) return 298;
+  r = x <= 2147483647;
+  if (r != 1) return 299;
+  r = x >= 2147483647;
+  if (r != 1) return 300;
+  r = x == 2147483647;
+  if (r != 1) return 301;
+  r = x != 2147483647;
+  if (r != 0) return 302;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 303;
+  r = x > (-2147483647 - 1);
+  if (r != 1) return 304;
+  r = x <= (-2147483647 - 1);
+  if (r != 0) return 305;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 306;
+  r = x == (-2147483647 - 1);
+  if (r != 0) return 307;
+  r = x != (-2147483647 - 1);
+  if (r != 1) return 308;
+  x = z + (-2147483647 - 1);
+  r = x + 2047;
+  if (r != (-2147481601)) return 309;
+  r = x - 2047;
+  if (r != 2147481601) return 310;
+  r = x < 2047;
+  if (r != 1) return 311;
+  r = x > 2047;
+  if (r != 0) return 312;
+  r = x <= 2047;
+  if (r != 1) return 313;
+  r = x >= 2047;
+  if (r != 0) return 314;
+  r = x == 2047;
+  if (r != 0) return 315;
+  r = x != 2047;
+  if (r != 1) return 316;
+  r = x + 2048;
+  if (r != (-2147481600)) return 317;
+  r = x - 2048;
+  if (r != 2147481600) return 318;
+  r = x < 2048;
+  if (r != 1) return 319;
+  r = x > 2048;
+  if (r != 0) return 320;
+  r = x <= 2048;
+  if (r != 1) return 321;
+  r = x >= 2048;
+  if (r != 0) return 322;
+  r = x == 2048;
+  if (r != 0) return 323;
+  r = x != 2048;
+  if (r != 1) return 324;
+  r = x + (-2048);
+  if (r != 2147481600) return 325;
+  r = x - (-2048);
+  if (r != (-2147481600)) return 326;
+  r = x < (-2048);
+  if (r != 1) return 327;
+  r = x > (-2048);
+  if (r != 0) return 328;
+  r = x <= (-2048);
+  if (r != 1) return 329;
+  r = x >= (-2048);
+  if (r != 0) return 330;
+  r = x == (-2048);
+  if (r != 0) return 331;
+  r = x != (-2048);
+  if (r != 1) return 332;
+  r = x + (-2049);
+  if (r != 2147481599) return 333;
+  r = x - (-2049);
+  if (r != (-2147481599)) return 334;
+  r = x < (-2049);
+  if (r != 1) return 335;
+  r = x > (-2049);
+  if (r != 0) return 336;
+  r = x <= (-2049);
+  if (r != 1) return 337;
+  r = x >= (-2049);
+  if (r != 0) return 338;
+  r = x == (-2049);
+  if (r != 0) return 339;
+  r = x != (-2049);
+  if (r != 1) return 340;
+  r = x < 2147483647;
+  if (r != 1) return 341;
+  r = x > 2147483647;
+  if (r != 0) return 342;
+  r = x <= 2147483647;
+  if (r != 1) return 343;
+  r = x >= 2147483647;
+  if (r != 0) return 344;
+  r = x == 2147483647;
+  if (r != 0) return 345;
+  r = x != 2147483647;
+  if (r != 1) return 346;
+  r = x < (-2147483647 - 1);
+  if (r != 0) return 347;
+  r = x > (-2147483647 - 1);
+  if (r != 0) return 348;
+  r = x <= (-2147483647 - 1);
+  if (r != 1) return 349;
+  r = x >= (-2147483647 - 1);
+  if (r != 1) return 350;
+  r = x == (-2147483647 - 1);
+  if (r != 1) return 351;
+  r = x != (-2147483647 - 1);
+  if (r != 0) return 352;
+  return 96;
+}
@@ -0,0 +1,203 @@
+// return: 207
+// 700 locals: the frame and its offsets need more than 12 bits; the swap
+// loop makes a block argument cycle in such a frame
+int main() {
+  int n = 0;
+  while (n < 3) n = n + 1;
+  int v0 = n, v1 = v0 + n + 1, v2 = v1 + n + 2, v3 = v2 + n + 3, v4 = v3 + n + 4, v5 = v4 + n + 5;
+  int v6 = v5 + n + 6, v7 = v6 + n + 0, v8 = v7 + n + 1, v9 = v8 + n + 2, v10 = v9 + n + 3, v11 = v10 + n + 4;
+  int v12 = v11 + n + 5, v13 = v12 + n + 6, v14 = v13 + n + 0, v15 = v14 + n + 1, v16 = v15 + n + 2, v17 = v16 + n + 3;
+  int v18 = v17 + n + 4, v19 = v18 + n + 5, v20 = v19 + n + 6, v21 = v20 + n + 0, v22 = v21 + n + 1, v23 = v22 + n + 2;
+  int v24 = v23 + n + 3, v25 = v24 + n + 4, v26 = v25 + n + 5, v27 = v26 + n + 6, v28 = v27 + n + 0, v29 = v28 + n + 1;
+  int v30 = v29 + n + 2, v31 = v30 + n + 3, v32 = v31 + n + 4, v33 = v32 + n + 5, v34 = v33 + n + 6, v35 = v34 + n + 0;
+  int v36 = v35 + n + 1, v37 = v36 + n + 2, v38 = v37 + n + 3, v39 = v38 + n + 4, v40 = v39 + n + 5, v41 = v40 + n + 6;
+  int v42 = v41 + n + 0, v43 = v42 + n + 1, v44 = v43 + n + 2, v45 = v44 + n + 3, v46 = v45 + n + 4, v47 = v46 + n + 5;
+  int v48 = v47 + n + 6, v49 = v48 + n + 0, v50 = v49 + n + 1, v51 = v50 + n + 2, v52 = v51 + n + 3, v53 = v52 + n + 4;
+  int v54 = v53 + n + 5, v55 = v54 + n + 6, v56 = v55 + n + 0, v57 = v56 + n + 1, v58 = v57 + n + 2, v59 = v58 + n + 3;
+  int v60 = v59 + n + 4, v61 = v60 + n + 5, v62 = v61 + n + 6, v63 = v62 + n + 0, v64 = v63 + n + 1, v65 = v64 + n + 2;
+  int v66 = v65 + n + 3, v67 = v66 + n + 4, v68 = v67 + n + 5, v69 = v68 + n + 6, v70 = v69 + n + 0, v71 = v70 + n + 1;
+  int v72 = v71 + n + 2, v73 = v72 + n + 3, v74 = v73 + n + 4, v75 = v74 + n + 5, v76 = v75 + n + 6, v77 = v76 + n + 0;
+  int v78 = v77 + n + 1, v79 = v78 + n + 2, v80 = v79 + n + 3, v81 = v80 + n + 4, v82 = v81 + n + 5, v83 = v82 + n + 6;
+  int v84 = v83 + n + 0, v85 = v84 + n + 1, v86 = v85 + n + 2, v87 = v86 + n + 3, v88 = v87 + n + 4, v89 = v88 + n + 5;
+  int v90 = v89 + n + 6, v91 = v90 + n + 0, v92 = v91 + n + 1, v93 = v92 + n + 2, v94 = v93 + n + 3, v95 = v94 + n + 4;
+  int v96 = v95 + n + 5, v97 = v96 + n + 6, v98 = v97 + n + 0, v99 = v98 + n + 1, v100 = v99 + n + 2, v101 = v100 + n + 3;
+  int v102 = v101 + n + 4, v103 = v102 + n + 5, v104 = v103 + n + 6, v105 = v104 + n + 0, v106 = v105 + n + 1, v107 = v106 + n + 2;
+  int v108 = v107 + n + 3, v109 = v108 + n + 4, v110 = v109 + n + 5, v111 = v110 + n + 6, v112 = v111 + n + 0, v113 = v112 + n + 1;
+  int v114 = v113 + n + 2, v115 = v114 + n + 3, v116 = v115 + n + 4, v117 = v116 + n + 5, v118 = v117 + n + 6, v119 = v118 + n + 0;
+  int v120 = v119 + n + 1, v121 = v120 + n + 2, v122 = v121 + n + 3, v123 = v122 + n + 4, v124 = v123 + n + 5, v125 = v124 + n + 6;
+  int v126 = v125 + n + 0, v127 = v126 + n + 1, v128 = v127 + n + 2, v129 = v128 + n + 3, v130 = v129 + n + 4, v131 = v130 + n + 5;
+  int v132 = v131 + n + 6, v133 = v132 + n + 0, v134 = v133 + n + 1, v135 = v134 + n + 2, v136 = v135 + n + 3, v137 = v136 + n + 4;
+  int v138 = v137 + n + 5, v139 = v138 + n + 6, v140 = v139 + n + 0, v141 = v140 + n + 1, v142 = v141 + n + 2, v143 = v142 + n + 3;
+  int v144 = v143 + n + 4, v145 = v144 + n + 5, v146 = v145 + n + 6, v147 = v146 + n + 0, v148 = v147 + n + 1, v149 = v148 + n + 2;
+  int v150 = v149 + n + 3, v151 = v150 + n + 4, v152 = v151 + n + 5, v153 = v152 + n + 6, v154 = v153 + n + 0, v155 = v154 + n + 1;
+  int v156 = v155 + n + 2, v157 = v156 + n + 3, v158 = v157 + n + 4, v159 = v158 + n + 5, v160 = v159 + n + 6, v161 = v160 + n + 0;
+  int v162 = v161 + n + 1, v163 = v162 + n + 2, v164 = v163 + n + 3, v165 = v164 + n + 4, v166 = v165 + n + 5, v167 = v166 + n + 6;
+  int v168 = v167 + n + 0, v169 = v168 + n + 1, v170 = v169 + n + 2, v171 = v170 + n + 3, v172 = v171 + n + 4, v173 = v172 + n + 5;
+  int v174 = v173 + n + 6, v175 = v174 + n + 0, v176 = v175 + n + 1, v177 = v176 + n + 2, v178 = v177 + n + 3, v179 = v178 + n + 4;
+  int v180 = v179 + n + 5, v181 = v180 + n + 6, v182 = v181 + n + 0, v183 = v182 + n + 1, v184 = v183 + n + 2, v185 = v184 + n + 3;
+  int v186 = v185 + n + 4, v187 = v186 + n + 5, v188 = v187 + n + 6, v189 = v188 + n + 0, v190 = v189 + n + 1, v191 = v190 + n + 2;
+  int v192 = v191 + n + 3, v193 = v192 + n + 4, v194 = v193 + n + 5, v195 = v194 + n + 6, v196 = v195 + n + 0, v197 = v196 + n + 1;
+  int v198 = v197 + n + 2, v199 = v198 + n + 3, v200 = v199 + n + 4, v201 = v200 + n + 5, v202 = v201 + n + 6, v203 = v202 + n + 0;
+  int v204 = v203 + n + 1, v205 = v204 + n + 2, v206 = v205 + n + 3, v207 = v206 + n + 4, v208 = v207 + n + 5, v209 = v208 + n + 6;
+  int v210 = v209 + n + 0, v211 = v210 + n + 1, v212 = v211 + n + 2, v213 = v212 + n + 3, v214 = v213 + n + 4, v215 = v214 + n + 5;
+  int v216 = v215 + n + 6, v217 = v216 + n + 0, v218 = v217 + n + 1, v219 = v218 + n + 2, v220 = v219 + n + 3, v221 = v220 + n + 4;
+  int v222 = v221 + n + 5, v223 = v222 + n + 6, v224 = v223 + n + 0, v225 = v224 + n + 1, v226 = v225 + n + 2, v227 = v226 + n + 3;
+  int v228 = v227 + n + 4, v229 = v228 + n + 5, v230 = v229 + n + 6, v231 = v230 + n + 0, v232 = v231 + n + 1, v233 = v232 + n + 2;
+  int v234 = v233 + n + 3, v235 = v234 + n + 4, v236 = v235 + n + 5, v237 = v236 + n + 6, v238 = v237 + n + 0, v239 = v238 + n + 1;
+  int v240 = v239 + n + 2, v241 = v240 + n + 3, v242 = v241 + n + 4, v243 = v242 + n + 5, v244 = v243 + n + 6, v245 = v244 + n + 0;
+  int v246 = v245 + n + 1, v247 = v246 + n + 2, v248 = v247 + n + 3, v249 = v248 + n + 4, v250 = v249 + n + 5, v251 = v250 + n + 6;
+  int v252 = v251 + n + 0, v253 = v252 + n + 1, v254 = v253 + n + 2, v255 = v254 + n + 3, v256 = v255 + n + 4, v257 = v256 + n + 5;
+  int v258 = v257 + n + 6, v259 = v258 + n + 0, v260 = v259 + n + 1, v261 = v260 + n + 2, v262 = v261 + n + 3, v263 = v262 + n + 4;
+  int v264 = v263 + n + 5, v265 = v264 + n + 6, v266 = v265 + n + 0, v267 = v266 + n + 1, v268 = v267 + n + 2, v269 = v268 + n + 3;
+  int v270 = v269 + n + 4, v271 = v270 + n + 5, v272 = v271 + n + 6, v273 = v272 + n + 0, v274 = v273 + n + 1, v275 = v274 + n + 2;
+  int v276 = v275 + n + 3, v277 = v276 + n + 4, v278 = v277 + n + 5, v279 = v278 + n + 6, v280 = v279 + n + 0, v281 = v280 + n + 1;
+  int v282 = v281 + n + 2, v283 = v282 + n + 3, v284 = v283 + n + 4, v285 = v284 + n + 5, v286 = v285 + n + 6, v287 = v286 + n + 0;
+  int v288 = v287 + n + 1, v289 = v288 + n + 2, v290 = v289 + n + 3, v291 = v290 + n + 4, v292 = v291 + n + 5, v293 = v292 + n + 6;
+  int v294 = v293 + n + 0, v295 = v294 + n + 1, v296 = v295 + n + 2, v297 = v296 + n + 3, v298 = v297 + n + 4, v299 = v298 + n + 5;
+  int v300 = v299 + n + 6, v301 = v300 + n + 0, v302 = v301 + n + 1, v303 = v302 + n + 2, v304 = v303 + n + 3, v305 = v304 + n + 4;
+  int v306 = v305 + n + 5, v307 = v306 + n + 6, v308 = v307 + n + 0, v309 = v308 + n + 1, v310 = v309 + n + 2, v311 = v310 + n + 3;
+  int v312 = v311 + n + 4, v313 = v312 + n + 5, v314 = v313 + n + 6, v315 = v314 + n + 0, v316 = v315 + n + 1, v317 = v316 + n + 2;
+  int v318 = v317 + n + 3, v319 = v318 + n + 4, v320 = v319 + n + 5, v321 = v320 + n + 6, v322 = v321 + n + 0, v323 = v322 + n + 1;
+  int v324 = v323 + n + 2, v325 = v324 + n + 3, v326 = v325 + n + 4, v327 = v326 + n + 5, v328 = v327 + n + 6, v329 = v328 + n + 0;
+  int v330 = v329 + n + 1, v331 = v330 + n + 2, v332 = v331 + n + 3, v333 = v332 + n + 4, v334 = v333 + n + 5, v335 = v334 + n + 6;
+  int v336 = v335 + n + 0, v337 = v336 + n + 1, v338 = v337 + n + 2, v339 = v338 + n + 3, v340 = v339 + n + 4, v341 = v340 + n + 5;
+  int v342 = v341 + n + 6, v343 = v342 + n + 0, v344 = v343 + n + 1, v345 = v344 + n + 2, v346 = v345 + n + 3, v347 = v346 + n + 4;
+  int v348 = v347 + n + 5, v349 = v348 + n + 6, v350 = v349 + n + 0, v351 = v350 + n + 1, v352 = v351 + n + 2, v353 = v352 + n + 3;
+  int v354 = v353 + n + 4, v355 = v354 + n + 5, v356 = v355 + n + 6, v357 = v356 + n + 0, v358 = v357 + n + 1, v359 = v358 + n + 2;
+  int v360 = v359 + n + 3, v361 = v360 + n + 4, v362 = v361 + n + 5, v363 = v362 + n + 6, v364 = v363 + n + 0, v365 = v364 + n + 1;
+  int v366 = v365 + n + 2, v367 = v366 + n + 3, v368 = v367 + n + 4, v369 = v368 + n + 5, v370 = v369 + n + 6, v371 = v370 + n + 0;
+  int v372 = v371 + n + 1, v373 = v372 + n + 2, v374 = v373 + n + 3, v375 = v374 + n + 4, v376 = v375 + n + 5, v377 = v376 + n + 6;
+  int v378 = v377 + n + 0, v379 = v378 + n + 1, v380 = v379 + n + 2, v381 = v380 + n + 3, v382 = v381 + n + 4, v383 = v382 + n + 5;
+  int v384 = v383 + n + 6, v385 = v384 + n + 0, v386 = v385 + n + 1, v387 = v386 + n + 2, v388 = v387 + n + 3, v389 = v388 + n + 4;
+  int v390 = v389 + n + 5, v391 = v390 + n + 6, v392 = v391 + n + 0, v393 = v392 + n + 1, v394 = v393 + n + 2, v395 = v394 + n + 3;
+  int v396 = v395 + n + 4, v397 = v396 + n + 5, v398 = v397 + n + 6, v399 = v398 + n + 0, v400 = v399 + n + 1, v401 = v400 + n + 2;
+  int v402 = v401 + n + 3, v403 = v402 + n + 4, v404 = v403 + n + 5, v405 = v404 + n + 6, v406 = v405 + n + 0, v407 = v406 + n + 1;
+  int v408 = v407 + n + 2, v409 = v408 + n + 3, v410 = v409 + n + 4, v411 = v410 + n + 5, v412 = v411 + n + 6, v413 = v412 + n + 0;
+  int v414 = v413 + n + 1, v415 = v414 + n + 2, v416 = v415 + n + 3, v417 = v416 + n + 4, v418 = v417 + n + 5, v419 = v418 + n + 6;
+  int v420 = v419 + n + 0, v421 = v420 + n + 1, v422 = v421 + n + 2, v423 = v422 + n + 3, v424 = v423 + n + 4, v425 = v424 + n + 5;
+  int v426 = v425 + n + 6, v427 = v426 + n + 0, v428 = v427 + n + 1, v429 = v428 + n + 2, v430 = v429 + n + 3, v431 = v430 + n + 4;
+  int v432 = v431 + n + 5, v433 = v432 + n + 6, v434 = v433 + n + 0, v435 = v434 + n + 1, v436 = v435 + n + 2, v437 = v436 + n + 3;
+  int v438 = v437 + n + 4, v439 = v438 + n + 5, v440 = v439 + n + 6, v441 = v440 + n + 0, v442 = v441 + n + 1, v443 = v442 + n + 2;
+  int v444 = v443 + n + 3, v445 = v444 + n + 4, v446 = v445 + n + 5, v447 = v446 + n + 6, v448 = v447 + n + 0, v449 = v448 + n + 1;
+  int v450 = v449 + n + 2, v451 = v450 + n + 3, v452 = v451 + n + 4, v453 = v452 + n + 5, v454 = v453 + n + 6, v455 = v454 + n + 0;
+  int v456 = v455 + n + 1, v457 = v456 + n + 2, v458 = v457 + n + 3, v459 = v458 + n + 4, v460 = v459 + n + 5, v461 = v460 + n + 6;
+  int v462 = v461 + n + 0, v463 = v462 + n + 1, v464 = v463 + n + 2, v465 = v464 + n + 3, v466 = v465 + n + 4, v467 = v466 + n + 5;
+  int v468 = v467 + n + 6, v469 = v468 + n + 0, v470 = v469 + n + 1, v471 = v470 + n + 2, v472 = v471 + n + 3, v473 = v472 + n + 4;
+  int v474 = v473 + n + 5, v475 = v474 + n + 6, v476 = v475 + n + 0, v477 = v476 + n + 1, v478 = v477 + n + 2, v479 = v478 + n + 3;
+  int v480 = v479 + n + 4, v481 = v480 + n + 5, v482 = v481 + n + 6, v483 = v482 + n + 0, v484 = v483 + n + 1, v485 = v484 + n + 2;
+  int v486 = v485 + n + 3, v487 = v486 + n + 4, v488 = v487 + n + 5, v489 = v488 + n + 6, v490 = v489 + n + 0, v491 = v490 + n + 1;
+  int v492 = v491 + n + 2, v493 = v492 + n + 3, v494 = v493 + n + 4, v495 = v494 + n + 5, v496 = v495 + n + 6, v497 = v496 + n + 0;
+  int v498 = v497 + n + 1, v499 = v498 + n + 2, v500 = v499 + n + 3, v501 = v500 + n + 4, v502 = v501 + n + 5, v503 = v502 + n + 6;
+  int v504 = v503 + n + 0, v505 = v504 + n + 1, v506 = v505 + n + 2, v507 = v506 + n + 3, v508 = v507 + n + 4, v509 = v508 + n + 5;
+  int v510 = v509 + n + 6, v511 = v510 + n + 0, v512 = v511 + n + 1, v513 = v512 + n + 2, v514 = v513 + n + 3, v515 = v514 + n + 4;
+  int v516 = v515 + n + 5, v517 = v516 + n + 6, v518 = v517 + n + 0, v519 = v518 + n + 1, v520 = v519 + n + 2, v521 = v520 + n + 3;
+  int v522 = v521 + n + 4, v523 = v522 + n + 5, v524 = v523 + n + 6, v525 = v524 + n + 0, v526 = v525 + n + 1, v527 = v526 + n + 2;
+  int v528 = v527 + n + 3, v529 = v528 + n + 4, v530 = v529 + n + 5, v531 = v530 + n + 6, v532 = v531 + n + 0, v533 = v532 + n + 1;
+  int v534 = v533 + n + 2, v535 = v534 + n + 3, v536 = v535 + n + 4, v537 = v536 + n + 5, v538 = v537 + n + 6, v539 = v538 + n + 0;
+  int v540 = v539 + n + 1, v541 = v540 + n + 2, v542 = v541 + n + 3, v543 = v542 + n + 4, v544 = v543 + n + 5, v545 = v544 + n + 6;
+  int v546 = v545 + n + 0, v547 = v546 + n + 1, v548 = v547 + n + 2, v549 = v548 + n + 3, v550 = v549 + n + 4, v551 = v550 + n + 5;
+  int v552 = v551 + n + 6, v553 = v552 + n + 0, v554 = v553 + n + 1, v555 = v554 + n + 2, v556 = v555 + n + 3, v557 = v556 + n + 4;
+  int v558 = v557 + n + 5, v559 = v558 + n + 6, v560 = v559 + n + 0, v561 = v560 + n + 1, v562 = v561 + n + 2, v563 = v562 + n + 3;
+  int v564 = v563 + n + 4, v565 = v564 + n + 5, v566 = v565 + n + 6, v567 = v566 + n + 0, v568 = v567 + n + 1, v569 = v568 + n + 2;
+  int v570 = v569 + n + 3, v571 = v570 + n + 4, v572 = v571 + n + 5, v573 = v572 + n + 6, v574 = v573 + n + 0, v575 = v574 + n + 1;
+  int v576 = v575 + n + 2, v577 = v576 + n + 3, v578 = v577 + n + 4, v579 = v578 + n + 5, v580 = v579 + n + 6, v581 = v580 + n + 0;
+  int v582 = v581 + n + 1, v583 = v582 + n + 2, v584 = v583 + n + 3, v585 = v584 + n + 4, v586 = v585 + n + 5, v587 = v586 + n + 6;
+  int v588 = v587 + n + 0, v589 = v588 + n + 1, v590 = v589 + n + 2, v591 = v590 + n + 3, v592 = v591 + n + 4, v593 = v592 + n + 5;
+  int v594 = v593 + n + 6, v595 = v594 + n + 0, v596 = v595 + n + 1, v597 = v596 + n + 2, v598 = v597 + n + 3, v599 = v598 + n + 4;
+  int v600 = v599 + n + 5, v601 = v600 + n + 6, v602 = v601 + n + 0, v603 = v602 + n + 1, v604 = v603 + n + 2, v605 = v604 + n + 3;
+  int v606 = v605 + n + 4, v607 = v606 + n + 5, v608 = v607 + n + 6, v609 = v608 + n + 0, v610 = v609 + n + 1, v611 = v610 + n + 2;
+  int v612 = v611 + n + 3, v613 = v612 + n + 4, v614 = v613 + n + 5, v615 = v614 + n + 6, v616 = v615 + n + 0, v617 = v616 + n + 1;
+  int v618 = v617 + n + 2, v619 = v618 + n + 3, v620 = v619 + n + 4, v621 = v620 + n + 5, v622 = v621 + n + 6, v623 = v622 + n + 0;
+  int v624 = v623 + n + 1, v625 = v624 + n + 2, v626 = v625 + n + 3, v627 = v626 + n + 4, v628 = v627 + n + 5, v629 = v628 + n + 6;
+  int v630 = v629 + n + 0, v631 = v630 + n + 1, v632 = v631 + n + 2, v633 = v632 + n + 3, v634 = v633 + n + 4, v635 = v634 + n + 5;
+  int v636 = v635 + n + 6, v637 = v636 + n + 0, v638 = v637 + n + 1, v639 = v638 + n + 2, v640 = v639 + n + 3, v641 = v640 + n + 4;
+  int v642 = v641 + n + 5, v643 = v642 + n + 6, v644 = v643 + n + 0, v645 = v644 + n + 1, v646 = v645 + n + 2, v647 = v646 + n + 3;
+  int v648 = v647 + n + 4, v649 = v648 + n + 5, v650 = v649 + n + 6, v651 = v650 + n + 0, v652 = v651 + n + 1, v653 = v652 + n + 2;
+  int v654 = v653 + n + 3, v655 = v654 + n + 4, v656 = v655 + n + 5, v657 = v656 + n + 6, v658 = v657 + n + 0, v659 = v658 + n + 1;
+  int v660 = v659 + n + 2, v661 = v660 + n + 3, v662 = v661 + n + 4, v663 = v662 + n + 5, v664 = v663 + n + 6, v665 = v664 + n + 0;
+  int v666 = v665 + n + 1, v667 = v666 + n + 2, v668 = v667 + n + 3, v669 = v668 + n + 4, v670 = v669 + n + 5, v671 = v670 + n + 6;
+  int v672 = v671 + n + 0, v673 = v672 + n + 1, v674 = v673 + n + 2, v675 = v674 + n + 3, v676 = v675 + n + 4, v677 = v676 + n + 5;
+  int v678 = v677 + n + 6, v679 = v678 + n + 0, v680 = v679 + n + 1, v681 = v680 + n + 2, v682 = v681 + n + 3, v683 = v682 + n + 4;
+  int v684 = v683 + n + 5, v685 = v684 + n + 6, v686 = v685 + n + 0, v687 = v686 + n + 1, v688 = v687 + n + 2, v689 = v688 + n + 3;
+  int v690 = v689 + n + 4, v691 = v690 + n + 5, v692 = v691 + n + 6, v693 = v692 + n + 0, v694 = v693 + n + 1, v695 = v694 + n + 2;
+  int v696 = v695 + n + 3, v697 = v696 + n + 4, v698 = v697 + n + 5, v699 = v698 + n + 6;
+  int x = v1, y = v2, k = 0;
+  while (k < 5) {
+    int t = x;
+    x = y;
+    y = t;
+    k = k + 1;
+  }
+  int s = x * 7 + y;
+  s = s + v699 + v698 + v697 + v696 + v695 + v694 + v693 + v692 + v691 + v690;
+  s = s + v689 + v688 + v687 + v686 + v685 + v684 + v683 + v682 + v681 + v680;
+  s = s + v679 + v678 + v677 + v676 + v675 + v674 + v673 + v672 + v671 + v670;
+  s = s + v669 + v668 + v667 + v666 + v665 + v664 + v663 + v662 + v661 + v660;
+  s = s + v659 + v658 + v657 + v656 + v655 + v654 + v653 + v652 + v651 + v650;
+  s = s + v649 + v648 + v647 + v646 + v645 + v644 + v643 + v642 + v641 + v640;
+  s = s + v639 + v638 + v637 + v636 + v635 + v634 + v633 + v632 + v631 + v630;
+  s = s + v629 + v628 + v627 + v626 + v625 + v624 + v623 + v622 + v621 + v620;
+  s = s + v619 + v618 + v617 + v616 + v615 + v614 + v613 + v612 + v611 + v610;
+  s = s + v609 + v608 + v607 + v606 + v605 + v604 + v603 + v602 + v601 + v600;
+  s = s + v599 + v598 + v597 + v596 + v595 + v594 + v593 + v592 + v591 + v590;
+  s = s + v589 + v588 + v587 + v586 + v585 + v584 + v583 + v582 + v581 + v580;
+  s = s + v579 + v578 + v577 + v576 + v575 + v574 + v573 + v572 + v571 + v570;
+  s = s + v569 + v568 + v567 + v566 + v565 + v564 + v563 + v562 + v561 + v560;
+  s = s + v559 + v558 + v557 + v556 + v555 + v554 + v553 + v552 + v551 + v550;
+  s = s + v549 + v548 + v547 + v546 + v545 + v544 + v543 + v542 + v541 + v540;
+  s = s + v539 + v538 + v537 + v536 + v535 + v534 + v533 + v532 + v531 + v530;
+  s = s + v529 + v528 + v527 + v526 + v525 + v524 + v523 + v522 + v521 + v520;
+  s = s + v519 + v518 + v517 + v516 + v515 + v514 + v513 + v512 + v511 + v510;
+  s = s + v509 + v508 + v507 + v506 + v505 + v504 + v503 + v502 + v501 + v500;
+  s = s + v499 + v498 + v497 + v496 + v495 + v494 + v493 + v492 + v491 + v490;
+  s = s + v489 + v488 + v487 + v486 + v485 + v484 + v483 + v482 + v481 + v480;
+  s = s + v479 + v478 + v477 + v476 + v475 + v474 + v473 + v472 + v471 + v470;
+  s = s + v469 + v468 + v467 + v466 + v465 + v464 + v463 + v462 + v461 + v460;
+  s = s + v459 + v458 + v457 + v456 + v455 + v454 + v453 + v452 + v451 + v450;
+  s = s + v449 + v448 + v447 + v446 + v445 + v444 + v443 + v442 + v441 + v440;
+  s = s + v439 + v438 + v437 + v436 + v435 + v434 + v433 + v432 + v431 + v430;
+  s = s + v429 + v428 + v427 + v426 + v425 + v424 + v423 + v422 + v421 + v420;
+  s = s + v419 + v418 + v417 + v416 + v415 + v414 + v413 + v412 + v411 + v410;
+  s = s + v409 + v408 + v407 + v406 + v405 + v404 + v403 + v402 + v401 + v400;
+  s = s + v399 + v398 + v397 + v396 + v395 + v394 + v393 + v392 + v391 + v390;
+  s = s + v389 + v388 + v387 + v386 + v385 + v384 + v383 + v382 + v381 + v380;
+  s = s + v379 + v378 + v377 + v376 + v375 + v374 + v373 + v372 + v371 + v370;
+  s = s + v369 + v368 + v367 + v366 + v365 + v364 + v363 + v362 + v361 + v360;
+  s = s + v359 + v358 + v357 + v356 + v355 + v354 + v353 + v352 + v351 + v350;
+  s = s + v349 + v348 + v347 + v346 + v345 + v344 + v343 + v342 + v341 + v340;
+  s = s + v339 + v338 + v337 + v336 + v335 + v334 + v333 + v332 + v331 + v330;
+  s = s + v329 + v328 + v327 + v326 + v325 + v324 + v323 + v322 + v321 + v320;
+  s = s + v319 + v318 + v317 + v316 + v315 + v314 + v313 + v312 + v311 + v310;
+  s = s + v309 + v308 + v307 + v306 + v305 + v304 + v303 + v302 + v301 + v300;
+  s = s + v299 + v298 + v297 + v296 + v295 + v294 + v293 + v292 + v291 + v290;
+  s = s + v289 + v288 + v287 + v286 + v285 + v284 + v283 + v282 + v281 + v280;
+  s = s + v279 + v278 + v277 + v276 + v275 + v274 + v273 + v272 + v271 + v270;
+  s = s + v269 + v268 + v267 + v266 + v265 + v264 + v263 + v262 + v261 + v260;
+  s = s + v259 + v258 + v257 + v256 + v255 + v254 + v253 + v252 + v251 + v250;
+  s = s + v249 + v248 + v247 + v246 + v245 + v244 + v243 + v242 + v241 + v240;
+  s = s + v239 + v238 + v237 + v236 + v235 + v234 + v233 + v232 + v231 + v230;
+  s = s + v229 + v228 + v227 + v226 + v225 + v224 + v223 + v222 + v221 + v220;
+  s = s + v219 + v218 + v217 + v216 + v215 + v214 + v213 + v212 + v211 + v210;
+  s = s + v209 + v208 + v207 + v206 + v205 + v204 + v203 + v202 + v201 + v200;
+  s = s + v199 + v198 + v197 + v196 + v195 + v194 + v193 + v192 + v191 + v190;
+  s = s + v189 + v188 + v187 + v186 + v185 + v184 + v183 + v182 + v181 + v180;
+  s = s + v179 + v178 + v177 + v176 + v175 + v174 + v173 + v172 + v171 + v170;
+  s = s + v169 + v168 + v167 + v166 + v165 + v164 + v163 + v162 + v161 + v160;
+  s = s + v159 + v158 + v157 + v156 + v155 + v154 + v153 + v152 + v151 + v150;
+  s = s + v149 + v148 + v147 + v146 + v145 + v144 + v143 + v142 + v141 + v140;
+  s = s + v139 + v138 + v137 + v136 + v135 + v134 + v133 + v132 + v131 + v130;
+  s = s + v129 + v128 + v127 + v126 + v125 + v124 + v123 + v122 + v121 + v120;
+  s = s + v119 + v118 + v117 + v116 + v115 + v114 + v113 + v112 + v111 + v110;
+  s = s + v109 + v108 + v107 + v106 + v105 + v104 + v103 + v102 + v101 + v100;
+  s = s + v99 + v98 + v97 + v96 + v95 + v94 + v93 + v92 + v91 + v90;
+  s = s + v89 + v88 + v87 + v86 + v85 + v84 + v83 + v82 + v81 + v80;
+  s = s + v79 + v78 + v77 + v76 + v75 + v74 + v73 + v72 + v71 + v70;
+  s = s + v69 + v68 + v67 + v66 + v65 + v64 + v63 + v62 + v61 + v60;
+  s = s + v59 + v58 + v57 + v56 + v55 + v54 + v53 + v52 + v51 + v50;
+  s = s + v49 + v48 + v47 + v46 + v45 + v44 + v43 + v42 + v41 + v40;
+  s = s + v39 + v38 + v37 + v36 + v35 + v34 + v33 + v32 + v31 + v30;
+  s = s + v29 + v28 + v27 + v26 + v25 + v24 + v23 + v22 + v21 + v20;
+  s = s + v19 + v18 + v17 + v16 + v15 + v14 + v13 + v12 + v11 + v10;
+  s = s + v9 + v8 + v7 + v6 + v5 + v4 + v3 + v2 + v1 + v0;
+  return s % 256;
+}
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Regression tests for the SysY compiler.
+
+Every tests/*.c starts with a `// return: N` line. The program is compiled
+to RISC-V at every optimization level, run on the built-in simulator
+(`compiler -sim`) and its return value compared against N. Any mismatch or
+failing compile makes the script exit with status 1.
+
+usage: run_tests.py --compiler PATH
+"""
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+LEVELS = ["-O0", "-O1"]
+
+
+def expected_return(src):
+    with open(src) as f:
+        m = re.match(r"// return: (-?\d+)", f.readline())
+    return int(m.group(1)) if m else None
+
+
+def run_test(compiler, src, level, work_dir):
+    asm = os.path.join(work_dir, os.path.basename(src) + level + ".s")
+    proc = subprocess.run([compiler, level, "-riscv", src, "-o", asm], capture_output=True, text=True)
+    if proc.returncode != 0:
+        return "compile failed: " + proc.stderr.strip()
+    proc = subprocess.run([compiler, "-sim", asm], capture_output=True, text=True)
+    m = re.search(r"^return: (-?\d+)", proc.stdout + proc.stderr, re.M)
+    if proc.returncode != 0 and not m:
+        return "simulation failed: " + (proc.stdout + proc.stderr).strip()
+    return int(m.group(1)) if m else "no return value"
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--compiler", required=True)
+    args = parser.parse_args()
+
+    tests = sorted(glob.glob(os.path.join(os.path.dirname(os.path.abspath(__file__)), "*.c")))
+    failed = 0
+    with tempfile.TemporaryDirectory() as work_dir:
+        for src in tests:
+            expected = expected_return(src)
+            for level in LEVELS:
+                got = run_test(args.compiler, src, level, work_dir)
+                ok = got == expected
+                failed += not ok
+                status = "ok" if ok else "FAIL (expected %s, got %s)" % (expected, got)
+                print("%-32s %s %s" % (os.path.basename(src), level, status))
+    print("%d failed" % failed)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())